@@ -0,0 +1,52 @@
+// Two-entry skid buffer for a valid/ready stream
+// Passes one beat per cycle with no bubbles. s_ready is a register (no
+// combinational path from m_ready): a beat that arrives while the output is
+// stalled parks in the skid register and moves to the output on the next
+// accepted transfer.
+module axis_skid #(
+    parameter integer WIDTH = 32
+) (
+    input                    clk,
+    input                    rst,
+    input                    s_valid,
+    output                   s_ready,
+    input      [WIDTH-1:0]   s_data,
+    output                   m_valid,
+    input                    m_ready,
+    output     [WIDTH-1:0]   m_data
+);
+
+    reg             main_valid;
+    reg [WIDTH-1:0] main_data;
+    reg             skid_valid;
+    reg [WIDTH-1:0] skid_data;
+
+    assign s_ready = !skid_valid;
+    assign m_valid = main_valid;
+    assign m_data  = main_data;
+
+    always @(posedge clk) begin
+        if (rst) begin
+            main_valid <= 1'b0;
+            main_data  <= {WIDTH{1'b0}};
+            skid_valid <= 1'b0;
+            skid_data  <= {WIDTH{1'b0}};
+        end else if (!main_valid || m_ready) begin
+            // Output register is free this cycle: refill from the skid first
+            if (skid_valid) begin
+                main_valid <= 1'b1;
+                main_data  <= skid_data;
+                skid_valid <= 1'b0;
+            end else begin
+                main_valid <= s_valid;
+                if (s_valid) begin
+                    main_data <= s_data;
+                end
+            end
+        end else if (s_valid && s_ready) begin
+            skid_valid <= 1'b1;
+            skid_data  <= s_data;
+        end
+    end
+
+endmodule
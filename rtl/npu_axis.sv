@@ -0,0 +1,191 @@
+// AXI4-Stream wrapper around npu_core
+// Slave side: one operand beat per transfer, TDATA = {b_stream, a_stream},
+// TLAST on the final k beat of a tile. Master side: the activated tile in
+// row-major order, ELEMS_PER_BEAT results per transfer, each sign-extended to
+// a whole number of bytes. TLAST marks the last beat of the tile and TKEEP
+// drops the unused lanes of a partial last beat.
+//
+// Both links go through axis_skid, so TREADY never depends combinationally on
+// the other side and each link sustains one transfer per cycle. A finished
+// tile is copied out of the core into a frame register. The next tile can
+// then accumulate while the previous frame drains, and a frame's beats leave
+// back to back. The wrapper issues start itself whenever the core is idle.
+module npu_axis #(
+    parameter integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE,
+    parameter integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH,
+    parameter integer MAX_K           = npu_config_pkg::NPU_MAX_K,
+    parameter integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS,
+    parameter integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS,
+    parameter integer ACT_FUNC        = 0, // 0 = identity, 1 = ReLU
+    parameter integer FIFO_DEPTH      = 2 * ARRAY_SIZE,
+    parameter integer PE_PIPELINE     = 0,
+    parameter integer ELEMS_PER_BEAT  = ARRAY_SIZE, // results packed into one output transfer
+    parameter integer LANE_WIDTH      = 8 * ((ACC_WIDTH + 7) / 8),
+    parameter integer IN_WIDTH        = 2 * ARRAY_SIZE * DATA_WIDTH,
+    parameter integer OUT_WIDTH       = ELEMS_PER_BEAT * LANE_WIDTH
+) (
+    input                           clk,
+    input                           rst,
+    input                           s_axis_tvalid,
+    output                          s_axis_tready,
+    input      [IN_WIDTH-1:0]       s_axis_tdata,
+    input                           s_axis_tlast,
+    output                          m_axis_tvalid,
+    input                           m_axis_tready,
+    output     [OUT_WIDTH-1:0]      m_axis_tdata,
+    output     [OUT_WIDTH/8-1:0]    m_axis_tkeep,
+    output                          m_axis_tlast
+);
+
+    localparam integer OUTPUT_COUNT = ARRAY_SIZE * ARRAY_SIZE;
+    localparam integer OUT_BEATS    = (OUTPUT_COUNT + ELEMS_PER_BEAT - 1) / ELEMS_PER_BEAT;
+    localparam integer BEAT_WIDTH   = (OUT_BEATS > 1) ? $clog2(OUT_BEATS) : 1;
+    localparam integer LANE_BYTES   = LANE_WIDTH / 8;
+    localparam integer FRAME_ELEMS  = OUT_BEATS * ELEMS_PER_BEAT;
+    localparam integer LAST_LANES   = OUTPUT_COUNT - (OUT_BEATS - 1) * ELEMS_PER_BEAT;
+
+    initial begin
+        if ((IN_WIDTH % 8) != 0) begin
+            $error("TDATA width %0d (2*ARRAY_SIZE*DATA_WIDTH) must be a whole number of bytes", IN_WIDTH);
+        end
+        if (LANE_WIDTH < ACC_WIDTH || (LANE_WIDTH % 8) != 0) begin
+            $error("LANE_WIDTH (%0d) must be a byte multiple of at least ACC_WIDTH (%0d)", LANE_WIDTH, ACC_WIDTH);
+        end
+    end
+
+    // ------------------------------------------------------------------
+    // Operand link: s_axis -> skid -> core operand FIFO
+    // ------------------------------------------------------------------
+    wire                core_in_valid;
+    wire                core_in_ready;
+    wire                core_in_last;
+    wire [IN_WIDTH-1:0] core_in_data;
+
+    axis_skid #(
+        .WIDTH (IN_WIDTH + 1)
+    ) u_in_skid (
+        .clk     (clk),
+        .rst     (rst),
+        .s_valid (s_axis_tvalid),
+        .s_ready (s_axis_tready),
+        .s_data  ({s_axis_tlast, s_axis_tdata}),
+        .m_valid (core_in_valid),
+        .m_ready (core_in_ready),
+        .m_data  ({core_in_last, core_in_data})
+    );
+
+    // ------------------------------------------------------------------
+    // Core and job control
+    // ------------------------------------------------------------------
+    wire                              core_busy;
+    wire                              core_done;
+    wire [OUTPUT_COUNT*ACC_WIDTH-1:0] core_c_out_flat;
+
+    reg tile_pending; // core holds a finished tile the frame register has not taken yet
+    reg frame_valid;  // frame register is draining to the output skid
+
+    // A job may start before its beats arrive; the core waits on its FIFO.
+    // Starting clears the accumulators, so hold off while a tile is unread.
+    wire core_start = !core_busy && !core_done && !tile_pending;
+
+    npu_core #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (MAX_K),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACC_WIDTH      (ACC_WIDTH),
+        .ACT_FUNC       (ACT_FUNC),
+        .FIFO_DEPTH     (FIFO_DEPTH),
+        .PE_PIPELINE    (PE_PIPELINE)
+    ) u_core (
+        .clk           (clk),
+        .rst           (rst),
+        .start         (core_start),
+        .int4_mode     (1'b0),
+        .in_valid      (core_in_valid),
+        .in_ready      (core_in_ready),
+        .in_last       (core_in_last),
+        .a_stream      (core_in_data[0 +: ARRAY_SIZE*DATA_WIDTH]),
+        .b_stream      (core_in_data[ARRAY_SIZE*DATA_WIDTH +: ARRAY_SIZE*DATA_WIDTH]),
+        .busy          (core_busy),
+        .done          (core_done),
+        .c_valid       (),
+        .c_out_flat    (core_c_out_flat),
+        .c_out_hi_flat (),
+        .result_valid  (),
+        .result_data   (),
+        .result_index  (),
+        .result_last   (),
+        .result_ready  (1'b1)
+    );
+
+    // ------------------------------------------------------------------
+    // Result link: frame register -> skid -> m_axis
+    // ------------------------------------------------------------------
+    reg [FRAME_ELEMS*ACC_WIDTH-1:0] frame_flat;
+    reg [BEAT_WIDTH-1:0]            beat_index;
+
+    wire                 out_ready;
+    wire                 beat_fire = frame_valid && out_ready;
+    wire                 beat_last = (beat_index == OUT_BEATS-1);
+    wire [OUT_WIDTH-1:0] beat_data;
+    wire [OUT_WIDTH/8-1:0] beat_keep;
+
+    // The next tile is taken as soon as the register frees up, including on
+    // the cycle its last beat leaves, so consecutive frames have no gap
+    wire capture = (core_done || tile_pending) && (!frame_valid || (beat_fire && beat_last));
+
+    genvar lane;
+    generate
+        for (lane = 0; lane < ELEMS_PER_BEAT; lane = lane + 1) begin : gen_lanes
+            // Signed, so the assignment sign-extends into the wider lane
+            wire signed [ACC_WIDTH-1:0] elem = frame_flat[lane*ACC_WIDTH +: ACC_WIDTH];
+
+            assign beat_data[lane*LANE_WIDTH +: LANE_WIDTH] = elem;
+            assign beat_keep[lane*LANE_BYTES +: LANE_BYTES] =
+                (!beat_last || (lane < LAST_LANES)) ? {LANE_BYTES{1'b1}} : {LANE_BYTES{1'b0}};
+        end
+    endgenerate
+
+    always @(posedge clk) begin
+        if (rst) begin
+            tile_pending <= 1'b0;
+            frame_valid  <= 1'b0;
+            frame_flat   <= {(FRAME_ELEMS*ACC_WIDTH){1'b0}};
+            beat_index   <= {BEAT_WIDTH{1'b0}};
+        end else begin
+            if (capture) begin
+                tile_pending <= 1'b0;
+                frame_valid  <= 1'b1;
+                frame_flat   <= core_c_out_flat; // zero-padded up to whole beats
+                beat_index   <= {BEAT_WIDTH{1'b0}};
+            end else begin
+                if (core_done) begin
+                    tile_pending <= 1'b1;
+                end
+                if (beat_fire) begin
+                    // Shift the next ELEMS_PER_BEAT results down into lane 0
+                    frame_flat <= frame_flat >> (ELEMS_PER_BEAT*ACC_WIDTH);
+                    beat_index <= beat_index + {{(BEAT_WIDTH-1){1'b0}}, 1'b1};
+                    if (beat_last) begin
+                        frame_valid <= 1'b0;
+                    end
+                end
+            end
+        end
+    end
+
+    axis_skid #(
+        .WIDTH (OUT_WIDTH + OUT_WIDTH/8 + 1)
+    ) u_out_skid (
+        .clk     (clk),
+        .rst     (rst),
+        .s_valid (frame_valid),
+        .s_ready (out_ready),
+        .s_data  ({beat_last, beat_keep, beat_data}),
+        .m_valid (m_axis_tvalid),
+        .m_ready (m_axis_tready),
+        .m_data  ({m_axis_tlast, m_axis_tkeep, m_axis_tdata})
+    );
+
+endmodule
@@ -0,0 +1,140 @@
+// Cluster of NUM_CORES npu_core instances sharing one operand bus
+// b_stream is broadcast to every core, while each core gets its own
+// ARRAY_SIZE-lane slice of a_stream. One beat therefore feeds all cores, and
+// a job computes a (NUM_CORES*ARRAY_SIZE) x ARRAY_SIZE block of C: core c
+// produces rows c*ARRAY_SIZE .. c*ARRAY_SIZE+ARRAY_SIZE-1. To share A across
+// the cores instead, run the transposed product (C^T = B^T A^T).
+//
+// The cores start together and see the same beats, so they stay in lockstep
+// and finish on the same cycle. Their result streams are merged by a
+// round-robin arbiter, one word per handshake, tagged with result_core.
+module npu_cluster #(
+    parameter integer NUM_CORES       = 2,
+    parameter integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE,
+    parameter integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH,
+    parameter integer MAX_K           = npu_config_pkg::NPU_MAX_K,
+    parameter integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS,
+    parameter integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS,
+    parameter integer ACT_FUNC        = 0,
+    parameter integer SPARSE_STREAM   = 0,
+    parameter integer FIFO_DEPTH      = 2 * ARRAY_SIZE,
+    parameter integer PE_PIPELINE     = 0,
+    parameter integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE,
+    parameter integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1,
+    parameter integer CORE_WIDTH      = (NUM_CORES > 1) ? $clog2(NUM_CORES) : 1
+) (
+    input                               clk,
+    input                               rst,
+    input                               start,        // ignored while busy
+    input                               in_valid,
+    output                              in_ready,
+    input                               in_last,
+    input      [NUM_CORES*ARRAY_SIZE*DATA_WIDTH-1:0] a_stream, // core c: lanes c*ARRAY_SIZE..
+    input      [ARRAY_SIZE*DATA_WIDTH-1:0] b_stream,             // broadcast to all cores
+    output                              busy,
+    output                              done,
+    output                              c_valid,
+    output     [NUM_CORES*OUTPUT_COUNT*ACC_WIDTH-1:0] c_out_flat, // row-major over the cluster block
+    output                              result_valid,
+    output     [ACC_WIDTH-1:0]          result_data,
+    output     [INDEX_WIDTH-1:0]        result_index,
+    output     [CORE_WIDTH-1:0]         result_core,
+    output                              result_last,  // final word of result_core's tile
+    input                               result_ready
+);
+
+    wire [NUM_CORES-1:0]             core_in_ready;
+    wire [NUM_CORES-1:0]             core_busy;
+    wire [NUM_CORES-1:0]             core_done;
+    wire [NUM_CORES-1:0]             core_c_valid;
+    wire [NUM_CORES-1:0]             core_result_valid;
+    wire [NUM_CORES*ACC_WIDTH-1:0]   core_result_data;
+    wire [NUM_CORES*INDEX_WIDTH-1:0] core_result_index;
+    wire [NUM_CORES-1:0]             core_result_last;
+    wire [NUM_CORES-1:0]             core_result_ready;
+
+    reg [CORE_WIDTH-1:0] rr_next;
+    reg [CORE_WIDTH-1:0] grant;
+    reg                  grant_valid;
+    integer              scan;
+    integer              candidate;
+
+    // A beat is pushed into every operand FIFO at once, so they drain in step
+    assign in_ready = &core_in_ready;
+    assign busy     = |core_busy;
+    assign done     = &core_done;
+    assign c_valid  = &core_c_valid;
+
+    wire core_start = start && !busy;
+    wire core_push  = in_valid && in_ready;
+
+    genvar core;
+    generate
+        for (core = 0; core < NUM_CORES; core = core + 1) begin : gen_cores
+            npu_core #(
+                .ARRAY_SIZE     (ARRAY_SIZE),
+                .DATA_WIDTH     (DATA_WIDTH),
+                .MAX_K          (MAX_K),
+                .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+                .ACC_WIDTH      (ACC_WIDTH),
+                .ACT_FUNC       (ACT_FUNC),
+                .SPARSE_STREAM  (SPARSE_STREAM),
+                .FIFO_DEPTH     (FIFO_DEPTH),
+                .PE_PIPELINE    (PE_PIPELINE),
+                .OUTPUT_COUNT   (OUTPUT_COUNT),
+                .INDEX_WIDTH    (INDEX_WIDTH)
+            ) u_core (
+                .clk           (clk),
+                .rst           (rst),
+                .start         (core_start),
+                .int4_mode     (1'b0),
+                .in_valid      (core_push),
+                .in_ready      (core_in_ready[core]),
+                .in_last       (in_last),
+                .a_stream      (a_stream[core*ARRAY_SIZE*DATA_WIDTH +: ARRAY_SIZE*DATA_WIDTH]),
+                .b_stream      (b_stream),
+                .busy          (core_busy[core]),
+                .done          (core_done[core]),
+                .c_valid       (core_c_valid[core]),
+                .c_out_flat    (c_out_flat[core*OUTPUT_COUNT*ACC_WIDTH +: OUTPUT_COUNT*ACC_WIDTH]),
+                .c_out_hi_flat (),
+                .result_valid  (core_result_valid[core]),
+                .result_data   (core_result_data[core*ACC_WIDTH +: ACC_WIDTH]),
+                .result_index  (core_result_index[core*INDEX_WIDTH +: INDEX_WIDTH]),
+                .result_last   (core_result_last[core]),
+                .result_ready  (core_result_ready[core])
+            );
+
+            assign core_result_ready[core] = result_ready && result_valid && (grant == core);
+        end
+    endgenerate
+
+    // Round-robin result arbiter: the first valid core at or after rr_next
+    // wins, and rr_next moves past the winner after each handshake
+    always @(*) begin
+        grant       = rr_next;
+        grant_valid = 1'b0;
+        for (scan = NUM_CORES-1; scan >= 0; scan = scan - 1) begin
+            candidate = (rr_next + scan) % NUM_CORES;
+            if (core_result_valid[candidate]) begin
+                grant       = candidate;
+                grant_valid = 1'b1;
+            end
+        end
+    end
+
+    assign result_valid = grant_valid;
+    assign result_data  = core_result_data[grant*ACC_WIDTH +: ACC_WIDTH];
+    assign result_index = core_result_index[grant*INDEX_WIDTH +: INDEX_WIDTH];
+    assign result_core  = grant;
+    assign result_last  = core_result_last[grant];
+
+    always @(posedge clk) begin
+        if (rst) begin
+            rr_next <= {CORE_WIDTH{1'b0}};
+        end else if (result_valid && result_ready) begin
+            rr_next <= (grant == NUM_CORES-1) ? {CORE_WIDTH{1'b0}} : grant + 1'b1;
+        end
+    end
+
+endmodule
@@ -0,0 +1,359 @@
+// Descriptor-driven command processor for npu_core
+// Walks a ring of job descriptors held in local memory, fetches operand beats,
+// drives the core and writes activated results back without host involvement.
+//
+// Local memory is WORD_WIDTH bits wide and word addressed:
+//   A operand : k_len words, word k = A[:,k] packed like a_stream
+//   B operand : k_len words, word k = B[k,:] packed like b_stream
+//   Result    : OUTPUT_COUNT words, row-major, sign-extended
+//   Descriptor: DESC_WORDS words at ring_base + DESC_WORDS*slot
+//     word 0: A address      word 1: B address      word 2: C address
+//     word 3: control  [15:0] k_len, [16] ReLU, [17] irq on completion,
+//                      [18] sparse A, [31] valid (set by host, cleared on completion)
+//
+// Sparse A (zero k-beat skipping): the A panel holds only the k_len non-zero
+// columns, followed by MASK_WORDS words of a MAX_K-bit map of the original k
+// indices they came from (bit k of word k/WORD_WIDTH). B keeps its full panel
+// and beat i reads the row of the i-th set bit, so skipped beats never reach
+// the core.
+module npu_cmdproc #(
+    parameter integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE,
+    parameter integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH,
+    parameter integer MAX_K           = npu_config_pkg::NPU_MAX_K,
+    parameter integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS,
+    parameter integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS,
+    parameter integer WORD_WIDTH      = 32,
+    parameter integer MEM_WORDS       = 4096,
+    parameter integer ADDR_WIDTH      = $clog2(MEM_WORDS),
+    parameter integer RING_ENTRIES    = 16,
+    parameter integer RING_PTR_WIDTH  = (RING_ENTRIES > 1) ? $clog2(RING_ENTRIES) : 1
+) (
+    input                               clk,
+    input                               rst,
+
+    // Host access to local memory (synchronous read, one cycle latency)
+    input                               host_we,
+    input      [ADDR_WIDTH-1:0]         host_addr,
+    input      [WORD_WIDTH-1:0]         host_wdata,
+    output reg [WORD_WIDTH-1:0]         host_rdata,
+
+    // Descriptor ring control
+    input      [ADDR_WIDTH-1:0]         ring_base,
+    input                               doorbell,
+    input      [RING_PTR_WIDTH-1:0]     doorbell_tail,
+    output reg [RING_PTR_WIDTH-1:0]     ring_head,
+    output                              idle,
+    output reg                          irq,
+    output reg [31:0]                   completed_count
+);
+
+    localparam integer OUTPUT_COUNT = ARRAY_SIZE * ARRAY_SIZE;
+    localparam integer INDEX_WIDTH  = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1;
+    localparam integer LANE_WIDTH   = ARRAY_SIZE * DATA_WIDTH;
+    localparam integer DESC_WORDS   = 4;
+    localparam integer K_WIDTH      = 16;
+    localparam integer MASK_WORDS   = (MAX_K + WORD_WIDTH - 1) / WORD_WIDTH;
+    localparam integer MASK_BITS    = MASK_WORDS * WORD_WIDTH;
+
+    localparam integer CTRL_RELU_BIT   = 16;
+    localparam integer CTRL_IRQ_BIT    = 17;
+    localparam integer CTRL_SPARSE_BIT = 18;
+    localparam integer CTRL_VALID_BIT  = 31;
+
+    localparam [2:0] S_IDLE   = 3'd0;
+    localparam [2:0] S_DESC   = 3'd1;
+    localparam [2:0] S_START  = 3'd2;
+    localparam [2:0] S_FEED   = 3'd3;
+    localparam [2:0] S_DRAIN  = 3'd4;
+    localparam [2:0] S_STATUS = 3'd5;
+    localparam [2:0] S_MASK   = 3'd6;
+
+    initial begin
+        if (WORD_WIDTH < LANE_WIDTH || WORD_WIDTH < ACC_WIDTH || WORD_WIDTH < 32) begin
+            $error("WORD_WIDTH (%0d) must hold one operand beat (%0d), one result (%0d) and a 32-bit control word",
+                   WORD_WIDTH, LANE_WIDTH, ACC_WIDTH);
+        end
+        if (MASK_WORDS > 6) begin
+            $error("MAX_K (%0d) needs %0d k-index map words, at most 6 are supported",
+                   MAX_K, MASK_WORDS);
+        end
+    end
+
+    // ------------------------------------------------------------------
+    // Local memory: host port plus two engine read ports and one write port
+    // ------------------------------------------------------------------
+    reg [WORD_WIDTH-1:0] mem [0:MEM_WORDS-1];
+
+    reg  [ADDR_WIDTH-1:0] rd_addr_a;
+    reg  [ADDR_WIDTH-1:0] rd_addr_b;
+    reg  [WORD_WIDTH-1:0] rd_data_a;
+    reg  [WORD_WIDTH-1:0] rd_data_b;
+    reg                   eng_we;
+    reg  [ADDR_WIDTH-1:0] eng_waddr;
+    reg  [WORD_WIDTH-1:0] eng_wdata;
+
+    always @(posedge clk) begin
+        if (host_we) begin
+            mem[host_addr] <= host_wdata;
+        end
+        // Engine writes win on a same-address collision
+        if (eng_we) begin
+            mem[eng_waddr] <= eng_wdata;
+        end
+        host_rdata <= mem[host_addr];
+        rd_data_a  <= mem[rd_addr_a];
+        rd_data_b  <= mem[rd_addr_b];
+    end
+
+    // ------------------------------------------------------------------
+    // Core instance
+    // ------------------------------------------------------------------
+    wire                    core_start;
+    wire                    core_in_valid;
+    wire                    core_in_ready;
+    wire                    core_in_last;
+    wire [LANE_WIDTH-1:0]   core_a;
+    wire [LANE_WIDTH-1:0]   core_b;
+    wire                    core_busy;
+    wire                    core_result_valid;
+    wire [ACC_WIDTH-1:0]    core_result_data;
+    wire [INDEX_WIDTH-1:0]  core_result_index;
+    wire                    core_result_last;
+
+    npu_core #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (MAX_K),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACC_WIDTH      (ACC_WIDTH),
+        .ACT_FUNC       (0)
+    ) u_core (
+        .clk           (clk),
+        .rst           (rst),
+        .start         (core_start),
+        .int4_mode     (1'b0),
+        .in_valid      (core_in_valid),
+        .in_ready      (core_in_ready),
+        .in_last       (core_in_last),
+        .a_stream      (core_a),
+        .b_stream      (core_b),
+        .busy          (core_busy),
+        .done          (),
+        .c_valid       (),
+        .c_out_flat    (),
+        .c_out_hi_flat (),
+        .result_valid  (core_result_valid),
+        .result_data   (core_result_data),
+        .result_index  (core_result_index),
+        .result_last   (core_result_last),
+        .result_ready  (1'b1)
+    );
+
+    // ------------------------------------------------------------------
+    // Descriptor state
+    // ------------------------------------------------------------------
+    reg [2:0]                state;
+    reg [RING_PTR_WIDTH-1:0] ring_tail;
+    reg [ADDR_WIDTH-1:0]     desc_base;
+    reg [2:0]                desc_word;
+
+    reg [ADDR_WIDTH-1:0]     a_addr;
+    reg [ADDR_WIDTH-1:0]     b_addr;
+    reg [ADDR_WIDTH-1:0]     c_addr;
+    reg [31:0]               desc_ctrl;
+
+    // k_len is clamped to 1..MAX_K so the core never ends a job on its own
+    wire [K_WIDTH-1:0] desc_k    = desc_ctrl[K_WIDTH-1:0];
+    wire [K_WIDTH-1:0] k_len     = (desc_k == {K_WIDTH{1'b0}}) ? {{(K_WIDTH-1){1'b0}}, 1'b1} :
+                                   (desc_k > MAX_K)            ? MAX_K : desc_k;
+    wire               desc_relu = desc_ctrl[CTRL_RELU_BIT];
+
+    // Remaining k indices of the job; B beat i reads the lowest one still set.
+    // Dense jobs use the first k_len indices.
+    reg  [MASK_BITS-1:0] k_mask;
+    reg  [K_WIDTH-1:0]   next_k;
+    integer              mask_bit;
+
+    always @(*) begin
+        next_k = {K_WIDTH{1'b0}};
+        for (mask_bit = MASK_BITS-1; mask_bit >= 0; mask_bit = mask_bit - 1) begin
+            if (k_mask[mask_bit]) begin
+                next_k = mask_bit;
+            end
+        end
+    end
+
+    // Beat issue: one read per operand per cycle, with a one-entry hold
+    // register that absorbs the read in flight when the core deasserts in_ready
+    reg [K_WIDTH-1:0]    beats_issued;
+    reg [K_WIDTH-1:0]    beats_pushed;
+    reg                  rd_valid;
+    reg                  rd_last;
+    reg                  hold_valid;
+    reg                  hold_last;
+    reg [LANE_WIDTH-1:0] hold_a;
+    reg [LANE_WIDTH-1:0] hold_b;
+
+    wire beat_issue = (state == S_FEED) && (beats_issued < k_len) &&
+                      (hold_valid ? core_in_ready : (!rd_valid || core_in_ready));
+
+    assign core_start    = (state == S_START) && !core_busy;
+    assign core_in_valid = hold_valid || rd_valid;
+    assign core_in_last  = hold_valid ? hold_last : rd_last;
+    assign core_a        = hold_valid ? hold_a : rd_data_a[LANE_WIDTH-1:0];
+    assign core_b        = hold_valid ? hold_b : rd_data_b[LANE_WIDTH-1:0];
+
+    wire beat_pushed     = core_in_valid && core_in_ready;
+    wire result_accepted = (state == S_DRAIN) && core_result_valid;
+
+    wire [ACC_WIDTH-1:0] result_act = (desc_relu && core_result_data[ACC_WIDTH-1]) ?
+                                      {ACC_WIDTH{1'b0}} : core_result_data;
+
+    assign idle = (state == S_IDLE) && (ring_head == ring_tail);
+
+    // Read address and write port steering
+    always @(*) begin
+        rd_addr_a = desc_base + desc_word;
+        rd_addr_b = b_addr + next_k;
+        eng_we    = 1'b0;
+        eng_waddr = c_addr + core_result_index;
+        eng_wdata = {{(WORD_WIDTH-ACC_WIDTH){result_act[ACC_WIDTH-1]}}, result_act};
+
+        if (state == S_FEED) begin
+            rd_addr_a = a_addr + beats_issued;
+        end else if (state == S_MASK) begin
+            rd_addr_a = a_addr + k_len + desc_word;
+        end
+
+        if (result_accepted) begin
+            eng_we = 1'b1;
+        end else if (state == S_STATUS) begin
+            eng_we    = 1'b1;
+            eng_waddr = desc_base + DESC_WORDS - 1;
+            eng_wdata = {{(WORD_WIDTH-32){1'b0}}, desc_ctrl & ~(32'd1 << CTRL_VALID_BIT)};
+        end
+    end
+
+    always @(posedge clk) begin
+        if (rst) begin
+            state           <= S_IDLE;
+            ring_head       <= {RING_PTR_WIDTH{1'b0}};
+            ring_tail       <= {RING_PTR_WIDTH{1'b0}};
+            desc_base       <= {ADDR_WIDTH{1'b0}};
+            desc_word       <= 3'd0;
+            a_addr          <= {ADDR_WIDTH{1'b0}};
+            b_addr          <= {ADDR_WIDTH{1'b0}};
+            c_addr          <= {ADDR_WIDTH{1'b0}};
+            desc_ctrl       <= 32'd0;
+            k_mask          <= {MASK_BITS{1'b0}};
+            beats_issued    <= {K_WIDTH{1'b0}};
+            beats_pushed    <= {K_WIDTH{1'b0}};
+            rd_valid        <= 1'b0;
+            rd_last         <= 1'b0;
+            hold_valid      <= 1'b0;
+            hold_last       <= 1'b0;
+            hold_a          <= {LANE_WIDTH{1'b0}};
+            hold_b          <= {LANE_WIDTH{1'b0}};
+            irq             <= 1'b0;
+            completed_count <= 32'd0;
+        end else begin
+            irq <= 1'b0;
+
+            if (doorbell) begin
+                ring_tail <= doorbell_tail;
+            end
+
+            case (state)
+                S_IDLE: begin
+                    if (ring_head != ring_tail) begin
+                        desc_base <= ring_base + (ring_head * DESC_WORDS);
+                        desc_word <= 3'd0;
+                        state     <= S_DESC;
+                    end
+                end
+
+                // One descriptor word per cycle; data returns a cycle after its address
+                S_DESC: begin
+                    desc_word <= desc_word + 3'd1;
+                    case (desc_word)
+                        3'd1: a_addr    <= rd_data_a[ADDR_WIDTH-1:0];
+                        3'd2: b_addr    <= rd_data_a[ADDR_WIDTH-1:0];
+                        3'd3: c_addr    <= rd_data_a[ADDR_WIDTH-1:0];
+                        3'd4: begin
+                            desc_ctrl <= rd_data_a[31:0];
+                            desc_word <= 3'd0;
+                            state     <= rd_data_a[CTRL_SPARSE_BIT] ? S_MASK : S_START;
+                        end
+                        default: ;
+                    endcase
+                end
+
+                // k-index map after the compressed A panel, same read timing
+                S_MASK: begin
+                    desc_word <= desc_word + 3'd1;
+                    if (desc_word != 3'd0) begin
+                        k_mask[(desc_word-1)*WORD_WIDTH +: WORD_WIDTH] <= rd_data_a;
+                    end
+                    if (desc_word == MASK_WORDS) begin
+                        state <= S_START;
+                    end
+                end
+
+                S_START: begin
+                    if (!core_busy) begin
+                        if (!desc_ctrl[CTRL_SPARSE_BIT]) begin
+                            k_mask <= {MASK_BITS{1'b1}} >> (MASK_BITS - k_len);
+                        end
+                        beats_issued    <= {K_WIDTH{1'b0}};
+                        beats_pushed    <= {K_WIDTH{1'b0}};
+                        state           <= S_FEED;
+                    end
+                end
+
+                S_FEED: begin
+                    if (beat_pushed) begin
+                        beats_pushed <= beats_pushed + 1'b1;
+                        if (beats_pushed + 1'b1 == k_len) begin
+                            state <= S_DRAIN;
+                        end
+                    end
+                end
+
+                S_DRAIN: begin
+                    if (result_accepted && core_result_last) begin
+                        state <= S_STATUS;
+                    end
+                end
+
+                S_STATUS: begin
+                    completed_count <= completed_count + 32'd1;
+                    irq             <= desc_ctrl[CTRL_IRQ_BIT];
+                    ring_head       <= (ring_head == RING_ENTRIES-1) ? {RING_PTR_WIDTH{1'b0}} : ring_head + 1'b1;
+                    state           <= S_IDLE;
+                end
+
+                default: state <= S_IDLE;
+            endcase
+
+            // Beat datapath
+            if (beat_issue) begin
+                beats_issued <= beats_issued + 1'b1;
+                k_mask       <= k_mask & (k_mask - 1'b1);
+            end
+            rd_valid <= beat_issue;
+            rd_last  <= beat_issue && (beats_issued + 1'b1 == k_len);
+
+            if (hold_valid) begin
+                if (core_in_ready) begin
+                    hold_valid <= 1'b0;
+                end
+            end else if (rd_valid && !core_in_ready) begin
+                hold_valid <= 1'b1;
+                hold_last  <= rd_last;
+                hold_a     <= rd_data_a[LANE_WIDTH-1:0];
+                hold_b     <= rd_data_b[LANE_WIDTH-1:0];
+            end
+        end
+    end
+
+endmodule
@@ -0,0 +1,11 @@
+// Generated by sw/gen_config_pkg.cpp from sw/npu_config.hpp - do not edit by hand
+// Default NPU build shared by the RTL parameter defaults and the testbenches
+package npu_config_pkg;
+    localparam integer NPU_ARRAY_SIZE     = 4;
+    localparam integer NPU_DATA_WIDTH     = 8;
+    localparam integer NPU_MAX_K          = 4;
+    localparam integer NPU_EXTRA_ACC_BITS = 2;
+    localparam integer NPU_ACC_WIDTH      = 20;
+    localparam integer NPU_OUTPUT_COUNT   = 16;
+    localparam integer NPU_INDEX_WIDTH    = 4;
+endpackage
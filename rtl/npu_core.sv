@@ -1,44 +1,58 @@
 // Pipelined outer-product NPU core with configurable activation and streaming output
 module npu_core #(
-    parameter integer ARRAY_SIZE      = 4,
-    parameter integer DATA_WIDTH      = 8,
-    parameter integer EXTRA_ACC_BITS  = 2,
-    parameter integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(ARRAY_SIZE) + EXTRA_ACC_BITS,
+    parameter integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE,
+    parameter integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH,
+    parameter integer MAX_K           = npu_config_pkg::NPU_MAX_K, // longest accumulation, in beats per job
+    parameter integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS,
+    parameter integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS,
     parameter integer ACT_FUNC        = 0, // 0 = identity, 1 = ReLU
+    parameter integer SPARSE_STREAM   = 0, // 1 = stream only non-zero results + end marker
+    parameter integer FIFO_DEPTH      = 2 * ARRAY_SIZE, // operand beats buffered ahead of the array
+    parameter integer PE_PIPELINE     = 0, // 1 = register PE products before accumulation
+    parameter integer BACK_TO_BACK    = 0, // 1 = accept start with the first beat and while results drain
+    parameter integer DUAL_INT4       = 0, // 1 = build the runtime int4 weight-pair mode
     parameter integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE,
-    parameter integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1
+    parameter integer STREAM_COUNT    = (DUAL_INT4 != 0) ? 2 * OUTPUT_COUNT : OUTPUT_COUNT,
+    parameter integer INDEX_WIDTH     = (STREAM_COUNT > 1) ? $clog2(STREAM_COUNT) : 1
 ) (
     input                               clk,
     input                               rst,
     input                               start,
+    input                               int4_mode,    // sampled with start, needs DUAL_INT4
     input                               in_valid,
+    output                              in_ready,
+    input                               in_last,
     input      [ARRAY_SIZE*DATA_WIDTH-1:0] a_stream,
     input      [ARRAY_SIZE*DATA_WIDTH-1:0] b_stream,
     output                              busy,
     output reg                          done,
     output reg                          c_valid,
     output     [OUTPUT_COUNT*ACC_WIDTH-1:0] c_out_flat,
-    output reg                          result_valid,
-    output reg  [ACC_WIDTH-1:0]         result_data,
-    output reg  [INDEX_WIDTH-1:0]       result_index,
+    output     [OUTPUT_COUNT*ACC_WIDTH-1:0] c_out_hi_flat,
+    output                              result_valid,
+    output      [ACC_WIDTH-1:0]         result_data,
+    output      [INDEX_WIDTH-1:0]       result_index,
+    output                              result_last,
     input                               result_ready
 );
 
-    localparam integer COUNT_WIDTH   = (ARRAY_SIZE > 1) ? $clog2(ARRAY_SIZE + 1) : 1;
-    localparam integer ROWCOL_WIDTH  = (ARRAY_SIZE > 1) ? $clog2(ARRAY_SIZE)     : 1;
-    localparam integer MIN_ACC_WIDTH = (2*DATA_WIDTH) + $clog2(ARRAY_SIZE);
+    localparam integer COUNT_WIDTH   = (MAX_K > 1) ? $clog2(MAX_K + 1) : 1;
+    localparam integer MIN_ACC_WIDTH = (2*DATA_WIDTH) + $clog2(MAX_K);
 
     initial begin
         if (ACC_WIDTH < MIN_ACC_WIDTH) begin
-            $error("ACC_WIDTH (%0d) is insufficient. Minimum required is %0d for ARRAY_SIZE=%0d DATA_WIDTH=%0d",
-                   ACC_WIDTH, MIN_ACC_WIDTH, ARRAY_SIZE, DATA_WIDTH);
+            $error("ACC_WIDTH (%0d) is insufficient. Minimum required is %0d for MAX_K=%0d DATA_WIDTH=%0d",
+                   ACC_WIDTH, MIN_ACC_WIDTH, MAX_K, DATA_WIDTH);
         end
     end
 
-    reg active;
-    reg streaming;
+    reg  active;
+    wire streaming;
     reg [COUNT_WIDTH-1:0] feed_count;
     reg [COUNT_WIDTH-1:0] processed_count;
+    reg                   fed_last;
+    reg                   int4_job;
+    reg                   tile_computed; // all beats accumulated, waiting for the streamer
 
     reg signed [DATA_WIDTH-1:0] a_stage0 [0:ARRAY_SIZE-1];
     reg signed [DATA_WIDTH-1:0] b_stage0 [0:ARRAY_SIZE-1];
@@ -46,12 +60,54 @@ module npu_core #(
     reg signed [DATA_WIDTH-1:0] b_stage1 [0:ARRAY_SIZE-1];
 
     reg valid_stage0;
+
+    // A start is taken whenever no job is computing. The default build also
+    // waits for the previous tile to finish streaming, since the streamer
+    // reads the live accumulators. BACK_TO_BACK streams from a snapshot
+    // instead, so start is taken on the done cycle and during streaming.
+    wire start_accept = start && !active && ((BACK_TO_BACK != 0) || !streaming);
+    wire job_feeding  = active || ((BACK_TO_BACK != 0) && start_accept);
+
+    // Operand FIFO: beats are accepted whenever in_ready is high, including
+    // before start, and drained into stage0 one per cycle while active
+    // (BACK_TO_BACK: from the start cycle on).
+    // A job ends at the beat tagged in_last, or implicitly after MAX_K beats.
+    wire                                fifo_valid;
+    wire [2*ARRAY_SIZE*DATA_WIDTH:0]    fifo_data;
+    wire [ARRAY_SIZE*DATA_WIDTH-1:0]    fifo_a    = fifo_data[0 +: ARRAY_SIZE*DATA_WIDTH];
+    wire [ARRAY_SIZE*DATA_WIDTH-1:0]    fifo_b    = fifo_data[ARRAY_SIZE*DATA_WIDTH +: ARRAY_SIZE*DATA_WIDTH];
+    wire [COUNT_WIDTH-1:0]              feed_base = start_accept ? {COUNT_WIDTH{1'b0}} : feed_count;
+    wire                                fifo_pop  = job_feeding && !(active && fed_last);
+    wire                                pop_last  = fifo_data[2*ARRAY_SIZE*DATA_WIDTH] || (feed_base == MAX_K-1);
+
+    operand_fifo #(
+        .WIDTH (2*ARRAY_SIZE*DATA_WIDTH + 1),
+        .DEPTH (FIFO_DEPTH)
+    ) u_operand_fifo (
+        .clk       (clk),
+        .rst       (rst),
+        .push      (in_valid),
+        .push_data ({in_last, b_stream, a_stream}),
+        .in_ready  (in_ready),
+        .pop       (fifo_pop),
+        .pop_data  (fifo_data),
+        .out_valid (fifo_valid),
+        .count     ()
+    );
     reg valid_stage1;
+    reg valid_acc;
+
+    // Beat accumulated this cycle: stage1 itself, or one cycle later when the
+    // PE registers its product first
+    wire acc_valid = (PE_PIPELINE != 0) ? valid_acc : valid_stage1;
+    wire last_acc  = acc_valid && fed_last && (processed_count + 1'b1 == feed_count);
 
-    wire clear_acc = start;
+    wire clear_acc = (BACK_TO_BACK != 0) ? start_accept : start;
 
     wire signed [ACC_WIDTH-1:0] acc_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
     wire signed [ACC_WIDTH-1:0] act_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    wire signed [ACC_WIDTH-1:0] acc_hi_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    wire signed [ACC_WIDTH-1:0] act_hi_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
 
     assign busy = active | streaming;
 
@@ -61,22 +117,28 @@ module npu_core #(
         for (row = 0; row < ARRAY_SIZE; row = row + 1) begin : gen_rows
             for (col = 0; col < ARRAY_SIZE; col = col + 1) begin : gen_cols
                 pe #(
-                    .DATA_WIDTH(DATA_WIDTH),
-                    .ACC_WIDTH (ACC_WIDTH)
+                    .DATA_WIDTH (DATA_WIDTH),
+                    .ACC_WIDTH  (ACC_WIDTH),
+                    .DUAL_INT4  (DUAL_INT4),
+                    .PE_PIPELINE(PE_PIPELINE)
                 ) u_pe (
-                    .clk     (clk),
-                    .rst     (rst),
-                    .clear   (clear_acc),
-                    .enable  (valid_stage1),
-                    .a_value (a_stage1[row]),
-                    .b_value (b_stage1[col]),
-                    .acc_out (acc_matrix[row][col])
+                    .clk       (clk),
+                    .rst       (rst),
+                    .clear     (clear_acc),
+                    .enable    (valid_stage1),
+                    .int4_mode (int4_job),
+                    .a_value   (a_stage1[row]),
+                    .b_value   (b_stage1[col]),
+                    .acc_out   (acc_matrix[row][col]),
+                    .acc_hi    (acc_hi_matrix[row][col])
                 );
 
                 if (ACT_FUNC == 1) begin : gen_relu
-                    assign act_matrix[row][col] = acc_matrix[row][col][ACC_WIDTH-1] ? {ACC_WIDTH{1'b0}} : acc_matrix[row][col];
+                    assign act_matrix[row][col]    = acc_matrix[row][col][ACC_WIDTH-1] ? {ACC_WIDTH{1'b0}} : acc_matrix[row][col];
+                    assign act_hi_matrix[row][col] = acc_hi_matrix[row][col][ACC_WIDTH-1] ? {ACC_WIDTH{1'b0}} : acc_hi_matrix[row][col];
                 end else begin : gen_identity
-                    assign act_matrix[row][col] = acc_matrix[row][col];
+                    assign act_matrix[row][col]    = acc_matrix[row][col];
+                    assign act_hi_matrix[row][col] = acc_hi_matrix[row][col];
                 end
             end
         end
@@ -90,8 +152,12 @@ module npu_core #(
             active          <= 1'b0;
             feed_count      <= {COUNT_WIDTH{1'b0}};
             processed_count <= {COUNT_WIDTH{1'b0}};
+            fed_last        <= 1'b0;
+            int4_job        <= 1'b0;
+            tile_computed   <= 1'b0;
             valid_stage0    <= 1'b0;
             valid_stage1    <= 1'b0;
+            valid_acc       <= 1'b0;
             done            <= 1'b0;
             c_valid         <= 1'b0;
             for (i_row = 0; i_row < ARRAY_SIZE; i_row = i_row + 1) begin
@@ -104,115 +170,141 @@ module npu_core #(
             done    <= 1'b0;
             c_valid <= 1'b0;
 
-            if (start && !active && !streaming) begin
+            if (start_accept) begin
                 active          <= 1'b1;
                 feed_count      <= {COUNT_WIDTH{1'b0}};
                 processed_count <= {COUNT_WIDTH{1'b0}};
+                fed_last        <= 1'b0;
+                int4_job        <= (DUAL_INT4 != 0) && int4_mode;
+                tile_computed   <= 1'b0;
                 valid_stage0    <= 1'b0;
                 valid_stage1    <= 1'b0;
+                valid_acc       <= 1'b0;
             end
 
-            if (active) begin
-                if (in_valid && (feed_count < ARRAY_SIZE)) begin
-                    feed_count <= feed_count + {{(COUNT_WIDTH-1){1'b0}}, 1'b1};
+            if (job_feeding) begin
+                if (fifo_pop && fifo_valid) begin
+                    feed_count <= feed_base + {{(COUNT_WIDTH-1){1'b0}}, 1'b1};
+                    fed_last   <= pop_last;
                     for (i_row = 0; i_row < ARRAY_SIZE; i_row = i_row + 1) begin
-                        a_stage0[i_row] <= $signed(a_stream[(i_row*DATA_WIDTH) +: DATA_WIDTH]);
-                        b_stage0[i_row] <= $signed(b_stream[(i_row*DATA_WIDTH) +: DATA_WIDTH]);
+                        a_stage0[i_row] <= $signed(fifo_a[(i_row*DATA_WIDTH) +: DATA_WIDTH]);
+                        b_stage0[i_row] <= $signed(fifo_b[(i_row*DATA_WIDTH) +: DATA_WIDTH]);
                     end
                     valid_stage0 <= 1'b1;
                 end else begin
                     valid_stage0 <= 1'b0;
                 end
 
-                for (i_row = 0; i_row < ARRAY_SIZE; i_row = i_row + 1) begin
-                    a_stage1[i_row] <= a_stage0[i_row];
-                    b_stage1[i_row] <= b_stage0[i_row];
+                // Enable-gated: stage1 and the PE operand inputs only change
+                // behind a valid beat, not on bubble or drain cycles
+                if (valid_stage0) begin
+                    for (i_row = 0; i_row < ARRAY_SIZE; i_row = i_row + 1) begin
+                        a_stage1[i_row] <= a_stage0[i_row];
+                        b_stage1[i_row] <= b_stage0[i_row];
+                    end
                 end
                 valid_stage1 <= valid_stage0;
+                valid_acc    <= valid_stage1;
 
-                if (valid_stage1) begin
+                if (acc_valid) begin
                     processed_count <= processed_count + {{(COUNT_WIDTH-1){1'b0}}, 1'b1};
-                    if (processed_count == ARRAY_SIZE-1) begin
-                        done        <= 1'b1;
-                        c_valid     <= 1'b1;
-                        active      <= 1'b0;
+                end
+
+                // feed_count is final once the last beat has left the FIFO.
+                // The accumulators hold once every beat is in, so done can
+                // wait until the streamer has finished the previous tile.
+                if (last_acc || tile_computed) begin
+                    if (!streaming) begin
+                        done          <= 1'b1;
+                        c_valid       <= 1'b1;
+                        active        <= 1'b0;
+                        tile_computed <= 1'b0;
+                    end else begin
+                        tile_computed <= 1'b1;
                     end
                 end
             end else begin
                 valid_stage0 <= 1'b0;
                 valid_stage1 <= 1'b0;
+                valid_acc    <= 1'b0;
             end
         end
     end
 
-    // Streaming state
-    reg [ROWCOL_WIDTH-1:0] stream_row;
-    reg [ROWCOL_WIDTH-1:0] stream_col;
-    reg [INDEX_WIDTH-1:0]  stream_index;
-    reg                    final_word_pending;
-
-    // Launch streaming whenever computation finishes
-    always @(posedge clk) begin
-        if (rst) begin
-            streaming          <= 1'b0;
-            result_valid       <= 1'b0;
-            result_data        <= {ACC_WIDTH{1'b0}};
-            result_index       <= {INDEX_WIDTH{1'b0}};
-            stream_row         <= {ROWCOL_WIDTH{1'b0}};
-            stream_col         <= {ROWCOL_WIDTH{1'b0}};
-            stream_index       <= {INDEX_WIDTH{1'b0}};
-            final_word_pending <= 1'b0;
-        end else begin
-            if (done) begin
-                streaming          <= 1'b1;
-                stream_row         <= {ROWCOL_WIDTH{1'b0}};
-                stream_col         <= {ROWCOL_WIDTH{1'b0}};
-                stream_index       <= {INDEX_WIDTH{1'b0}};
-                final_word_pending <= 1'b0;
-                result_valid       <= 1'b0;
-            end
-
-            if (streaming) begin
-                if (!result_valid || (result_valid && result_ready)) begin
-                    result_valid <= 1'b1;
-                    result_data  <= act_matrix[stream_row][stream_col];
-                    result_index <= stream_index;
+    // Stream the activated tile once computation finishes. In int4 mode the
+    // tile is ARRAY_SIZE x 2*ARRAY_SIZE: lane col of b_stream feeds output
+    // columns 2*col (low weight) and 2*col+1 (high weight).
+    wire [STREAM_COUNT*ACC_WIDTH-1:0] stream_flat;
+    wire [STREAM_COUNT*ACC_WIDTH-1:0] stream_src;
+    wire                              stream_int4;
+    wire [INDEX_WIDTH-1:0]            stream_last_index = stream_int4 ? STREAM_COUNT - 1 : OUTPUT_COUNT - 1;
 
-                    if (stream_index == OUTPUT_COUNT-1) begin
-                        final_word_pending <= 1'b1;
-                    end else begin
-                        final_word_pending <= 1'b0;
-                        stream_index <= stream_index + {{(INDEX_WIDTH-1){1'b0}}, 1'b1};
-                        if (stream_col == ARRAY_SIZE-1) begin
-                            stream_col <= {ROWCOL_WIDTH{1'b0}};
-                            stream_row <= stream_row + {{(ROWCOL_WIDTH-1){1'b0}}, 1'b1};
-                        end else begin
-                            stream_col <= stream_col + {{(ROWCOL_WIDTH-1){1'b0}}, 1'b1};
-                        end
-                    end
-                end
+    // BACK_TO_BACK: the streamer works from a copy taken at done, so the
+    // next job may clear and refill the accumulators meanwhile
+    generate
+        if (BACK_TO_BACK != 0) begin : gen_stream_snapshot
+            reg [STREAM_COUNT*ACC_WIDTH-1:0] snapshot;
+            reg                              snapshot_int4;
 
-                if (final_word_pending && result_valid && result_ready) begin
-                    streaming          <= 1'b0;
-                    result_valid       <= 1'b0;
-                    final_word_pending <= 1'b0;
+            always @(posedge clk) begin
+                if (rst) begin
+                    snapshot      <= {(STREAM_COUNT*ACC_WIDTH){1'b0}};
+                    snapshot_int4 <= 1'b0;
+                end else if (done) begin
+                    snapshot      <= stream_flat;
+                    snapshot_int4 <= int4_job;
                 end
-            end else begin
-                if (result_valid && result_ready) begin
-                    result_valid <= 1'b0;
-                end
-                final_word_pending <= 1'b0;
             end
+
+            assign stream_src  = snapshot;
+            assign stream_int4 = snapshot_int4;
+        end else begin : gen_stream_live
+            assign stream_src  = stream_flat;
+            assign stream_int4 = int4_job;
         end
-    end
+    endgenerate
+
+    npu_result_stream #(
+        .ACC_WIDTH    (ACC_WIDTH),
+        .OUTPUT_COUNT (STREAM_COUNT),
+        .INDEX_WIDTH  (INDEX_WIDTH),
+        .SPARSE       (SPARSE_STREAM)
+    ) u_stream (
+        .clk          (clk),
+        .rst          (rst),
+        .launch       (done),
+        .last_index   (stream_last_index),
+        .act_flat     (stream_src),
+        .streaming    (streaming),
+        .result_valid (result_valid),
+        .result_data  (result_data),
+        .result_index (result_index),
+        .result_last  (result_last),
+        .result_ready (result_ready)
+    );
 
     // Flatten activated matrix into packed bus
     generate
         for (row = 0; row < ARRAY_SIZE; row = row + 1) begin : gen_flatten_rows
             for (col = 0; col < ARRAY_SIZE; col = col + 1) begin : gen_flatten_cols
                 localparam integer idx = (row*ARRAY_SIZE) + col;
-                assign c_out_flat[(idx+1)*ACC_WIDTH-1 : idx*ACC_WIDTH] = act_matrix[row][col];
+                assign c_out_flat[(idx+1)*ACC_WIDTH-1 : idx*ACC_WIDTH]    = act_matrix[row][col];
+                assign c_out_hi_flat[(idx+1)*ACC_WIDTH-1 : idx*ACC_WIDTH] = act_hi_matrix[row][col];
+            end
+        end
+
+        if (DUAL_INT4 != 0) begin : gen_pair_stream
+            for (row = 0; row < ARRAY_SIZE; row = row + 1) begin : gen_pair_rows
+                for (col = 0; col < ARRAY_SIZE; col = col + 1) begin : gen_pair_cols
+                    localparam integer lo_idx = (row*2*ARRAY_SIZE) + (2*col);
+                    assign stream_flat[lo_idx*ACC_WIDTH +: ACC_WIDTH] =
+                        int4_job ? act_matrix[row][col] : c_out_flat[(lo_idx % OUTPUT_COUNT)*ACC_WIDTH +: ACC_WIDTH];
+                    assign stream_flat[(lo_idx+1)*ACC_WIDTH +: ACC_WIDTH] =
+                        int4_job ? act_hi_matrix[row][col] : c_out_flat[((lo_idx+1) % OUTPUT_COUNT)*ACC_WIDTH +: ACC_WIDTH];
+                end
             end
+        end else begin : gen_single_stream
+            assign stream_flat = c_out_flat;
         end
     endgenerate
 
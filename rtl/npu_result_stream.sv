@@ -0,0 +1,97 @@
+// Result streaming FSM shared by the NPU core variants
+// Walks the activated output tile in row-major order with ready/valid handshaking,
+// stopping after word last_index (sampled while streaming, at most OUTPUT_COUNT-1)
+//
+// With SPARSE = 1 only non-zero words are emitted, each with its result_index.
+// Word last_index is always emitted, zero or not, and result_last marks it as
+// the end of the tile; the consumer treats every index it did not see as zero.
+module npu_result_stream #(
+    parameter integer ACC_WIDTH    = 20,
+    parameter integer OUTPUT_COUNT = 16,
+    parameter integer INDEX_WIDTH  = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1,
+    parameter integer SPARSE       = 0
+) (
+    input                               clk,
+    input                               rst,
+    input                               launch,
+    input      [INDEX_WIDTH-1:0]        last_index,
+    input      [OUTPUT_COUNT*ACC_WIDTH-1:0] act_flat,
+    output reg                          streaming,
+    output reg                          result_valid,
+    output reg  [ACC_WIDTH-1:0]         result_data,
+    output reg  [INDEX_WIDTH-1:0]       result_index,
+    output reg                          result_last,
+    input                               result_ready
+);
+
+    reg [INDEX_WIDTH-1:0] stream_index;
+    reg                   final_word_pending;
+
+    // Next word to emit: stream_index itself, or in sparse mode the first
+    // non-zero word (or last_index) at or after it
+    reg [INDEX_WIDTH-1:0] emit_index;
+    integer               scan;
+
+    always @(*) begin
+        emit_index = stream_index;
+        if (SPARSE != 0) begin
+            emit_index = last_index;
+            for (scan = OUTPUT_COUNT-1; scan >= 0; scan = scan - 1) begin
+                if ((scan >= stream_index) && (scan < last_index) &&
+                    (act_flat[scan*ACC_WIDTH +: ACC_WIDTH] != {ACC_WIDTH{1'b0}})) begin
+                    emit_index = scan;
+                end
+            end
+        end
+    end
+
+    // Launch streaming whenever computation finishes
+    always @(posedge clk) begin
+        if (rst) begin
+            streaming          <= 1'b0;
+            result_valid       <= 1'b0;
+            result_data        <= {ACC_WIDTH{1'b0}};
+            result_index       <= {INDEX_WIDTH{1'b0}};
+            result_last        <= 1'b0;
+            stream_index       <= {INDEX_WIDTH{1'b0}};
+            final_word_pending <= 1'b0;
+        end else begin
+            if (launch) begin
+                streaming          <= 1'b1;
+                stream_index       <= {INDEX_WIDTH{1'b0}};
+                final_word_pending <= 1'b0;
+                result_valid       <= 1'b0;
+            end
+
+            if (streaming) begin
+                if (!result_valid || (result_valid && result_ready)) begin
+                    result_valid <= 1'b1;
+                    result_data  <= act_flat[emit_index*ACC_WIDTH +: ACC_WIDTH];
+                    result_index <= emit_index;
+                    result_last  <= (emit_index == last_index);
+
+                    if (emit_index == last_index) begin
+                        final_word_pending <= 1'b1;
+                    end else begin
+                        final_word_pending <= 1'b0;
+                        stream_index <= emit_index + {{(INDEX_WIDTH-1){1'b0}}, 1'b1};
+                    end
+                end
+
+                if (final_word_pending && result_valid && result_ready) begin
+                    streaming          <= 1'b0;
+                    result_valid       <= 1'b0;
+                    result_last        <= 1'b0;
+                    final_word_pending <= 1'b0;
+                end
+            end else begin
+                if (result_valid && result_ready) begin
+                    result_valid <= 1'b0;
+                    result_last  <= 1'b0;
+                end
+                final_word_pending <= 1'b0;
+            end
+        end
+    end
+
+endmodule
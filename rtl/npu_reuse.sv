@@ -0,0 +1,157 @@
+// Operand reuse front end for npu_core
+// The host loads one A panel (up to MAX_K columns, one per beat) into a small
+// operand SRAM, then streams only B panels. Each run of panel_len B rows is
+// one job. Every B beat is paired with the resident A column of the same k,
+// so the A panel crosses the host link once for the whole row of output tiles.
+//
+// Jobs are started automatically: a job is queued when its first B beat is
+// accepted, and started once the core is idle. A new A panel may be loaded
+// between B panels. Beats already read out of the SRAM keep their operands,
+// so the load does not wait for queued jobs to finish.
+module npu_reuse #(
+    parameter integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE,
+    parameter integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH,
+    parameter integer MAX_K           = npu_config_pkg::NPU_MAX_K,
+    parameter integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS,
+    parameter integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS,
+    parameter integer ACT_FUNC        = 0,
+    parameter integer FIFO_DEPTH      = 2 * ARRAY_SIZE,
+    parameter integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE,
+    parameter integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1
+) (
+    input                               clk,
+    input                               rst,
+    input                               a_load_valid,
+    output                              a_load_ready, // high between B panels
+    input      [ARRAY_SIZE*DATA_WIDTH-1:0] a_load_data, // column k of the A panel
+    input                               a_load_last,
+    input                               b_valid,
+    output                              b_ready,
+    input      [ARRAY_SIZE*DATA_WIDTH-1:0] b_data,      // row k of the current B panel
+    output reg                          panel_loaded,
+    output                              busy,
+    output                              done,
+    output                              result_valid,
+    output     [ACC_WIDTH-1:0]          result_data,
+    output     [INDEX_WIDTH-1:0]        result_index,
+    output                              result_last,
+    input                               result_ready
+);
+
+    localparam integer ADDR_WIDTH    = (MAX_K > 1) ? $clog2(MAX_K) : 1;
+    localparam integer COUNT_WIDTH   = $clog2(MAX_K + 1);
+    localparam integer PENDING_WIDTH = $clog2(FIFO_DEPTH + 3);
+
+    // Operand SRAM: synchronous read, one A column per word
+    reg [ARRAY_SIZE*DATA_WIDTH-1:0] panel_mem [0:MAX_K-1];
+    reg [COUNT_WIDTH-1:0]           panel_len;
+    reg [COUNT_WIDTH-1:0]           load_count;
+    reg [ADDR_WIDTH-1:0]            b_index;   // k of the next B beat in this panel
+
+    // Read stage between the SRAM and the core's operand FIFO
+    reg                             pipe_valid;
+    reg                             pipe_last;
+    reg [ARRAY_SIZE*DATA_WIDTH-1:0] pipe_a;
+    reg [ARRAY_SIZE*DATA_WIDTH-1:0] pipe_b;
+
+    reg [PENDING_WIDTH-1:0]         jobs_pending;
+
+    wire core_in_ready;
+    wire core_busy;
+    wire core_done;
+
+    assign a_load_ready = (b_index == {ADDR_WIDTH{1'b0}});
+
+    wire load_fire = a_load_valid && a_load_ready;
+    // A load takes priority over the first beat of the next B panel
+    assign b_ready = panel_loaded && !load_fire && (!pipe_valid || core_in_ready);
+    wire b_fire    = b_valid && b_ready;
+    wire b_last    = (b_index == panel_len - 1'b1);
+
+    wire core_start = (jobs_pending != {PENDING_WIDTH{1'b0}}) && !core_busy && !core_done;
+
+    assign busy = core_busy || pipe_valid || (jobs_pending != {PENDING_WIDTH{1'b0}}) ||
+                  (b_index != {ADDR_WIDTH{1'b0}});
+    assign done = core_done;
+
+    always @(posedge clk) begin
+        if (load_fire) begin
+            panel_mem[load_count[ADDR_WIDTH-1:0]] <= a_load_data;
+        end
+        if (b_fire) begin
+            pipe_a <= panel_mem[b_index];
+            pipe_b <= b_data;
+        end
+    end
+
+    always @(posedge clk) begin
+        if (rst) begin
+            panel_loaded <= 1'b0;
+            panel_len    <= {COUNT_WIDTH{1'b0}};
+            load_count   <= {COUNT_WIDTH{1'b0}};
+            b_index      <= {ADDR_WIDTH{1'b0}};
+            pipe_valid   <= 1'b0;
+            pipe_last    <= 1'b0;
+            jobs_pending <= {PENDING_WIDTH{1'b0}};
+        end else begin
+            if (load_fire) begin
+                if (a_load_last || load_count == MAX_K-1) begin
+                    panel_loaded <= 1'b1;
+                    panel_len    <= load_count + 1'b1;
+                    load_count   <= {COUNT_WIDTH{1'b0}};
+                end else begin
+                    panel_loaded <= 1'b0;
+                    load_count   <= load_count + 1'b1;
+                end
+            end
+
+            if (b_fire) begin
+                pipe_valid <= 1'b1;
+                pipe_last  <= b_last;
+                b_index    <= b_last ? {ADDR_WIDTH{1'b0}} : b_index + 1'b1;
+            end else if (core_in_ready) begin
+                pipe_valid <= 1'b0;
+            end
+
+            // One job per B panel, queued on its first beat
+            if ((b_fire && b_index == {ADDR_WIDTH{1'b0}}) && !core_start) begin
+                jobs_pending <= jobs_pending + 1'b1;
+            end else if (!(b_fire && b_index == {ADDR_WIDTH{1'b0}}) && core_start) begin
+                jobs_pending <= jobs_pending - 1'b1;
+            end
+        end
+    end
+
+    npu_core #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (MAX_K),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACC_WIDTH      (ACC_WIDTH),
+        .ACT_FUNC       (ACT_FUNC),
+        .FIFO_DEPTH     (FIFO_DEPTH),
+        .OUTPUT_COUNT   (OUTPUT_COUNT),
+        .INDEX_WIDTH    (INDEX_WIDTH)
+    ) u_core (
+        .clk           (clk),
+        .rst           (rst),
+        .start         (core_start),
+        .int4_mode     (1'b0),
+        .in_valid      (pipe_valid),
+        .in_ready      (core_in_ready),
+        .in_last       (pipe_last),
+        .a_stream      (pipe_a),
+        .b_stream      (pipe_b),
+        .busy          (core_busy),
+        .done          (core_done),
+        .c_valid       (),
+        .c_out_flat    (),
+        .c_out_hi_flat (),
+        .result_valid  (result_valid),
+        .result_data   (result_data),
+        .result_index  (result_index),
+        .result_last   (result_last),
+        .result_ready  (result_ready)
+    );
+
+endmodule
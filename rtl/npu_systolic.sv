@@ -0,0 +1,292 @@
+// Systolic-array NPU core with neighbor-to-neighbor operand forwarding
+// Drop-in alternative to npu_core: same stream and result interface, but
+// operands are skewed at the array edge and hop one PE per cycle instead of
+// being broadcast, so per-net fanout stays constant as ARRAY_SIZE grows.
+// The cost is 2*(ARRAY_SIZE-1) extra cycles of fill/drain latency per tile.
+module npu_systolic #(
+    parameter integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE,
+    parameter integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH,
+    parameter integer MAX_K           = npu_config_pkg::NPU_MAX_K, // longest accumulation, in beats per job
+    parameter integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS,
+    parameter integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS,
+    parameter integer ACT_FUNC        = 0, // 0 = identity, 1 = ReLU
+    parameter integer SPARSE_STREAM   = 0, // 1 = stream only non-zero results + end marker
+    parameter integer FIFO_DEPTH      = 2 * ARRAY_SIZE, // operand beats buffered ahead of the array
+    parameter integer PE_PIPELINE     = 0, // 1 = register PE products before accumulation
+    parameter integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE,
+    parameter integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1
+) (
+    input                               clk,
+    input                               rst,
+    input                               start,
+    input                               in_valid,
+    output                              in_ready,
+    input                               in_last,
+    input      [ARRAY_SIZE*DATA_WIDTH-1:0] a_stream,
+    input      [ARRAY_SIZE*DATA_WIDTH-1:0] b_stream,
+    output                              busy,
+    output reg                          done,
+    output reg                          c_valid,
+    output     [OUTPUT_COUNT*ACC_WIDTH-1:0] c_out_flat,
+    output                              result_valid,
+    output      [ACC_WIDTH-1:0]         result_data,
+    output      [INDEX_WIDTH-1:0]       result_index,
+    output                              result_last,
+    input                               result_ready
+);
+
+    localparam integer COUNT_WIDTH   = (MAX_K > 1) ? $clog2(MAX_K + 1) : 1;
+    localparam integer MIN_ACC_WIDTH = (2*DATA_WIDTH) + $clog2(MAX_K);
+
+    initial begin
+        if (ACC_WIDTH < MIN_ACC_WIDTH) begin
+            $error("ACC_WIDTH (%0d) is insufficient. Minimum required is %0d for MAX_K=%0d DATA_WIDTH=%0d",
+                   ACC_WIDTH, MIN_ACC_WIDTH, MAX_K, DATA_WIDTH);
+        end
+    end
+
+    reg  active;
+    wire streaming;
+    reg [COUNT_WIDTH-1:0] feed_count;
+    reg [COUNT_WIDTH-1:0] processed_count;
+    reg                   fed_last;
+
+    reg signed [DATA_WIDTH-1:0] a_stage0 [0:ARRAY_SIZE-1];
+    reg signed [DATA_WIDTH-1:0] b_stage0 [0:ARRAY_SIZE-1];
+    reg valid_stage0;
+
+    // Operand FIFO: beats are accepted whenever in_ready is high, including
+    // before start, and drained into stage0 one per cycle while active.
+    // A job ends at the beat tagged in_last, or implicitly after MAX_K beats.
+    wire                                fifo_valid;
+    wire [2*ARRAY_SIZE*DATA_WIDTH:0]    fifo_data;
+    wire [ARRAY_SIZE*DATA_WIDTH-1:0]    fifo_a   = fifo_data[0 +: ARRAY_SIZE*DATA_WIDTH];
+    wire [ARRAY_SIZE*DATA_WIDTH-1:0]    fifo_b   = fifo_data[ARRAY_SIZE*DATA_WIDTH +: ARRAY_SIZE*DATA_WIDTH];
+    wire                                fifo_pop = active && !fed_last;
+    wire                                pop_last = fifo_data[2*ARRAY_SIZE*DATA_WIDTH] || (feed_count == MAX_K-1);
+
+    operand_fifo #(
+        .WIDTH (2*ARRAY_SIZE*DATA_WIDTH + 1),
+        .DEPTH (FIFO_DEPTH)
+    ) u_operand_fifo (
+        .clk       (clk),
+        .rst       (rst),
+        .push      (in_valid),
+        .push_data ({in_last, b_stream, a_stream}),
+        .in_ready  (in_ready),
+        .pop       (fifo_pop),
+        .pop_data  (fifo_data),
+        .out_valid (fifo_valid),
+        .count     ()
+    );
+
+    // Input skew: row i of A and column j of B are delayed by i+1 / j+1 cycles.
+    // Slot 0 of each delay line plays the role of npu_core's stage1 register.
+    reg signed [DATA_WIDTH-1:0] a_skew [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg signed [DATA_WIDTH-1:0] b_skew [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg                         v_skew [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+
+    // Forwarding registers: A and its valid move right, B moves down
+    reg signed [DATA_WIDTH-1:0] a_fwd [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg signed [DATA_WIDTH-1:0] b_fwd [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg                         v_fwd [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+
+    wire signed [DATA_WIDTH-1:0] a_in [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    wire signed [DATA_WIDTH-1:0] b_in [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    wire                         v_in [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+
+    wire clear_acc = start;
+
+    wire signed [ACC_WIDTH-1:0] acc_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    wire signed [ACC_WIDTH-1:0] act_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+
+    // The bottom-right PE sees each beat last, so it defines completion;
+    // with PE_PIPELINE its accumulate lands one cycle after the beat arrives
+    wire corner_valid = v_in[ARRAY_SIZE-1][ARRAY_SIZE-1];
+    reg  corner_valid_q;
+    wire corner_acc   = (PE_PIPELINE != 0) ? corner_valid_q : corner_valid;
+
+    assign busy = active | streaming;
+
+    genvar row;
+    genvar col;
+    generate
+        for (row = 0; row < ARRAY_SIZE; row = row + 1) begin : gen_rows
+            for (col = 0; col < ARRAY_SIZE; col = col + 1) begin : gen_cols
+                if (col == 0) begin : gen_a_edge
+                    assign a_in[row][col] = a_skew[row][row];
+                    assign v_in[row][col] = v_skew[row][row];
+                end else begin : gen_a_link
+                    assign a_in[row][col] = a_fwd[row][col-1];
+                    assign v_in[row][col] = v_fwd[row][col-1];
+                end
+
+                if (row == 0) begin : gen_b_edge
+                    assign b_in[row][col] = b_skew[col][col];
+                end else begin : gen_b_link
+                    assign b_in[row][col] = b_fwd[row-1][col];
+                end
+
+                always @(posedge clk) begin
+                    if (rst) begin
+                        a_fwd[row][col] <= {DATA_WIDTH{1'b0}};
+                        b_fwd[row][col] <= {DATA_WIDTH{1'b0}};
+                        v_fwd[row][col] <= 1'b0;
+                    end else begin
+                        // Operands only hop behind a valid beat; a and b of
+                        // one beat meet at each PE, so v_in gates both
+                        if (v_in[row][col]) begin
+                            a_fwd[row][col] <= a_in[row][col];
+                            b_fwd[row][col] <= b_in[row][col];
+                        end
+                        v_fwd[row][col] <= v_in[row][col];
+                    end
+                end
+
+                pe #(
+                    .DATA_WIDTH (DATA_WIDTH),
+                    .ACC_WIDTH  (ACC_WIDTH),
+                    .PE_PIPELINE(PE_PIPELINE)
+                ) u_pe (
+                    .clk       (clk),
+                    .rst       (rst),
+                    .clear     (clear_acc),
+                    .enable    (v_in[row][col]),
+                    .int4_mode (1'b0),
+                    .a_value   (a_in[row][col]),
+                    .b_value   (b_in[row][col]),
+                    .acc_out   (acc_matrix[row][col]),
+                    .acc_hi    ()
+                );
+
+                if (ACT_FUNC == 1) begin : gen_relu
+                    assign act_matrix[row][col] = acc_matrix[row][col][ACC_WIDTH-1] ? {ACC_WIDTH{1'b0}} : acc_matrix[row][col];
+                end else begin : gen_identity
+                    assign act_matrix[row][col] = acc_matrix[row][col];
+                end
+            end
+        end
+    endgenerate
+
+    integer i_row;
+    integer i_dly;
+
+    // Edge skew delay lines run freely so the array keeps draining after the
+    // last beat. Only the valid bits shift every cycle; an operand slot loads
+    // when the valid bit entering it is set.
+    always @(posedge clk) begin
+        if (rst) begin
+            for (i_row = 0; i_row < ARRAY_SIZE; i_row = i_row + 1) begin
+                for (i_dly = 0; i_dly < ARRAY_SIZE; i_dly = i_dly + 1) begin
+                    a_skew[i_row][i_dly] <= {DATA_WIDTH{1'b0}};
+                    b_skew[i_row][i_dly] <= {DATA_WIDTH{1'b0}};
+                    v_skew[i_row][i_dly] <= 1'b0;
+                end
+            end
+        end else begin
+            for (i_row = 0; i_row < ARRAY_SIZE; i_row = i_row + 1) begin
+                if (valid_stage0) begin
+                    a_skew[i_row][0] <= a_stage0[i_row];
+                    b_skew[i_row][0] <= b_stage0[i_row];
+                end
+                v_skew[i_row][0] <= valid_stage0;
+                for (i_dly = 1; i_dly < ARRAY_SIZE; i_dly = i_dly + 1) begin
+                    if (v_skew[i_row][i_dly-1]) begin
+                        a_skew[i_row][i_dly] <= a_skew[i_row][i_dly-1];
+                        b_skew[i_row][i_dly] <= b_skew[i_row][i_dly-1];
+                    end
+                    v_skew[i_row][i_dly] <= v_skew[i_row][i_dly-1];
+                end
+            end
+        end
+    end
+
+    // Operand capture and completion tracking
+    always @(posedge clk) begin
+        if (rst) begin
+            active          <= 1'b0;
+            feed_count      <= {COUNT_WIDTH{1'b0}};
+            processed_count <= {COUNT_WIDTH{1'b0}};
+            fed_last        <= 1'b0;
+            valid_stage0    <= 1'b0;
+            corner_valid_q  <= 1'b0;
+            done            <= 1'b0;
+            c_valid         <= 1'b0;
+            for (i_row = 0; i_row < ARRAY_SIZE; i_row = i_row + 1) begin
+                a_stage0[i_row] <= {DATA_WIDTH{1'b0}};
+                b_stage0[i_row] <= {DATA_WIDTH{1'b0}};
+            end
+        end else begin
+            done           <= 1'b0;
+            c_valid        <= 1'b0;
+            corner_valid_q <= corner_valid;
+
+            if (start && !active && !streaming) begin
+                active          <= 1'b1;
+                feed_count      <= {COUNT_WIDTH{1'b0}};
+                processed_count <= {COUNT_WIDTH{1'b0}};
+                fed_last        <= 1'b0;
+                valid_stage0    <= 1'b0;
+            end
+
+            if (active) begin
+                if (fifo_pop && fifo_valid) begin
+                    feed_count <= feed_count + {{(COUNT_WIDTH-1){1'b0}}, 1'b1};
+                    fed_last   <= pop_last;
+                    for (i_row = 0; i_row < ARRAY_SIZE; i_row = i_row + 1) begin
+                        a_stage0[i_row] <= $signed(fifo_a[(i_row*DATA_WIDTH) +: DATA_WIDTH]);
+                        b_stage0[i_row] <= $signed(fifo_b[(i_row*DATA_WIDTH) +: DATA_WIDTH]);
+                    end
+                    valid_stage0 <= 1'b1;
+                end else begin
+                    valid_stage0 <= 1'b0;
+                end
+
+                if (corner_acc) begin
+                    processed_count <= processed_count + {{(COUNT_WIDTH-1){1'b0}}, 1'b1};
+                    // feed_count is final once the last beat has left the FIFO
+                    if (fed_last && (processed_count + 1'b1 == feed_count)) begin
+                        done        <= 1'b1;
+                        c_valid     <= 1'b1;
+                        active      <= 1'b0;
+                    end
+                end
+            end else begin
+                valid_stage0 <= 1'b0;
+            end
+        end
+    end
+
+    // Stream the activated tile once computation finishes
+    wire [INDEX_WIDTH-1:0] stream_last_index = OUTPUT_COUNT - 1;
+
+    npu_result_stream #(
+        .ACC_WIDTH    (ACC_WIDTH),
+        .OUTPUT_COUNT (OUTPUT_COUNT),
+        .INDEX_WIDTH  (INDEX_WIDTH),
+        .SPARSE       (SPARSE_STREAM)
+    ) u_stream (
+        .clk          (clk),
+        .rst          (rst),
+        .launch       (done),
+        .last_index   (stream_last_index),
+        .act_flat     (c_out_flat),
+        .streaming    (streaming),
+        .result_valid (result_valid),
+        .result_data  (result_data),
+        .result_index (result_index),
+        .result_last  (result_last),
+        .result_ready (result_ready)
+    );
+
+    // Flatten activated matrix into packed bus
+    generate
+        for (row = 0; row < ARRAY_SIZE; row = row + 1) begin : gen_flatten_rows
+            for (col = 0; col < ARRAY_SIZE; col = col + 1) begin : gen_flatten_cols
+                localparam integer idx = (row*ARRAY_SIZE) + col;
+                assign c_out_flat[(idx+1)*ACC_WIDTH-1 : idx*ACC_WIDTH] = act_matrix[row][col];
+            end
+        end
+    endgenerate
+
+endmodule
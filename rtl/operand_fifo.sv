@@ -0,0 +1,61 @@
+// Operand-side FIFO in front of the NPU stage0 registers
+// Fall-through: when empty, a pushed beat is visible on pop_data in the same
+// cycle, so a host streaming at full rate sees no added latency. in_ready is
+// derived from the registered occupancy only (no combinational path from pop).
+module operand_fifo #(
+    parameter integer WIDTH = 64,
+    parameter integer DEPTH = 8,
+    parameter integer COUNT_WIDTH = $clog2(DEPTH + 1)
+) (
+    input                    clk,
+    input                    rst,
+    input                    push,
+    input      [WIDTH-1:0]   push_data,
+    output                   in_ready,
+    input                    pop,
+    output     [WIDTH-1:0]   pop_data,
+    output                   out_valid,
+    output reg [COUNT_WIDTH-1:0] count
+);
+
+    localparam integer PTR_WIDTH = (DEPTH > 1) ? $clog2(DEPTH) : 1;
+
+    reg [WIDTH-1:0]     mem [0:DEPTH-1];
+    reg [PTR_WIDTH-1:0] rd_ptr;
+    reg [PTR_WIDTH-1:0] wr_ptr;
+
+    wire empty    = (count == {COUNT_WIDTH{1'b0}});
+    wire accepted = push && in_ready;
+    wire bypass   = empty && accepted;
+
+    assign in_ready  = (count < DEPTH);
+    assign out_valid = !empty || accepted;
+    assign pop_data  = empty ? push_data : mem[rd_ptr];
+
+    wire do_pop  = pop && out_valid;
+    // A beat that bypasses straight to the consumer is never stored
+    wire do_push = accepted && !(bypass && pop);
+
+    always @(posedge clk) begin
+        if (rst) begin
+            rd_ptr <= {PTR_WIDTH{1'b0}};
+            wr_ptr <= {PTR_WIDTH{1'b0}};
+            count  <= {COUNT_WIDTH{1'b0}};
+        end else begin
+            if (do_push) begin
+                mem[wr_ptr] <= push_data;
+                wr_ptr      <= (wr_ptr == DEPTH-1) ? {PTR_WIDTH{1'b0}} : wr_ptr + 1'b1;
+            end
+            if (do_pop && !bypass) begin
+                rd_ptr <= (rd_ptr == DEPTH-1) ? {PTR_WIDTH{1'b0}} : rd_ptr + 1'b1;
+            end
+
+            if (do_push && !(do_pop && !bypass)) begin
+                count <= count + 1'b1;
+            end else if (!do_push && do_pop && !bypass) begin
+                count <= count - 1'b1;
+            end
+        end
+    end
+
+endmodule
@@ -1,32 +1,129 @@
 // Processing element for the pipelined NPU outer-product stage
 // Performs an enable-gated multiply-accumulate on broadcast operands
+//
+// With DUAL_INT4 = 1 the PE can also run in int4 mode: b_value then carries
+// two signed DATA_WIDTH/2-bit weights (low half for acc_out, high half for
+// acc_hi), so each cycle performs two MACs against the same activation.
+//
+// With PE_PIPELINE = 1 the products are registered before the accumulate,
+// splitting the multiply and the ACC_WIDTH add onto separate cycles; acc_out
+// then reflects an enabled beat one cycle later.
 module pe #(
-    parameter DATA_WIDTH = 8,
-    parameter ACC_WIDTH  = 24
+    parameter DATA_WIDTH  = 8,
+    parameter ACC_WIDTH   = 24,
+    parameter DUAL_INT4   = 0,
+    parameter PE_PIPELINE = 0
 ) (
     input                       clk,
     input                       rst,
     input                       clear,
     input                       enable,
+    input                       int4_mode,
     input      signed [DATA_WIDTH-1:0] a_value,
     input      signed [DATA_WIDTH-1:0] b_value,
-    output reg signed [ACC_WIDTH-1:0]  acc_out
+    output reg signed [ACC_WIDTH-1:0]  acc_out,
+    output reg signed [ACC_WIDTH-1:0]  acc_hi
 );
 
+    localparam integer HALF_WIDTH = DATA_WIDTH / 2;
+
+    wire                             pair_mode = (DUAL_INT4 != 0) && int4_mode;
+    wire signed [HALF_WIDTH-1:0]     b_lo      = b_value[HALF_WIDTH-1:0];
+    wire signed [HALF_WIDTH-1:0]     b_hi      = b_value[DATA_WIDTH-1:HALF_WIDTH];
+    wire signed [DATA_WIDTH-1:0]     b_main    = pair_mode ? {{(DATA_WIDTH-HALF_WIDTH){b_lo[HALF_WIDTH-1]}}, b_lo} : b_value;
+
     wire signed [(2*DATA_WIDTH)-1:0] product;
     wire signed [ACC_WIDTH-1:0]      product_ext;
 
-    assign product     = a_value * b_value;
+    assign product     = a_value * b_main;
     assign product_ext = {{(ACC_WIDTH-(2*DATA_WIDTH)){product[(2*DATA_WIDTH)-1]}}, product};
 
+    // Accumulate-side view of the product: combinational or one register later
+    wire                             acc_enable;
+    wire                             acc_pair_mode;
+    wire signed [ACC_WIDTH-1:0]      acc_product;
+
+    generate
+        if (PE_PIPELINE != 0) begin : gen_product_reg
+            reg                             enable_q;
+            reg                             pair_mode_q;
+            reg signed [(2*DATA_WIDTH)-1:0] product_q;
+
+            always @(posedge clk) begin
+                if (rst || clear) begin
+                    enable_q    <= 1'b0;
+                    pair_mode_q <= 1'b0;
+                    product_q   <= 0;
+                end else begin
+                    enable_q    <= enable;
+                    pair_mode_q <= pair_mode;
+                    if (enable) begin
+                        product_q <= product;
+                    end
+                end
+            end
+
+            assign acc_enable    = enable_q;
+            assign acc_pair_mode = pair_mode_q;
+            assign acc_product   = {{(ACC_WIDTH-(2*DATA_WIDTH)){product_q[(2*DATA_WIDTH)-1]}}, product_q};
+        end else begin : gen_product_comb
+            assign acc_enable    = enable;
+            assign acc_pair_mode = pair_mode;
+            assign acc_product   = product_ext;
+        end
+    endgenerate
+
     always @(posedge clk) begin
         if (rst) begin
             acc_out <= 0;
         end else if (clear) begin
             acc_out <= 0;
-        end else if (enable) begin
-            acc_out <= acc_out + product_ext;
+        end else if (acc_enable) begin
+            acc_out <= acc_out + acc_product;
         end
     end
 
+    generate
+        if (DUAL_INT4 != 0) begin : gen_dual_int4
+            // Second, narrower multiplier for the high weight of the pair
+            wire signed [DATA_WIDTH+HALF_WIDTH-1:0] product_hi;
+            wire signed [ACC_WIDTH-1:0]             product_hi_ext;
+
+            wire signed [ACC_WIDTH-1:0]             acc_product_hi;
+
+            assign product_hi     = a_value * b_hi;
+            assign product_hi_ext = {{(ACC_WIDTH-(DATA_WIDTH+HALF_WIDTH)){product_hi[DATA_WIDTH+HALF_WIDTH-1]}}, product_hi};
+
+            if (PE_PIPELINE != 0) begin : gen_product_hi_reg
+                reg signed [DATA_WIDTH+HALF_WIDTH-1:0] product_hi_q;
+
+                always @(posedge clk) begin
+                    if (rst || clear) begin
+                        product_hi_q <= 0;
+                    end else if (enable) begin
+                        product_hi_q <= product_hi;
+                    end
+                end
+
+                assign acc_product_hi = {{(ACC_WIDTH-(DATA_WIDTH+HALF_WIDTH)){product_hi_q[DATA_WIDTH+HALF_WIDTH-1]}}, product_hi_q};
+            end else begin : gen_product_hi_comb
+                assign acc_product_hi = product_hi_ext;
+            end
+
+            always @(posedge clk) begin
+                if (rst) begin
+                    acc_hi <= 0;
+                end else if (clear) begin
+                    acc_hi <= 0;
+                end else if (acc_enable && acc_pair_mode) begin
+                    acc_hi <= acc_hi + acc_product_hi;
+                end
+            end
+        end else begin : gen_single
+            always @(posedge clk) begin
+                acc_hi <= 0;
+            end
+        end
+    endgenerate
+
 endmodule
@@ -0,0 +1,68 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "npu_config.hpp"
+
+// Writes the SystemVerilog parameter package for an NPU build. Without
+// options it regenerates rtl/npu_config_pkg.sv from kNpuParams. Design-space
+// sweeps can override any field to emit a matched package for each point:
+//   gen_config_pkg --array-size=8 --max-k=64 --out=build/npu_config_pkg.sv
+int main(int argc, char** argv) {
+    npu::NpuParams params = npu::kNpuParams;
+    std::string out_path = "rtl/npu_config_pkg.sv";
+    bool array_size_given = false;
+    bool max_k_given = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg.substr(0, 13) == "--array-size=") {
+            params.array_size = std::stoi(arg.substr(13));
+            array_size_given = true;
+        } else if (arg.substr(0, 13) == "--data-width=") {
+            params.data_width = std::stoi(arg.substr(13));
+        } else if (arg.substr(0, 8) == "--max-k=") {
+            params.max_k = std::stoi(arg.substr(8));
+            max_k_given = true;
+        } else if (arg.substr(0, 17) == "--extra-acc-bits=") {
+            params.extra_acc_bits = std::stoi(arg.substr(17));
+        } else if (arg.substr(0, 6) == "--out=") {
+            out_path = arg.substr(6);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--array-size=N] [--data-width=N] [--max-k=N] [--extra-acc-bits=N] [--out=path]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    // A new ARRAY_SIZE brings MAX_K with it unless that is set too; without
+    // either, kNpuParams.max_k stands. The RTL modules take their MAX_K, and
+    // so ACC_WIDTH, from the package.
+    if (array_size_given && !max_k_given) {
+        params.max_k = params.array_size;
+    }
+    if (params.array_size < 1 || params.data_width < 2 || params.max_k < 1 || params.extra_acc_bits < 0) {
+        std::cerr << "ERROR: invalid parameters\n";
+        return EXIT_FAILURE;
+    }
+    // The limits npu_config.hpp asserts for kNpuParams
+    if (params.data_width % 2 != 0) {
+        std::cerr << "ERROR: DATA_WIDTH must be even: DUAL_INT4 splits a lane into two halves\n";
+        return EXIT_FAILURE;
+    }
+    if (params.acc_width() > 32) {
+        std::cerr << "ERROR: ACC_WIDTH " << params.acc_width()
+                  << " exceeds 32: the model and host tools hold results in int32_t\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream out(out_path);
+    if (!out) {
+        std::cerr << "ERROR: Could not open " << out_path << " for writing\n";
+        return EXIT_FAILURE;
+    }
+    out << npu::sv_config_package(params);
+    std::cout << "Wrote " << out_path << ": ARRAY_SIZE=" << params.array_size << " DATA_WIDTH=" << params.data_width
+              << " MAX_K=" << params.max_k << " ACC_WIDTH=" << params.acc_width() << "\n";
+    return EXIT_SUCCESS;
+}
@@ -7,10 +7,12 @@
 #include <iostream>
 #include <random>
 
+#include "npu_config.hpp"
+
 namespace {
 
-constexpr int kArraySize  = 4;
-constexpr int kDataWidth  = 8;
+constexpr int kArraySize  = npu::kNpuParams.array_size;
+constexpr int kDataWidth  = npu::kNpuParams.data_width;
 constexpr int kInt8Max    = (1 << (kDataWidth - 1)) - 1;
 constexpr int kInt8Min    = -(1 << (kDataWidth - 1));
 
@@ -1,4 +1,3 @@
-#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -8,79 +7,15 @@
 #include <string_view>
 #include <vector>
 
-namespace {
-
-constexpr int kArraySize  = 4;
-constexpr int kDataWidth  = 8;
-constexpr int kInt8Max    = (1 << (kDataWidth - 1)) - 1;
-constexpr int kInt8Min    = -(1 << (kDataWidth - 1));
-
-using Matrix = std::array<std::array<int, kArraySize>, kArraySize>;
-using FMatrix = std::array<std::array<float, kArraySize>, kArraySize>;
-
-// ============================================================================
-// Quantization Support
-// ============================================================================
-
-struct QuantParams {
-    float scale;
-    int zero_point;
-    
-    QuantParams() : scale(1.0f), zero_point(0) {}
-    QuantParams(float s, int zp) : scale(s), zero_point(zp) {}
-};
-
-int8_t quantize(float value, const QuantParams& params) {
-    int32_t quantized = static_cast<int32_t>(std::round(value / params.scale)) + params.zero_point;
-    if (quantized < kInt8Min) return kInt8Min;
-    if (quantized > kInt8Max) return kInt8Max;
-    return static_cast<int8_t>(quantized);
-}
-
-float dequantize(int8_t value, const QuantParams& params) {
-    return (static_cast<float>(value) - params.zero_point) * params.scale;
-}
-
-QuantParams compute_quant_params(float min_val, float max_val) {
-    // Symmetric quantization for signed int8
-    float abs_max = std::max(std::abs(min_val), std::abs(max_val));
-    if (abs_max < 1e-8f) {
-        return QuantParams(1.0f, 0);
-    }
-    float scale = abs_max / kInt8Max;
-    return QuantParams(scale, 0);
-}
+#include "npu_host.hpp"
 
-Matrix quantize_matrix(const FMatrix& m, const QuantParams& params) {
-    Matrix out{};
-    for (int r = 0; r < kArraySize; ++r) {
-        for (int c = 0; c < kArraySize; ++c) {
-            out[r][c] = quantize(m[r][c], params);
-        }
-    }
-    return out;
-}
-
-FMatrix dequantize_matrix(const Matrix& m, const QuantParams& params) {
-    FMatrix out{};
-    for (int r = 0; r < kArraySize; ++r) {
-        for (int c = 0; c < kArraySize; ++c) {
-            out[r][c] = dequantize(static_cast<int8_t>(m[r][c]), params);
-        }
-    }
-    return out;
-}
+namespace {
 
-void find_float_matrix_range(const FMatrix& m, float& min_val, float& max_val) {
-    min_val = m[0][0];
-    max_val = m[0][0];
-    for (const auto& row : m) {
-        for (float value : row) {
-            if (value < min_val) min_val = value;
-            if (value > max_val) max_val = value;
-        }
-    }
-}
+constexpr int kArraySize  = npu::kNpuParams.array_size;
+constexpr int kDataWidth  = npu::kNpuParams.data_width;
+using Matrix = npu::Int32Matrix;
+using FMatrix = npu::FloatMatrix;
+using npu::QuantParams;
 
 // ============================================================================
 // Matrix Operations
@@ -97,127 +32,60 @@ int min_acc_width(int data_width, int array_size) {
     return multiplicand_bits + guard_bits;
 }
 
-void print_matrix(std::string_view label, const Matrix& m) {
+void print_matrix(std::string_view label, npu::MatrixView<const int32_t> m) {
     std::cout << label << '\n';
-    for (const auto& row : m) {
-        for (const auto& value : row) {
-            std::cout << std::setw(6) << value << ' ';
+    for (int r = 0; r < m.rows(); ++r) {
+        for (int c = 0; c < m.cols(); ++c) {
+            std::cout << std::setw(6) << m.at(r, c) << ' ';
         }
         std::cout << '\n';
     }
     std::cout << std::endl;
 }
 
-void print_float_matrix(std::string_view label, const FMatrix& m) {
+void print_float_matrix(std::string_view label, npu::MatrixView<const float> m) {
     std::cout << label << '\n';
-    for (const auto& row : m) {
-        for (float value : row) {
-            std::cout << std::setw(10) << std::fixed << std::setprecision(4) << value << ' ';
+    for (int r = 0; r < m.rows(); ++r) {
+        for (int c = 0; c < m.cols(); ++c) {
+            std::cout << std::setw(10) << std::fixed << std::setprecision(4) << m.at(r, c) << ' ';
         }
         std::cout << '\n';
     }
     std::cout << std::endl;
 }
 
-Matrix gemm(const Matrix& a, const Matrix& b) {
-    Matrix c{};
-    for (int i = 0; i < kArraySize; ++i) {
-        for (int j = 0; j < kArraySize; ++j) {
-            int sum = 0;
-            for (int k = 0; k < kArraySize; ++k) {
-                sum += a[i][k] * b[k][j];
-            }
-            c[i][j] = sum;
-        }
-    }
-    return c;
-}
-
-FMatrix gemm_float(const FMatrix& a, const FMatrix& b) {
-    FMatrix c{};
-    for (int i = 0; i < kArraySize; ++i) {
-        for (int j = 0; j < kArraySize; ++j) {
-            float sum = 0.0f;
-            for (int k = 0; k < kArraySize; ++k) {
-                sum += a[i][k] * b[k][j];
-            }
-            c[i][j] = sum;
-        }
-    }
-    return c;
-}
-
-Matrix relu(const Matrix& m) {
-    Matrix out = m;
-    for (auto& row : out) {
-        for (auto& value : row) {
-            if (value < 0) {
-                value = 0;
-            }
-        }
-    }
-    return out;
-}
-
-FMatrix relu_float(const FMatrix& m) {
-    FMatrix out = m;
-    for (auto& row : out) {
-        for (float& value : row) {
-            if (value < 0.0f) {
-                value = 0.0f;
-            }
-        }
-    }
-    return out;
-}
-
-std::vector<int> stream_order(const Matrix& m) {
-    std::vector<int> values;
-    values.reserve(kArraySize * kArraySize);
-    for (int r = 0; r < kArraySize; ++r) {
-        for (int c = 0; c < kArraySize; ++c) {
-            values.push_back(m[r][c]);
-        }
-    }
-    return values;
-}
-
 Matrix make_sample_matrix(bool randomize, std::mt19937& rng) {
-    Matrix m{};
+    Matrix m(kArraySize, kArraySize);
     if (!randomize) {
         for (int r = 0; r < kArraySize; ++r) {
             for (int c = 0; c < kArraySize; ++c) {
-                m[r][c] = (r == c) ? (r + 1) : ((r < c) ? (c - r) : -(r - c));
+                m.at(r, c) = (r == c) ? (r + 1) : ((r < c) ? (c - r) : -(r - c));
             }
         }
         return m;
     }
 
-    std::uniform_int_distribution<int> dist(kInt8Min / 4, kInt8Max / 4);
-    for (auto& row : m) {
-        for (auto& value : row) {
-            value = dist(rng);
-        }
+    std::uniform_int_distribution<int> dist(npu::kInt8Min / 4, npu::kInt8Max / 4);
+    for (auto& value : m.data) {
+        value = dist(rng);
     }
     return m;
 }
 
 FMatrix make_float_matrix(bool randomize, std::mt19937& rng) {
-    FMatrix m{};
+    FMatrix m(kArraySize, kArraySize);
     if (!randomize) {
         for (int r = 0; r < kArraySize; ++r) {
             for (int c = 0; c < kArraySize; ++c) {
-                m[r][c] = (r == c) ? (r + 1.5f) : ((r < c) ? (c - r + 0.5f) : -(r - c + 0.25f));
+                m.at(r, c) = (r == c) ? (r + 1.5f) : ((r < c) ? (c - r + 0.5f) : -(r - c + 0.25f));
             }
         }
         return m;
     }
 
     std::uniform_real_distribution<float> dist(-50.0f, 50.0f);
-    for (auto& row : m) {
-        for (float& value : row) {
-            value = dist(rng);
-        }
+    for (float& value : m.data) {
+        value = dist(rng);
     }
     return m;
 }
@@ -232,7 +100,7 @@ bool starts_with(std::string_view value, std::string_view prefix) {
 int main(int argc, char** argv) {
     bool randomize = false;
     bool use_quantization = false;
-    int extra_bits = 4;
+    int extra_bits = npu::kNpuParams.extra_acc_bits;
     std::uint32_t seed = 0xC0FFEEu;
 
     for (int i = 1; i < argc; ++i) {
@@ -269,38 +137,44 @@ int main(int argc, char** argv) {
         FMatrix b_float = make_float_matrix(randomize, rng);
 
         float a_min, a_max, b_min, b_max;
-        find_float_matrix_range(a_float, a_min, a_max);
-        find_float_matrix_range(b_float, b_min, b_max);
+        npu::find_range(a_float.view(), a_min, a_max);
+        npu::find_range(b_float.view(), b_min, b_max);
 
-        QuantParams a_params = compute_quant_params(a_min, a_max);
-        QuantParams b_params = compute_quant_params(b_min, b_max);
+        QuantParams a_params = npu::compute_quant_params(a_min, a_max);
+        QuantParams b_params = npu::compute_quant_params(b_min, b_max);
 
         std::cout << "Quantization Parameters:\n";
         std::cout << "  Matrix A: scale=" << a_params.scale << ", zero_point=" << a_params.zero_point << "\n";
         std::cout << "  Matrix B: scale=" << b_params.scale << ", zero_point=" << b_params.zero_point << "\n\n";
 
-        Matrix a = quantize_matrix(a_float, a_params);
-        Matrix b = quantize_matrix(b_float, b_params);
+        Matrix a(kArraySize, kArraySize);
+        Matrix b(kArraySize, kArraySize);
+        npu::quantize_matrix(a_float.view(), a_params, a.view());
+        npu::quantize_matrix(b_float.view(), b_params, b.view());
 
-        print_float_matrix("Original Float Matrix A:", a_float);
-        print_matrix("Quantized INT8 Matrix A:", a);
-        print_float_matrix("Original Float Matrix B:", b_float);
-        print_matrix("Quantized INT8 Matrix B:", b);
+        print_float_matrix("Original Float Matrix A:", a_float.view());
+        print_matrix("Quantized INT8 Matrix A:", a.view());
+        print_float_matrix("Original Float Matrix B:", b_float.view());
+        print_matrix("Quantized INT8 Matrix B:", b.view());
 
         // Compute in quantized domain
-        const Matrix raw = gemm(a, b);
-        const Matrix relu_out = relu(raw);
-        const auto streamed = stream_order(relu_out);
+        Matrix raw(kArraySize, kArraySize);
+        Matrix relu_out(kArraySize, kArraySize);
+        npu::gemm(a.view(), b.view(), raw.view());
+        npu::relu(raw.view(), relu_out.view());
+        const auto streamed = npu::stream_order(relu_out.view());
 
-        print_matrix("Quantized Product (no activation):", raw);
-        print_matrix("After ReLU activation:", relu_out);
+        print_matrix("Quantized Product (no activation):", raw.view());
+        print_matrix("After ReLU activation:", relu_out.view());
 
         // Also compute floating-point reference
-        const FMatrix float_product = gemm_float(a_float, b_float);
-        const FMatrix float_relu = relu_float(float_product);
-        
-        print_float_matrix("Float Reference Product:", float_product);
-        print_float_matrix("Float Reference ReLU:", float_relu);
+        FMatrix float_product(kArraySize, kArraySize);
+        FMatrix float_relu(kArraySize, kArraySize);
+        npu::gemm(a_float.view(), b_float.view(), float_product.view());
+        npu::relu(float_product.view(), float_relu.view());
+
+        print_float_matrix("Float Reference Product:", float_product.view());
+        print_float_matrix("Float Reference ReLU:", float_relu.view());
 
         std::cout << "Streaming order (row-major, ReLU applied, quantized):\n";
         for (std::size_t idx = 0; idx < streamed.size(); ++idx) {
@@ -313,14 +187,16 @@ int main(int argc, char** argv) {
         Matrix a = make_sample_matrix(randomize, rng);
         Matrix b = make_sample_matrix(randomize, rng);
 
-        const Matrix raw = gemm(a, b);
-        const Matrix relu_out = relu(raw);
-        const auto streamed = stream_order(relu_out);
+        Matrix raw(kArraySize, kArraySize);
+        Matrix relu_out(kArraySize, kArraySize);
+        npu::gemm(a.view(), b.view(), raw.view());
+        npu::relu(raw.view(), relu_out.view());
+        const auto streamed = npu::stream_order(relu_out.view());
 
-        print_matrix("Matrix A:", a);
-        print_matrix("Matrix B:", b);
-        print_matrix("Raw product (no activation):", raw);
-        print_matrix("After ReLU activation:", relu_out);
+        print_matrix("Matrix A:", a.view());
+        print_matrix("Matrix B:", b.view());
+        print_matrix("Raw product (no activation):", raw.view());
+        print_matrix("After ReLU activation:", relu_out.view());
 
         std::cout << "Streaming order (row-major, ReLU applied):\n";
         for (std::size_t idx = 0; idx < streamed.size(); ++idx) {
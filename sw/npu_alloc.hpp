@@ -0,0 +1,390 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX // keep std::min / std::max usable
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "npu_view.hpp"
+
+// Page- and node-aware host memory for large, long-lived buffers: packed
+// weight panels, scratch arenas and simulator state. Buffers are mapped
+// directly from the OS so they can use 2 MB or 1 GB pages (fewer dTLB misses
+// on multi-MB panels) and be placed on a chosen NUMA node. Every request
+// degrades quietly: explicit huge pages fall back to transparent huge pages,
+// then to normal pages, and binding is skipped on single-node hosts. The
+// buffer reports what it actually got.
+namespace npu {
+
+// ============================================================================
+// Topology
+// ============================================================================
+
+// NUMA nodes that have CPUs, and the CPUs on each. Read from sysfs on Linux;
+// elsewhere, or if sysfs is missing, one node holding every hardware thread.
+// Nodes are indexed 0 .. nodes() - 1; node_ids maps them to OS node numbers.
+struct NumaTopology {
+    std::vector<int> node_ids;
+    std::vector<std::vector<int>> node_cpus;
+
+    int nodes() const { return static_cast<int>(node_cpus.size()); }
+};
+
+namespace detail {
+
+// Parses a sysfs CPU/node list such as "0-3,8,10-11"
+inline std::vector<int> parse_id_list(const std::string& text) {
+    std::vector<int> ids;
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        const std::size_t dash = range.find('-');
+        const int lo = std::stoi(range.substr(0, dash));
+        const int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+        for (int id = lo; id <= hi; ++id) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+inline std::string read_line(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+} // namespace detail
+
+inline NumaTopology detect_topology() {
+    NumaTopology topo;
+#ifdef __linux__
+    const std::string online = detail::read_line("/sys/devices/system/node/online");
+    for (int node : detail::parse_id_list(online)) {
+        const std::vector<int> cpus = detail::parse_id_list(
+            detail::read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+        // Memory-only nodes have no CPUs to schedule on
+        if (!cpus.empty()) {
+            topo.node_ids.push_back(node);
+            topo.node_cpus.push_back(cpus);
+        }
+    }
+#endif
+    if (topo.node_cpus.empty()) {
+        const int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        topo.node_ids.assign(1, 0);
+        topo.node_cpus.emplace_back();
+        for (int cpu = 0; cpu < threads; ++cpu) {
+            topo.node_cpus[0].push_back(cpu);
+        }
+    }
+    return topo;
+}
+
+// Detected once per process
+inline const NumaTopology& numa_topology() {
+    static const NumaTopology topo = detect_topology();
+    return topo;
+}
+
+// ============================================================================
+// Page-Mapped Buffers
+// ============================================================================
+
+enum class PageSize {
+    Default,
+    Huge2M,
+    Huge1G,
+};
+
+struct AllocOptions {
+    PageSize pages = PageSize::Default;
+    int node = -1; // OS node number to bind to; -1 leaves placement to first touch
+};
+
+// What a buffer actually received
+enum class PageBacking {
+    Normal,
+    Transparent, // normal mapping advised for transparent huge pages
+    Huge2M,
+    Huge1G,
+};
+
+inline const char* page_backing_name(PageBacking backing) {
+    switch (backing) {
+    case PageBacking::Normal:
+        return "4K";
+    case PageBacking::Transparent:
+        return "THP";
+    case PageBacking::Huge2M:
+        return "2M";
+    case PageBacking::Huge1G:
+        return "1G";
+    }
+    return "?";
+}
+
+// Zero-initialized, page-aligned memory mapped straight from the OS
+class PageBuffer {
+public:
+    PageBuffer() = default;
+
+    PageBuffer(std::size_t bytes, const AllocOptions& options) : requested_(bytes) {
+        if (bytes == 0) {
+            return;
+        }
+        map(bytes, options);
+        if (!data_) {
+            throw std::bad_alloc();
+        }
+        if (options.node >= 0) {
+            bound_ = bind(options.node);
+        }
+    }
+
+    ~PageBuffer() { release(); }
+
+    PageBuffer(PageBuffer&& other) noexcept { *this = std::move(other); }
+    PageBuffer& operator=(PageBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = other.data_;
+            mapped_ = other.mapped_;
+            requested_ = other.requested_;
+            backing_ = other.backing_;
+            bound_ = other.bound_;
+            other.data_ = nullptr;
+            other.mapped_ = 0;
+            other.requested_ = 0;
+        }
+        return *this;
+    }
+
+    PageBuffer(const PageBuffer&) = delete;
+    PageBuffer& operator=(const PageBuffer&) = delete;
+
+    void* data() const { return data_; }
+    std::size_t size() const { return requested_; }
+    std::size_t mapped_bytes() const { return mapped_; }
+    PageBacking backing() const { return backing_; }
+    bool bound() const { return bound_; } // true if the node binding took effect
+
+private:
+    static std::size_t round_up(std::size_t bytes, std::size_t unit) { return (bytes + unit - 1) / unit * unit; }
+
+    void map(std::size_t bytes, const AllocOptions& options) {
+#ifdef _WIN32
+        // Large pages need SeLockMemoryPrivilege; without it fall back to
+        // normal pages. Both come back zeroed.
+        const DWORD node = options.node >= 0 ? static_cast<DWORD>(options.node) : NUMA_NO_PREFERRED_NODE;
+        if (options.pages != PageSize::Default && GetLargePageMinimum() != 0) {
+            mapped_ = round_up(bytes, GetLargePageMinimum());
+            data_ = VirtualAllocExNuma(GetCurrentProcess(), nullptr, mapped_,
+                                       MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+            backing_ = PageBacking::Huge2M;
+        }
+        if (!data_) {
+            mapped_ = round_up(bytes, 4096);
+            data_ = VirtualAllocExNuma(GetCurrentProcess(), nullptr, mapped_, MEM_RESERVE | MEM_COMMIT,
+                                       PAGE_READWRITE, node);
+            backing_ = PageBacking::Normal;
+        }
+        bound_ = data_ && options.node >= 0;
+#else
+        constexpr std::size_t k2M = std::size_t{1} << 21;
+        constexpr std::size_t k1G = std::size_t{1} << 30;
+        // Explicit pages come from the reserved hugetlb pool and fail when it
+        // is empty, so try each size down to transparent huge pages
+#ifdef MAP_HUGETLB
+        const int shift = 26; // MAP_HUGE_SHIFT
+        if (options.pages == PageSize::Huge1G) {
+            try_map(round_up(bytes, k1G), MAP_HUGETLB | (30 << shift), PageBacking::Huge1G);
+        }
+        if (!data_ && options.pages != PageSize::Default) {
+            try_map(round_up(bytes, k2M), MAP_HUGETLB | (21 << shift), PageBacking::Huge2M);
+        }
+#endif
+        if (!data_ && options.pages != PageSize::Default) {
+            if (try_map(round_up(bytes, k2M), 0, PageBacking::Transparent)) {
+#ifdef MADV_HUGEPAGE
+                ::madvise(data_, mapped_, MADV_HUGEPAGE);
+#endif
+            }
+        }
+        if (!data_) {
+            try_map(round_up(bytes, static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))), 0, PageBacking::Normal);
+        }
+#endif
+    }
+
+#ifndef _WIN32
+    bool try_map(std::size_t bytes, int flags, PageBacking backing) {
+        void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+        if (map == MAP_FAILED) {
+            return false;
+        }
+        data_ = map;
+        mapped_ = bytes;
+        backing_ = backing;
+        return true;
+    }
+#endif
+
+    // Binds the (still untouched) pages to node with mbind(MPOL_BIND).
+    // Called directly so there is no libnuma dependency.
+    bool bind(int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+        if (node >= 64) {
+            return false;
+        }
+        constexpr int kMpolBind = 2;
+        const unsigned long mask = 1ul << node;
+        return ::syscall(SYS_mbind, data_, mapped_, kMpolBind, &mask, sizeof(mask) * 8, 0) == 0;
+#else
+        return bound_;
+#endif
+    }
+
+    void release() {
+        if (!data_) {
+            return;
+        }
+#ifdef _WIN32
+        VirtualFree(data_, 0, MEM_RELEASE);
+#else
+        ::munmap(data_, mapped_);
+#endif
+        data_ = nullptr;
+    }
+
+    void* data_ = nullptr;
+    std::size_t mapped_ = 0;
+    std::size_t requested_ = 0;
+    PageBacking backing_ = PageBacking::Normal;
+    bool bound_ = false;
+};
+
+// ============================================================================
+// Arena
+// ============================================================================
+
+// Bump allocator over one PageBuffer for per-call scratch (packing buffers,
+// partial tiles). reset() recycles everything at once; nothing is freed
+// individually.
+class Arena {
+public:
+    explicit Arena(std::size_t bytes, const AllocOptions& options = {}) : buffer_(bytes, options) {}
+
+    // Throws std::bad_alloc when the arena is full
+    void* allocate(std::size_t bytes, std::size_t align = 64) {
+        const std::size_t offset = (used_ + align - 1) / align * align;
+        if (offset + bytes > buffer_.size()) {
+            throw std::bad_alloc();
+        }
+        used_ = offset + bytes;
+        return static_cast<char*>(buffer_.data()) + offset;
+    }
+
+    template <typename T>
+    T* allocate_array(std::size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), std::max<std::size_t>(alignof(T), 64)));
+    }
+
+    void reset() { used_ = 0; }
+    std::size_t used() const { return used_; }
+    std::size_t capacity() const { return buffer_.size(); }
+    const PageBuffer& buffer() const { return buffer_; }
+
+private:
+    PageBuffer buffer_;
+    std::size_t used_ = 0;
+};
+
+// ============================================================================
+// Page-Mapped Matrices
+// ============================================================================
+
+// Row-major matrix in a PageBuffer; the counterpart of HostMatrix for large
+// operands that should sit on huge pages or a given node
+template <typename T>
+class PageMatrix {
+public:
+    PageMatrix() = default;
+    PageMatrix(int rows, int cols, const AllocOptions& options = {})
+        : rows_(rows), cols_(cols), buffer_(static_cast<std::size_t>(rows) * cols * sizeof(T), options) {}
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    const PageBuffer& buffer() const { return buffer_; }
+
+    MatrixView<T> view() { return {static_cast<T*>(buffer_.data()), rows_, cols_}; }
+    MatrixView<const T> view() const { return {static_cast<const T*>(buffer_.data()), rows_, cols_}; }
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    PageBuffer buffer_;
+};
+
+// Read-only data (packed weights) with one copy bound to each NUMA node, so
+// every socket streams its weights from local memory. With replicate off,
+// or on a single-node host, all nodes share one copy.
+template <typename T>
+class Replicated {
+public:
+    template <typename U>
+    Replicated(MatrixView<U> source, PageSize pages = PageSize::Huge2M, bool replicate = true) {
+        const NumaTopology& topo = numa_topology();
+        const int copies = replicate ? topo.nodes() : 1;
+        for (int node = 0; node < copies; ++node) {
+            AllocOptions options;
+            options.pages = pages;
+            options.node = copies > 1 ? topo.node_ids[node] : -1;
+            copies_.emplace_back(source.rows(), source.cols(), options);
+            MatrixView<T> dst = copies_.back().view();
+            for (int r = 0; r < source.rows(); ++r) {
+                for (int c = 0; c < source.cols(); ++c) {
+                    dst.at(r, c) = static_cast<T>(source.at(r, c));
+                }
+            }
+        }
+    }
+
+    int copies() const { return static_cast<int>(copies_.size()); }
+
+    // The copy local to node (the only copy when not replicated)
+    MatrixView<const T> for_node(int node) const {
+        return copies_[copies_.size() == 1 ? 0 : static_cast<std::size_t>(node)].view();
+    }
+
+    const PageBuffer& buffer(int copy) const { return copies_.at(static_cast<std::size_t>(copy)).buffer(); }
+
+private:
+    std::vector<PageMatrix<T>> copies_;
+};
+
+} // namespace npu
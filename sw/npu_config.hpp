@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+
+// Single source of truth for the default NPU build. The C++ model, the host
+// tools and the RTL all take their defaults from kNpuParams: the RTL through
+// rtl/npu_config_pkg.sv, which sw/gen_config_pkg.cpp generates from this file.
+// After editing kNpuParams, regenerate the package:
+//   g++ -std=c++17 -O2 -o build/gen_config_pkg.exe sw/gen_config_pkg.cpp; .\build\gen_config_pkg.exe
+namespace npu {
+
+// Same result as SystemVerilog $clog2
+constexpr int clog2(int value) {
+    int bits = 0;
+    while ((1 << bits) < value) {
+        ++bits;
+    }
+    return bits;
+}
+
+struct NpuParams {
+    int array_size;
+    int data_width;
+    int max_k;          // MAX_K: longest accumulation per job, in beats
+    int extra_acc_bits; // guard bits on top of the minimum accumulator width
+
+    constexpr int acc_width() const { return (2 * data_width) + clog2(max_k) + extra_acc_bits; }
+    constexpr int output_count() const { return array_size * array_size; }
+    constexpr int index_width() const { return output_count() > 1 ? clog2(output_count()) : 1; }
+};
+
+inline constexpr NpuParams kNpuParams{
+    4, // array_size
+    8, // data_width
+    4, // max_k
+    2, // extra_acc_bits
+};
+
+static_assert(kNpuParams.data_width % 2 == 0, "DUAL_INT4 splits a lane into two halves");
+static_assert(kNpuParams.acc_width() <= 32, "The model and host tools hold results in int32_t");
+
+// Text of rtl/npu_config_pkg.sv for the given parameters
+inline std::string sv_config_package(const NpuParams& params) {
+    auto line = [](const char* name, int value) {
+        std::string text = "    localparam integer ";
+        text += name;
+        text.append(19 - std::string(name).size(), ' ');
+        return text + "= " + std::to_string(value) + ";\n";
+    };
+    std::string text =
+        "// Generated by sw/gen_config_pkg.cpp from sw/npu_config.hpp - do not edit by hand\n"
+        "// Default NPU build shared by the RTL parameter defaults and the testbenches\n"
+        "package npu_config_pkg;\n";
+    text += line("NPU_ARRAY_SIZE", params.array_size);
+    text += line("NPU_DATA_WIDTH", params.data_width);
+    text += line("NPU_MAX_K", params.max_k);
+    text += line("NPU_EXTRA_ACC_BITS", params.extra_acc_bits);
+    text += line("NPU_ACC_WIDTH", params.acc_width());
+    text += line("NPU_OUTPUT_COUNT", params.output_count());
+    text += line("NPU_INDEX_WIDTH", params.index_width());
+    text += "endpackage\n";
+    return text;
+}
+
+} // namespace npu
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX // keep std::min / std::max usable
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "npu_model.hpp"
+
+// Host <-> RTL co-simulation over shared memory. The host process creates a
+// named segment holding two single-producer/single-consumer word rings; the
+// npu_cosim VPI module (sw/npu_cosim_vpi.cpp), loaded into vvp running
+// tb/npu_cosim_tb.sv, attaches to it. Jobs go to the simulation as operand
+// beats and come back as result_index/result_data words, so the tiler and any
+// host code built on TileRunner run live against npu_core.
+namespace npu {
+
+// ============================================================================
+// Shared Layout
+// ============================================================================
+
+constexpr uint32_t kCosimMagic = 0x4e505543; // "NPUC"
+constexpr uint32_t kCosimVersion = 1;
+constexpr uint32_t kCosimRingWords = 1u << 16;
+constexpr uint32_t kCosimLastFlag = 0x80000000u; // set on the result_last word's index
+
+// RTL parameters the simulation reports when it attaches
+struct CosimParams {
+    int32_t array_size = 0;
+    int32_t data_width = 0;
+    int32_t max_k = 0;
+    int32_t acc_width = 0;
+    int32_t sparse_stream = 0;
+};
+
+// Words flow from head (producer) to tail (consumer); both only grow
+struct CosimRing {
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) uint32_t words[kCosimRingWords];
+};
+
+struct CosimShared {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> attached; // simulation has written params
+    std::atomic<uint32_t> shutdown; // host sends no further jobs
+    CosimParams params;
+    CosimRing to_device; // job: K, then K beats of ARRAY_SIZE A lanes + ARRAY_SIZE B lanes
+    CosimRing to_host;   // per result word: index (| kCosimLastFlag), data
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring indices must be lock-free across processes");
+static_assert(std::is_standard_layout<CosimShared>::value, "CosimShared is shared between processes");
+
+// ============================================================================
+// Shared Memory Segment
+// ============================================================================
+
+class SharedSegment {
+public:
+    // create: make a fresh segment, replacing a stale one of the same name.
+    // Otherwise open an existing one; throws if it does not exist yet.
+    SharedSegment(const std::string& name, size_t size, bool create) : name_(os_name(name)), size_(size), owner_(create) {
+#ifdef _WIN32
+        if (create) {
+            mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                          static_cast<DWORD>(size & 0xffffffffu), name_.c_str());
+        } else {
+            mapping_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name_.c_str());
+        }
+        if (!mapping_) {
+            throw std::runtime_error("SharedSegment: cannot open " + name_);
+        }
+        data_ = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!data_) {
+            CloseHandle(mapping_);
+            throw std::runtime_error("SharedSegment: cannot map " + name_);
+        }
+#else
+        if (create) {
+            ::shm_unlink(name_.c_str());
+        }
+        const int fd = ::shm_open(name_.c_str(), create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::runtime_error("SharedSegment: cannot open " + name_);
+        }
+        struct stat info;
+        if ((create && ::ftruncate(fd, static_cast<off_t>(size)) != 0) || ::fstat(fd, &info) != 0 ||
+            static_cast<size_t>(info.st_size) < size) {
+            ::close(fd);
+            throw std::runtime_error("SharedSegment: cannot size " + name_);
+        }
+        void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            throw std::runtime_error("SharedSegment: cannot map " + name_);
+        }
+        data_ = map;
+#endif
+    }
+
+    ~SharedSegment() {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+#else
+        ::munmap(data_, size_);
+        if (owner_) {
+            ::shm_unlink(name_.c_str());
+        }
+#endif
+    }
+
+    SharedSegment(const SharedSegment&) = delete;
+    SharedSegment& operator=(const SharedSegment&) = delete;
+
+    void* data() const { return data_; }
+
+private:
+    static std::string os_name(const std::string& name) {
+#ifdef _WIN32
+        return "Local\\" + name;
+#else
+        return (!name.empty() && name[0] == '/') ? name : "/" + name;
+#endif
+    }
+
+    std::string name_;
+    size_t size_;
+    bool owner_;
+    void* data_ = nullptr;
+#ifdef _WIN32
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+// ============================================================================
+// Ring Access
+// ============================================================================
+
+// Producer side: words are staged and become visible together on publish()
+class RingWriter {
+public:
+    explicit RingWriter(CosimRing& ring) : ring_(ring), head_(ring.head.load(std::memory_order_relaxed)) {}
+
+    uint32_t free_words() const {
+        return kCosimRingWords - static_cast<uint32_t>(head_ - ring_.tail.load(std::memory_order_acquire));
+    }
+    void push(uint32_t word) { ring_.words[head_++ % kCosimRingWords] = word; }
+    void publish() { ring_.head.store(head_, std::memory_order_release); }
+
+private:
+    CosimRing& ring_;
+    uint64_t head_;
+};
+
+class RingReader {
+public:
+    explicit RingReader(CosimRing& ring) : ring_(ring), tail_(ring.tail.load(std::memory_order_relaxed)) {}
+
+    uint32_t available() const {
+        return static_cast<uint32_t>(ring_.head.load(std::memory_order_acquire) - tail_);
+    }
+    // Caller checks available() first
+    uint32_t pop() {
+        const uint32_t word = ring_.words[tail_++ % kCosimRingWords];
+        ring_.tail.store(tail_, std::memory_order_release);
+        return word;
+    }
+
+private:
+    CosimRing& ring_;
+    uint64_t tail_;
+};
+
+// Spins with yield until ready() or the timeout passes; false on timeout
+template <typename Ready>
+bool cosim_wait(Ready ready, double timeout_seconds) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout_seconds);
+    while (!ready()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// ============================================================================
+// Host Side
+// ============================================================================
+
+// TileRunner backed by a live simulation of tb/npu_cosim_tb.sv. Construction
+// creates the segment and waits for the simulation to attach, then checks
+// that its RTL parameters match cfg. depth bounds the jobs in flight; it is
+// reduced if that many jobs or results would not fit the rings.
+class CosimHost : public TileRunner {
+public:
+    explicit CosimHost(const CoreConfig& cfg, const std::string& name = "npu_cosim", int depth = 8,
+                       double timeout_seconds = 60.0)
+        : cfg_(cfg), segment_(name, sizeof(CosimShared), true),
+          shared_(static_cast<CosimShared*>(segment_.data())), timeout_(timeout_seconds) {
+        if (cfg.int4_weights || cfg.num_cores != 1) {
+            throw std::invalid_argument("CosimHost: npu_cosim_tb runs one int8 npu_core");
+        }
+        std::memset(static_cast<void*>(shared_), 0, sizeof(CosimShared));
+        shared_->magic = kCosimMagic;
+        shared_->version = kCosimVersion;
+        std::atomic_thread_fence(std::memory_order_release);
+        to_device_ = std::make_unique<RingWriter>(shared_->to_device);
+        to_host_ = std::make_unique<RingReader>(shared_->to_host);
+
+        const uint32_t job_words = 1u + static_cast<uint32_t>(cfg.max_k) * 2u * cfg.array_size;
+        const uint32_t result_words = 2u * static_cast<uint32_t>(output_count(cfg));
+        depth_ = std::min<uint32_t>(static_cast<uint32_t>(std::max(depth, 1)),
+                                    std::min(kCosimRingWords / job_words, kCosimRingWords / result_words));
+        if (depth_ < 1) {
+            throw std::invalid_argument("CosimHost: one job does not fit the shared rings");
+        }
+
+        if (!cosim_wait([&] { return shared_->attached.load(std::memory_order_acquire) != 0; }, timeout_)) {
+            throw std::runtime_error("CosimHost: no simulation attached to " + name);
+        }
+        const CosimParams& p = shared_->params;
+        if (p.array_size != cfg.array_size || p.data_width != cfg.data_width || p.max_k != cfg.max_k ||
+            p.acc_width != acc_width(cfg) || (p.sparse_stream != 0) != cfg.sparse_stream) {
+            throw std::invalid_argument(
+                "CosimHost: RTL parameters differ from CoreConfig (ARRAY_SIZE=" + std::to_string(p.array_size) +
+                " DATA_WIDTH=" + std::to_string(p.data_width) + " MAX_K=" + std::to_string(p.max_k) +
+                " ACC_WIDTH=" + std::to_string(p.acc_width) + " SPARSE_STREAM=" + std::to_string(p.sparse_stream) + ")");
+        }
+    }
+
+    ~CosimHost() override { close(); }
+
+    // Ends the session; the simulation finishes once it has drained
+    void close() { shared_->shutdown.store(1, std::memory_order_release); }
+
+    int depth() const override { return static_cast<int>(depth_); }
+    uint64_t jobs() const { return jobs_; }
+
+    void submit(const IntMatrix& a_tile, const IntMatrix& b_tile) override {
+        const int n = cfg_.array_size;
+        const int k_len = a_tile.cols;
+        if (a_tile.rows != n || b_tile.cols != n || b_tile.rows != k_len || k_len < 1 || k_len > cfg_.max_k) {
+            throw std::invalid_argument("CosimHost::submit: tile shape must match ARRAY_SIZE and 1..MAX_K");
+        }
+        const uint32_t words = 1u + static_cast<uint32_t>(k_len) * 2u * n;
+        if (!cosim_wait([&] { return to_device_->free_words() >= words; }, timeout_)) {
+            throw std::runtime_error("CosimHost: simulation stopped taking jobs");
+        }
+        to_device_->push(static_cast<uint32_t>(k_len));
+        for (int k = 0; k < k_len; ++k) {
+            for (int lane = 0; lane < n; ++lane) {
+                to_device_->push(static_cast<uint32_t>(a_tile.at(lane, k)));
+            }
+            for (int lane = 0; lane < n; ++lane) {
+                to_device_->push(static_cast<uint32_t>(b_tile.at(k, lane)));
+            }
+        }
+        to_device_->publish();
+        ++jobs_;
+    }
+
+    IntMatrix collect() override {
+        const int width = acc_width(cfg_);
+        std::vector<StreamWord> words;
+        while (words.empty() || !words.back().last) {
+            if (!cosim_wait([&] { return to_host_->available() >= 2; }, timeout_)) {
+                throw std::runtime_error("CosimHost: no result from the simulation");
+            }
+            const uint32_t index = to_host_->pop();
+            const uint32_t data = to_host_->pop();
+            words.push_back({static_cast<int>(index & ~kCosimLastFlag), wrap_to_width(data, width),
+                             (index & kCosimLastFlag) != 0});
+        }
+        return scatter_stream(words, cfg_.array_size, cfg_.array_size);
+    }
+
+private:
+    CoreConfig cfg_;
+    SharedSegment segment_;
+    CosimShared* shared_;
+    double timeout_;
+    std::unique_ptr<RingWriter> to_device_;
+    std::unique_ptr<RingReader> to_host_;
+    uint32_t depth_ = 1;
+    uint64_t jobs_ = 0;
+};
+
+// ============================================================================
+// Simulation Side
+// ============================================================================
+
+// The simulation's end of the channel, driven by the VPI tasks: poll for a
+// job, take its beats one per accepted handshake, return each result word.
+class CosimDevice {
+public:
+    // Retries until the host has created the segment, then reports params
+    CosimDevice(const std::string& name, const CosimParams& params, double timeout_seconds = 60.0)
+        : params_(params) {
+        const bool found = cosim_wait(
+            [&] {
+                try {
+                    segment_ = std::make_unique<SharedSegment>(name, sizeof(CosimShared), false);
+                } catch (const std::runtime_error&) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    return false;
+                }
+                shared_ = static_cast<CosimShared*>(segment_->data());
+                return true;
+            },
+            timeout_seconds);
+        if (!found) {
+            throw std::runtime_error("CosimDevice: no host segment named " + name);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (shared_->magic != kCosimMagic || shared_->version != kCosimVersion) {
+            throw std::runtime_error("CosimDevice: " + name + " is not an npu_cosim segment");
+        }
+        to_device_ = std::make_unique<RingReader>(shared_->to_device);
+        to_host_ = std::make_unique<RingWriter>(shared_->to_host);
+        shared_->params = params;
+        shared_->attached.store(1, std::memory_order_release);
+    }
+
+    // K of the next job, 0 if none is queued yet, -1 once the host is done
+    int poll_job() {
+        if (to_device_->available() == 0) {
+            if (shared_->shutdown.load(std::memory_order_acquire) && to_device_->available() == 0) {
+                return -1;
+            }
+            std::this_thread::yield();
+            return 0;
+        }
+        beats_left_ = static_cast<int>(to_device_->pop());
+        return beats_left_;
+    }
+
+    // Next beat of the current job; a job's words are published together
+    void next_beat(std::vector<int32_t>& a_lanes, std::vector<int32_t>& b_lanes) {
+        if (beats_left_ <= 0) {
+            throw std::logic_error("CosimDevice::next_beat: no job in progress");
+        }
+        a_lanes.resize(static_cast<size_t>(params_.array_size));
+        b_lanes.resize(static_cast<size_t>(params_.array_size));
+        for (auto& lane : a_lanes) {
+            lane = static_cast<int32_t>(to_device_->pop());
+        }
+        for (auto& lane : b_lanes) {
+            lane = static_cast<int32_t>(to_device_->pop());
+        }
+        --beats_left_;
+    }
+
+    // One result handshake; a tile's words are published on result_last
+    void put_result(int index, uint32_t data, bool last) {
+        if (!cosim_wait([&] { return to_host_->free_words() >= 2; }, 60.0)) {
+            throw std::runtime_error("CosimDevice: host stopped taking results");
+        }
+        to_host_->push(static_cast<uint32_t>(index) | (last ? kCosimLastFlag : 0u));
+        to_host_->push(data);
+        if (last) {
+            to_host_->publish();
+        }
+    }
+
+private:
+    CosimParams params_;
+    std::unique_ptr<SharedSegment> segment_;
+    CosimShared* shared_ = nullptr;
+    std::unique_ptr<RingReader> to_device_;
+    std::unique_ptr<RingWriter> to_host_;
+    int beats_left_ = 0;
+};
+
+} // namespace npu
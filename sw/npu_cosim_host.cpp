@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "npu_cosim.hpp"
+
+// Runs random GEMMs through the tiler against a live tb/npu_cosim_tb.sv
+// simulation and checks every product against the reference. Start it first;
+// it waits for the simulation to attach:
+//   npu_cosim_host [--name=npu_cosim] [--m=13] [--k=11] [--n=9] [--gemms=4]
+//                  [--depth=8] [--sparse] [--relu]
+// The simulation must be built with the same MAX_K and SPARSE_STREAM.
+int main(int argc, char** argv) {
+    std::string name = "npu_cosim";
+    int m = 13;
+    int k = 11;
+    int n = 9;
+    int gemms = 4;
+    int depth = 8;
+    npu::CoreConfig cfg;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg.substr(0, 7) == "--name=") {
+            name = arg.substr(7);
+        } else if (arg.substr(0, 4) == "--m=") {
+            m = std::stoi(arg.substr(4));
+        } else if (arg.substr(0, 4) == "--k=") {
+            k = std::stoi(arg.substr(4));
+        } else if (arg.substr(0, 4) == "--n=") {
+            n = std::stoi(arg.substr(4));
+        } else if (arg.substr(0, 8) == "--gemms=") {
+            gemms = std::stoi(arg.substr(8));
+        } else if (arg.substr(0, 8) == "--depth=") {
+            depth = std::stoi(arg.substr(8));
+        } else if (arg.substr(0, 8) == "--max-k=") {
+            cfg.max_k = std::stoi(arg.substr(8));
+        } else if (arg == "--sparse") {
+            cfg.sparse_stream = true;
+        } else if (arg == "--relu") {
+            cfg.relu = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--name=npu_cosim] [--m=M] [--k=K] [--n=N] [--gemms=G] [--depth=D] [--max-k=K]"
+                         " [--sparse] [--relu]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        std::cout << "Waiting for the simulation on channel " << name << "...\n";
+        npu::CosimHost host(cfg, name, depth);
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> dist(-128, 127);
+        const auto begin = std::chrono::steady_clock::now();
+        npu::TileStats stats;
+        for (int g = 0; g < gemms; ++g) {
+            npu::IntMatrix a(m, k);
+            npu::IntMatrix b(k, n);
+            for (auto& v : a.data) {
+                v = dist(rng);
+            }
+            for (auto& v : b.data) {
+                v = dist(rng);
+            }
+            npu::IntMatrix expected = npu::gemm_reference(a, b);
+            if (cfg.relu) {
+                for (auto& v : expected.data) {
+                    v = std::max(v, 0);
+                }
+            }
+            const npu::IntMatrix c = npu::Tiler(cfg, false, &host).run(a, b, &stats);
+            for (size_t i = 0; i < c.data.size(); ++i) {
+                if (c.data[i] != expected.data[i]) {
+                    std::cerr << "ERROR: GEMM " << g << " element (" << i / n << ", " << i % n << "): RTL "
+                              << c.data[i] << ", expected " << expected.data[i] << "\n";
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        host.close();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << gemms << " GEMMs of " << m << "x" << k << "x" << n << " matched: " << host.jobs()
+                  << " RTL jobs (depth " << host.depth() << ") in " << seconds << " s, model estimate "
+                  << stats.core_cycles << " core cycles\n";
+    } catch (const std::exception& error) {
+        std::cerr << "ERROR: " << error.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "vpi_user.h"
+
+#include "npu_cosim.hpp"
+
+// Icarus VPI module for tb/npu_cosim_tb.sv: attaches the simulation to the
+// shared-memory channel created by a CosimHost. Build it with
+//   iverilog-vpi --name=npu_cosim sw/npu_cosim_vpi.cpp
+// and load it with vvp -M . -m npu_cosim. The testbench calls:
+//   $npu_cosim_open(name, array_size, data_width, max_k, acc_width, sparse_stream, ok)
+//   $npu_cosim_poll(k_len)      k_len of the next job, 0 if none yet, -1 when the host is done
+//   $npu_cosim_beat(a, b)       loads the job's next beat into the packed lane vectors
+//   $npu_cosim_result(index, data, last)
+namespace {
+
+std::unique_ptr<npu::CosimDevice> g_channel;
+std::vector<int32_t> g_a_lanes;
+std::vector<int32_t> g_b_lanes;
+
+std::vector<vpiHandle> task_args() {
+    std::vector<vpiHandle> args;
+    vpiHandle iter = vpi_iterate(vpiArgument, vpi_handle(vpiSysTfCall, nullptr));
+    if (iter) {
+        while (vpiHandle arg = vpi_scan(iter)) {
+            args.push_back(arg);
+        }
+    }
+    return args;
+}
+
+int get_int(vpiHandle arg) {
+    s_vpi_value value;
+    value.format = vpiIntVal;
+    vpi_get_value(arg, &value);
+    return value.value.integer;
+}
+
+void put_int(vpiHandle arg, int v) {
+    s_vpi_value value;
+    value.format = vpiIntVal;
+    value.value.integer = v;
+    vpi_put_value(arg, &value, nullptr, vpiNoDelay);
+}
+
+// Packs lanes into a reg [lanes*width-1:0], lane 0 in the low bits
+void put_lanes(vpiHandle arg, const std::vector<int32_t>& lanes, int width) {
+    const int bits = vpi_get(vpiSize, arg);
+    std::vector<s_vpi_vecval> vec(static_cast<size_t>((bits + 31) / 32));
+    for (auto& word : vec) {
+        word.aval = 0;
+        word.bval = 0;
+    }
+    for (size_t lane = 0; lane < lanes.size(); ++lane) {
+        for (int bit = 0; bit < width; ++bit) {
+            const int pos = static_cast<int>(lane) * width + bit;
+            if (pos < bits && ((static_cast<uint32_t>(lanes[lane]) >> bit) & 1u)) {
+                vec[pos / 32].aval |= static_cast<PLI_INT32>(1u << (pos % 32));
+            }
+        }
+    }
+    s_vpi_value value;
+    value.format = vpiVectorVal;
+    value.value.vector = vec.data();
+    vpi_put_value(arg, &value, nullptr, vpiNoDelay);
+}
+
+// Reports the error and stops the simulation
+void fail(const char* task, const char* message) {
+    vpi_printf(const_cast<PLI_BYTE8*>("ERROR: %s: %s\n"), task, message);
+    vpi_control(vpiFinish, 1);
+}
+
+PLI_INT32 open_calltf(PLI_BYTE8*) {
+    const std::vector<vpiHandle> args = task_args();
+    if (args.size() != 7) {
+        fail("$npu_cosim_open", "expects (name, array_size, data_width, max_k, acc_width, sparse_stream, ok)");
+        return 0;
+    }
+    s_vpi_value name;
+    name.format = vpiStringVal;
+    vpi_get_value(args[0], &name);
+    npu::CosimParams params;
+    params.array_size = get_int(args[1]);
+    params.data_width = get_int(args[2]);
+    params.max_k = get_int(args[3]);
+    params.acc_width = get_int(args[4]);
+    params.sparse_stream = get_int(args[5]);
+    try {
+        g_channel = std::make_unique<npu::CosimDevice>(name.value.str, params);
+        put_int(args[6], 1);
+    } catch (const std::exception& error) {
+        vpi_printf(const_cast<PLI_BYTE8*>("ERROR: $npu_cosim_open: %s\n"), error.what());
+        put_int(args[6], 0);
+    }
+    return 0;
+}
+
+PLI_INT32 poll_calltf(PLI_BYTE8*) {
+    const std::vector<vpiHandle> args = task_args();
+    if (!g_channel || args.size() != 1) {
+        fail("$npu_cosim_poll", "needs an open channel and one output argument");
+        return 0;
+    }
+    put_int(args[0], g_channel->poll_job());
+    return 0;
+}
+
+PLI_INT32 beat_calltf(PLI_BYTE8*) {
+    const std::vector<vpiHandle> args = task_args();
+    if (!g_channel || args.size() != 2) {
+        fail("$npu_cosim_beat", "needs an open channel and (a_stream, b_stream)");
+        return 0;
+    }
+    try {
+        g_channel->next_beat(g_a_lanes, g_b_lanes);
+    } catch (const std::exception& error) {
+        fail("$npu_cosim_beat", error.what());
+        return 0;
+    }
+    const int width = vpi_get(vpiSize, args[0]) / static_cast<int>(g_a_lanes.size());
+    put_lanes(args[0], g_a_lanes, width);
+    put_lanes(args[1], g_b_lanes, width);
+    return 0;
+}
+
+PLI_INT32 result_calltf(PLI_BYTE8*) {
+    const std::vector<vpiHandle> args = task_args();
+    if (!g_channel || args.size() != 3) {
+        fail("$npu_cosim_result", "needs an open channel and (index, data, last)");
+        return 0;
+    }
+    try {
+        g_channel->put_result(get_int(args[0]), static_cast<uint32_t>(get_int(args[1])), get_int(args[2]) != 0);
+    } catch (const std::exception& error) {
+        fail("$npu_cosim_result", error.what());
+    }
+    return 0;
+}
+
+void register_task(const char* name, PLI_INT32 (*calltf)(PLI_BYTE8*)) {
+    s_vpi_systf_data task = {};
+    task.type = vpiSysTask;
+    task.tfname = const_cast<PLI_BYTE8*>(name);
+    task.calltf = calltf;
+    vpi_register_systf(&task);
+}
+
+void register_cosim_tasks() {
+    register_task("$npu_cosim_open", open_calltf);
+    register_task("$npu_cosim_poll", poll_calltf);
+    register_task("$npu_cosim_beat", beat_calltf);
+    register_task("$npu_cosim_result", result_calltf);
+}
+
+} // namespace
+
+extern "C" {
+void (*vlog_startup_routines[])() = {register_cosim_tasks, nullptr};
+}
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "npu_model.hpp"
+
+// Host driver model for rtl/npu_cmdproc.sv: local memory image, descriptor
+// encoding, a command processor model and a GEMM -> descriptor chain builder.
+namespace npu {
+
+// ============================================================================
+// Descriptor Format (must match rtl/npu_cmdproc.sv)
+// ============================================================================
+
+constexpr int kDescriptorWords = 4;
+constexpr uint32_t kCtrlKMask    = 0xFFFFu;
+constexpr uint32_t kCtrlReluBit  = 1u << 16;
+constexpr uint32_t kCtrlIrqBit   = 1u << 17;
+constexpr uint32_t kCtrlSparseABit = 1u << 18;
+constexpr uint32_t kCtrlValidBit = 1u << 31;
+
+struct Descriptor {
+    uint32_t a_addr = 0;
+    uint32_t b_addr = 0;
+    uint32_t c_addr = 0;
+    uint32_t k_len = 0;
+    bool relu = false;
+    bool irq = false;
+    bool sparse_a = false; // A panel holds k_len non-zero columns + k-index map
+    bool valid = true;
+};
+
+// Words of the k-index map that follows a compressed A panel (MAX_K bits)
+inline int k_map_words(const CoreConfig& cfg) {
+    return (cfg.max_k + 31) / 32;
+}
+
+inline uint32_t encode_control(const Descriptor& d) {
+    uint32_t ctrl = d.k_len & kCtrlKMask;
+    if (d.relu) ctrl |= kCtrlReluBit;
+    if (d.irq) ctrl |= kCtrlIrqBit;
+    if (d.sparse_a) ctrl |= kCtrlSparseABit;
+    if (d.valid) ctrl |= kCtrlValidBit;
+    return ctrl;
+}
+
+inline Descriptor decode_descriptor(const uint32_t* words) {
+    Descriptor d;
+    d.a_addr = words[0];
+    d.b_addr = words[1];
+    d.c_addr = words[2];
+    d.k_len = words[3] & kCtrlKMask;
+    d.relu = (words[3] & kCtrlReluBit) != 0;
+    d.irq = (words[3] & kCtrlIrqBit) != 0;
+    d.sparse_a = (words[3] & kCtrlSparseABit) != 0;
+    d.valid = (words[3] & kCtrlValidBit) != 0;
+    return d;
+}
+
+// ============================================================================
+// Local Memory
+// ============================================================================
+
+// Word-addressed image of the command processor's local memory (WORD_WIDTH = 32)
+class LocalMemory {
+public:
+    explicit LocalMemory(std::size_t words) : words_(words, 0) {}
+
+    std::size_t size() const { return words_.size(); }
+
+    uint32_t read(uint32_t addr) const { return words_.at(addr); }
+    void write(uint32_t addr, uint32_t value) { words_.at(addr) = value; }
+
+    // Simple bump allocator used by the chain builder
+    uint32_t allocate(std::size_t words) {
+        if (next_free_ + words > words_.size()) {
+            throw std::length_error("LocalMemory: out of space");
+        }
+        const uint32_t base = static_cast<uint32_t>(next_free_);
+        next_free_ += words;
+        return base;
+    }
+
+    void reset_allocator(std::size_t first_free) { next_free_ = first_free; }
+
+private:
+    std::vector<uint32_t> words_;
+    std::size_t next_free_ = 0;
+};
+
+// Pack one beat (ARRAY_SIZE int8 lanes) into a memory word, lane 0 in the LSBs
+inline uint32_t pack_lanes(const int32_t* values, int lanes, int data_width) {
+    uint32_t word = 0;
+    const uint32_t mask = (1u << data_width) - 1u;
+    for (int i = 0; i < lanes; ++i) {
+        word |= (static_cast<uint32_t>(values[i]) & mask) << (i * data_width);
+    }
+    return word;
+}
+
+// ============================================================================
+// Command Processor Model
+// ============================================================================
+
+struct CommandProcessorStats {
+    uint64_t descriptors = 0;
+    uint64_t cycles = 0;
+    uint64_t irqs = 0;
+};
+
+// Executes descriptors between head and tail exactly like npu_cmdproc:
+// fetch, run the core for k_len beats, write results and clear the valid bit.
+class CommandProcessorModel {
+public:
+    CommandProcessorModel(const CoreConfig& cfg, LocalMemory& mem, uint32_t ring_base, int ring_entries)
+        : cfg_(cfg), mem_(mem), ring_base_(ring_base), ring_entries_(ring_entries), core_(raw_config(cfg)) {
+        if (cfg.array_size * cfg.data_width > 32 || acc_width(cfg) > 32) {
+            throw std::invalid_argument("CommandProcessorModel: beats and results must fit 32-bit words");
+        }
+        if (cfg.int4_weights) {
+            throw std::invalid_argument("CommandProcessorModel: npu_cmdproc runs the core in int8 mode");
+        }
+        if (cfg.num_cores != 1) {
+            throw std::invalid_argument("CommandProcessorModel: npu_cmdproc drives a single core");
+        }
+        if (cfg.back_to_back) {
+            throw std::invalid_argument("CommandProcessorModel: npu_cmdproc starts each job after the previous drain");
+        }
+        if (cfg.operand_reuse) {
+            throw std::invalid_argument("CommandProcessorModel: npu_cmdproc fetches A and B for every descriptor");
+        }
+    }
+
+    int head() const { return head_; }
+    int tail() const { return tail_; }
+    bool idle() const { return head_ == tail_; }
+    const CommandProcessorStats& stats() const { return stats_; }
+
+    void doorbell(int tail) { tail_ = tail % ring_entries_; }
+
+    // Cycles per descriptor: idle check + descriptor fetch (DESC_WORDS reads
+    // plus one cycle of read latency), the k-index map fetch for sparse A,
+    // the core job with one extra cycle of operand read latency, and the
+    // status write-back.
+    int descriptor_cycles(int k_len, bool sparse_a = false) const {
+        const int map_fetch = sparse_a ? k_map_words(cfg_) + 1 : 0;
+        return 1 + (kDescriptorWords + 1) + map_fetch + tile_cycles(cfg_, k_len) + 1 + 1;
+    }
+
+    // Run until the ring is empty
+    void run() {
+        while (head_ != tail_) {
+            step();
+        }
+    }
+
+    void step() {
+        const uint32_t desc_addr = ring_base_ + static_cast<uint32_t>(head_ * kDescriptorWords);
+        uint32_t words[kDescriptorWords];
+        for (int w = 0; w < kDescriptorWords; ++w) {
+            words[w] = mem_.read(desc_addr + w);
+        }
+        const Descriptor d = decode_descriptor(words);
+        const int k_len = std::clamp(static_cast<int>(d.k_len), 1, cfg_.max_k);
+        const int n = cfg_.array_size;
+
+        // B row for each beat: the next set bit of the k-index map, or k itself
+        std::vector<int> b_rows(k_len);
+        for (int k = 0; k < k_len; ++k) {
+            b_rows[k] = k;
+        }
+        if (d.sparse_a) {
+            int beat = 0;
+            for (int w = 0; w < k_map_words(cfg_) && beat < k_len; ++w) {
+                const uint32_t map = mem_.read(d.a_addr + k_len + w);
+                for (int bit = 0; bit < 32 && beat < k_len; ++bit) {
+                    if (map & (1u << bit)) {
+                        b_rows[beat++] = w * 32 + bit;
+                    }
+                }
+            }
+        }
+
+        IntMatrix a_tile(n, k_len);
+        IntMatrix b_tile(k_len, n);
+        for (int k = 0; k < k_len; ++k) {
+            const uint32_t a_word = mem_.read(d.a_addr + k);
+            const uint32_t b_word = mem_.read(d.b_addr + b_rows[k]);
+            for (int lane = 0; lane < n; ++lane) {
+                a_tile.at(lane, k) = unpack_lane(a_word, lane);
+                b_tile.at(k, lane) = unpack_lane(b_word, lane);
+            }
+        }
+
+        const IntMatrix c_tile = core_.run_tile(a_tile, b_tile);
+        for (int idx = 0; idx < output_count(cfg_); ++idx) {
+            int32_t value = c_tile.data[idx];
+            if (d.relu && value < 0) {
+                value = 0;
+            }
+            mem_.write(d.c_addr + idx, static_cast<uint32_t>(value));
+        }
+
+        mem_.write(desc_addr + kDescriptorWords - 1, words[kDescriptorWords - 1] & ~kCtrlValidBit);
+        stats_.descriptors += 1;
+        stats_.cycles += static_cast<uint64_t>(descriptor_cycles(k_len, d.sparse_a));
+        if (d.irq) {
+            stats_.irqs += 1;
+        }
+        head_ = (head_ + 1) % ring_entries_;
+    }
+
+private:
+    static CoreConfig raw_config(CoreConfig cfg) {
+        cfg.relu = false; // activation is per descriptor, applied on write-back
+        return cfg;
+    }
+
+    int32_t unpack_lane(uint32_t word, int lane) const {
+        const int width = cfg_.data_width;
+        int32_t value = static_cast<int32_t>((word >> (lane * width)) & ((1u << width) - 1u));
+        if (value & (1 << (width - 1))) {
+            value -= (1 << width);
+        }
+        return value;
+    }
+
+    CoreConfig cfg_;
+    LocalMemory& mem_;
+    uint32_t ring_base_;
+    int ring_entries_;
+    int head_ = 0;
+    int tail_ = 0;
+    CoreModel core_;
+    CommandProcessorStats stats_;
+};
+
+// ============================================================================
+// GEMM Descriptor Chains
+// ============================================================================
+
+// Places packed operand panels and per-tile result buffers for C = A * B in
+// local memory and emits one descriptor per ARRAY_SIZE x ARRAY_SIZE output
+// tile. K must fit a single job (K <= MAX_K), so no host accumulation is needed.
+// With skip_zero_k, an A panel whose tile rows have all-zero columns is stored
+// compressed with its k-index map, and its descriptors only issue those beats.
+struct GemmChain {
+    int m = 0;
+    int n = 0;
+    std::vector<Descriptor> descriptors;
+    std::vector<uint32_t> tile_c_addr; // row-major over output tiles
+};
+
+inline GemmChain build_gemm_chain(const CoreConfig& cfg, LocalMemory& mem,
+                                  const IntMatrix& a, const IntMatrix& b, bool relu,
+                                  bool skip_zero_k = false) {
+    if (a.cols != b.rows) {
+        throw std::invalid_argument("build_gemm_chain: inner dimensions differ");
+    }
+    if (a.cols > cfg.max_k) {
+        throw std::invalid_argument("build_gemm_chain: K exceeds MAX_K");
+    }
+    const int n = cfg.array_size;
+    const int k_len = a.cols;
+    const int tile_rows = (a.rows + n - 1) / n;
+    const int tile_cols = (b.cols + n - 1) / n;
+
+    GemmChain chain;
+    chain.m = a.rows;
+    chain.n = b.cols;
+
+    // A panels: one per tile row, word i = A[i0.., k_i]; B panels: one per tile column
+    std::vector<uint32_t> a_panel(tile_rows);
+    std::vector<int> a_beats(tile_rows, k_len);
+    std::vector<uint32_t> b_panel(tile_cols);
+    std::vector<int32_t> lanes(n);
+    for (int tr = 0; tr < tile_rows; ++tr) {
+        std::vector<int> k_beats(k_len);
+        for (int k = 0; k < k_len; ++k) {
+            k_beats[k] = k;
+        }
+        if (skip_zero_k) {
+            const std::vector<int> kept = nonzero_k_beats(a, tr * n, n);
+            if (static_cast<int>(kept.size()) < k_len) {
+                k_beats = kept;
+            }
+        }
+        const bool sparse = static_cast<int>(k_beats.size()) < k_len;
+        a_beats[tr] = static_cast<int>(k_beats.size());
+        a_panel[tr] = mem.allocate(k_beats.size() + (sparse ? k_map_words(cfg) : 0));
+        for (int i = 0; i < a_beats[tr]; ++i) {
+            for (int lane = 0; lane < n; ++lane) {
+                const int row = tr * n + lane;
+                lanes[lane] = (row < a.rows) ? a.at(row, k_beats[i]) : 0;
+            }
+            mem.write(a_panel[tr] + i, pack_lanes(lanes.data(), n, cfg.data_width));
+        }
+        if (sparse) {
+            std::vector<uint32_t> map(k_map_words(cfg), 0);
+            for (int k : k_beats) {
+                map[k / 32] |= 1u << (k % 32);
+            }
+            for (int w = 0; w < k_map_words(cfg); ++w) {
+                mem.write(a_panel[tr] + a_beats[tr] + w, map[w]);
+            }
+        }
+    }
+    for (int tc = 0; tc < tile_cols; ++tc) {
+        b_panel[tc] = mem.allocate(k_len);
+        for (int k = 0; k < k_len; ++k) {
+            for (int lane = 0; lane < n; ++lane) {
+                const int col = tc * n + lane;
+                lanes[lane] = (col < b.cols) ? b.at(k, col) : 0;
+            }
+            mem.write(b_panel[tc] + k, pack_lanes(lanes.data(), n, cfg.data_width));
+        }
+    }
+
+    for (int tr = 0; tr < tile_rows; ++tr) {
+        for (int tc = 0; tc < tile_cols; ++tc) {
+            Descriptor d;
+            d.a_addr = a_panel[tr];
+            d.b_addr = b_panel[tc];
+            d.c_addr = mem.allocate(static_cast<std::size_t>(output_count(cfg)));
+            d.k_len = static_cast<uint32_t>(a_beats[tr]);
+            d.relu = relu;
+            d.sparse_a = a_beats[tr] < k_len;
+            chain.tile_c_addr.push_back(d.c_addr);
+            chain.descriptors.push_back(d);
+        }
+    }
+    if (!chain.descriptors.empty()) {
+        chain.descriptors.back().irq = true;
+    }
+    return chain;
+}
+
+// Gather the per-tile result buffers back into an M x N matrix
+inline IntMatrix collect_gemm_chain(const CoreConfig& cfg, const LocalMemory& mem, const GemmChain& chain) {
+    const int n = cfg.array_size;
+    const int tile_cols = (chain.n + n - 1) / n;
+    IntMatrix c(chain.m, chain.n);
+    for (std::size_t t = 0; t < chain.tile_c_addr.size(); ++t) {
+        const int tr = static_cast<int>(t) / tile_cols;
+        const int tc = static_cast<int>(t) % tile_cols;
+        for (int r = 0; r < n && (tr * n + r) < chain.m; ++r) {
+            for (int col = 0; col < n && (tc * n + col) < chain.n; ++col) {
+                c.at(tr * n + r, tc * n + col) =
+                    static_cast<int32_t>(mem.read(chain.tile_c_addr[t] + r * n + col));
+            }
+        }
+    }
+    return c;
+}
+
+// Streams a descriptor chain through a ring of ring_entries slots. The host
+// only writes descriptors into free slots and rings the doorbell; it is not
+// involved per tile. Returns the number of doorbell writes issued.
+inline uint64_t submit_chain(CommandProcessorModel& cp, LocalMemory& mem, uint32_t ring_base,
+                             int ring_entries, const std::vector<Descriptor>& chain) {
+    uint64_t doorbells = 0;
+    std::size_t next = 0;
+    int tail = cp.tail();
+    while (next < chain.size()) {
+        // One slot stays empty so head == tail always means "ring empty"
+        while (next < chain.size() && ((tail + 1) % ring_entries) != cp.head()) {
+            const uint32_t slot = ring_base + static_cast<uint32_t>(tail * kDescriptorWords);
+            const Descriptor& d = chain[next++];
+            mem.write(slot + 0, d.a_addr);
+            mem.write(slot + 1, d.b_addr);
+            mem.write(slot + 2, d.c_addr);
+            mem.write(slot + 3, encode_control(d));
+            tail = (tail + 1) % ring_entries;
+        }
+        cp.doorbell(tail);
+        ++doorbells;
+        cp.run();
+    }
+    return doorbells;
+}
+
+} // namespace npu
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "npu_gemm.hpp"
+#include "npu_host.hpp"
+
+// Lazy expressions over the host kernels. npu::lazy::gemm, quantize, relu,
+// requantize and dequantize build an expression tree instead of a matrix, and
+// nothing is computed until evaluate() writes it into a view. Evaluation
+// works element by element, so a chain of elementwise ops is one pass. A
+// GEMM operand that is itself an expression, e.g. gemm(quantize(x), w), is
+// evaluated once into a buffer before the product, like packing.
+//
+// A GEMM of two int8 operands is lowered onto gemm_packed when evaluation
+// starts, with a ReLU directly above it fused into GemmEpilogue; the tail
+// above that reads the int32 result. Other GEMMs compute each element's dot
+// product on demand.
+//
+//   lazy::evaluate(y.view(), lazy::dequantize(lazy::relu(lazy::gemm(a.view(), w.view())), acc_params));
+namespace npu {
+namespace lazy {
+
+// ============================================================================
+// Expression Nodes
+// ============================================================================
+
+struct ExprBase {};
+
+template <typename E>
+constexpr bool is_expr = std::is_base_of<ExprBase, std::decay_t<E>>::value;
+
+// A matrix already in memory
+template <typename T>
+struct Leaf : ExprBase {
+    using value_type = std::remove_const_t<T>;
+    MatrixView<const value_type> view;
+
+    int rows() const { return view.rows(); }
+    int cols() const { return view.cols(); }
+};
+
+// op applied to every element of inner
+template <typename Inner, typename Op>
+struct Map : ExprBase {
+    using value_type = decltype(std::declval<Op>()(std::declval<typename Inner::value_type>()));
+    Inner inner;
+    Op op;
+
+    int rows() const { return inner.rows(); }
+    int cols() const { return inner.cols(); }
+};
+
+// A * B, accumulated in int32 for integer operands and float otherwise
+template <typename A, typename B>
+struct Gemm : ExprBase {
+    using operand_type = std::common_type_t<typename A::value_type, typename B::value_type>;
+    using value_type = std::conditional_t<std::is_floating_point<operand_type>::value, operand_type, int32_t>;
+    A a;
+    B b;
+
+    int rows() const { return a.rows(); }
+    int cols() const { return b.cols(); }
+};
+
+// ============================================================================
+// Elementwise Ops
+// ============================================================================
+
+struct QuantizeOp {
+    QuantParams params;
+    int8_t operator()(float value) const { return npu::quantize(value, params); }
+};
+
+struct DequantizeOp {
+    QuantParams params;
+    float operator()(int32_t value) const { return npu::dequantize(value, params); }
+};
+
+struct ReluOp {
+    template <typename V>
+    V operator()(V value) const { return value < V{} ? V{} : value; }
+};
+
+// int32 accumulator to int8 at a new scale: round(value * multiplier), clamped
+struct RequantizeOp {
+    float multiplier;
+    int8_t operator()(int32_t value) const {
+        const long q = std::lround(static_cast<float>(value) * multiplier);
+        return static_cast<int8_t>(q < kInt8Min ? kInt8Min : (q > kInt8Max ? kInt8Max : q));
+    }
+};
+
+// ============================================================================
+// Builders
+// ============================================================================
+
+template <typename T>
+Leaf<T> matrix(MatrixView<T> view) {
+    return {{}, MatrixView<const std::remove_const_t<T>>(view)};
+}
+
+// Wraps a view as a leaf; expressions pass through unchanged
+template <typename E, typename = std::enable_if_t<is_expr<E>>>
+E as_expr(E expr) {
+    return expr;
+}
+template <typename T>
+Leaf<T> as_expr(MatrixView<T> view) {
+    return matrix(view);
+}
+
+template <typename E>
+auto quantize(E expr, const QuantParams& params) {
+    auto inner = as_expr(expr);
+    return Map<decltype(inner), QuantizeOp>{{}, inner, QuantizeOp{params}};
+}
+
+template <typename E>
+auto dequantize(E expr, const QuantParams& params) {
+    auto inner = as_expr(expr);
+    return Map<decltype(inner), DequantizeOp>{{}, inner, DequantizeOp{params}};
+}
+
+template <typename E>
+auto relu(E expr) {
+    auto inner = as_expr(expr);
+    return Map<decltype(inner), ReluOp>{{}, inner, ReluOp{}};
+}
+
+template <typename E>
+auto requantize(E expr, float multiplier) {
+    auto inner = as_expr(expr);
+    return Map<decltype(inner), RequantizeOp>{{}, inner, RequantizeOp{multiplier}};
+}
+
+template <typename EA, typename EB>
+auto gemm(EA a_expr, EB b_expr) {
+    auto a = as_expr(a_expr);
+    auto b = as_expr(b_expr);
+    if (a.cols() != b.rows()) {
+        throw std::invalid_argument("lazy::gemm: inner dimensions differ");
+    }
+    return Gemm<decltype(a), decltype(b)>{{}, a, b};
+}
+
+// ============================================================================
+// Evaluation
+// ============================================================================
+
+// An evaluator is built when an expression is assigned. It owns any operand
+// buffers the expression needs and yields one element per coeff() call.
+template <typename E>
+struct Evaluator;
+
+template <typename T>
+struct Evaluator<Leaf<T>> {
+    explicit Evaluator(const Leaf<T>& leaf) : view(leaf.view) {}
+    typename Leaf<T>::value_type coeff(int r, int c) const { return view.at(r, c); }
+    MatrixView<const typename Leaf<T>::value_type> view;
+};
+
+template <typename Inner, typename Op>
+struct MapEvaluator {
+    explicit MapEvaluator(const Map<Inner, Op>& map) : inner(map.inner), op(map.op) {}
+    typename Map<Inner, Op>::value_type coeff(int r, int c) const { return op(inner.coeff(r, c)); }
+    Evaluator<Inner> inner;
+    Op op;
+};
+
+template <typename Inner, typename Op>
+struct Evaluator<Map<Inner, Op>> : MapEvaluator<Inner, Op> {
+    using MapEvaluator<Inner, Op>::MapEvaluator;
+};
+
+// GEMM operand: a leaf is read in place, anything else is evaluated once
+template <typename E>
+struct Operand {
+    using value_type = typename E::value_type;
+    explicit Operand(const E& expr) : storage(expr.rows(), expr.cols()) {
+        const Evaluator<E> eval(expr);
+        for (int r = 0; r < expr.rows(); ++r) {
+            for (int c = 0; c < expr.cols(); ++c) {
+                storage.at(r, c) = eval.coeff(r, c);
+            }
+        }
+        view = storage.view();
+    }
+    // A copy reads its own storage, not the original's
+    Operand(const Operand& other) : storage(other.storage), view(storage.view()) {}
+    Operand& operator=(const Operand& other) {
+        storage = other.storage;
+        view = storage.view();
+        return *this;
+    }
+    HostMatrix<value_type> storage;
+    MatrixView<const value_type> view;
+};
+
+template <typename T>
+struct Operand<Leaf<T>> {
+    explicit Operand(const Leaf<T>& leaf) : view(leaf.view) {}
+    MatrixView<const typename Leaf<T>::value_type> view;
+};
+
+// True when both operands of A * B evaluate to int8, so gemm_packed applies
+template <typename A, typename B>
+constexpr bool packed_gemm =
+    std::is_same<typename A::value_type, int8_t>::value && std::is_same<typename B::value_type, int8_t>::value;
+
+// Dot product per element, for operands gemm_packed does not take
+template <typename A, typename B>
+struct DotEvaluator {
+    using value_type = typename Gemm<A, B>::value_type;
+    explicit DotEvaluator(const Gemm<A, B>& gemm) : a(gemm.a), b(gemm.b) {}
+    value_type coeff(int r, int c) const {
+        value_type sum{};
+        for (int k = 0; k < a.view.cols(); ++k) {
+            sum += static_cast<value_type>(a.view.at(r, k)) * static_cast<value_type>(b.view.at(k, c));
+        }
+        return sum;
+    }
+    Operand<A> a;
+    Operand<B> b;
+};
+
+// int8 product computed once by gemm_packed with the epilogue fused
+template <typename A, typename B>
+struct PackedEvaluator {
+    PackedEvaluator(const Gemm<A, B>& gemm, const GemmEpilogue& epilogue = {}) : result(gemm.rows(), gemm.cols()) {
+        const Operand<A> a(gemm.a);
+        const Operand<B> b(gemm.b);
+        const PackedB packed(b.view, Transpose::No, AllocOptions{});
+        gemm_packed(a.view, packed, result.view(), epilogue);
+    }
+    int32_t coeff(int r, int c) const { return result.at(r, c); }
+    HostMatrix<int32_t> result;
+};
+
+template <typename A, typename B>
+struct Evaluator<Gemm<A, B>>
+    : std::conditional_t<packed_gemm<A, B>, PackedEvaluator<A, B>, DotEvaluator<A, B>> {
+    explicit Evaluator(const Gemm<A, B>& gemm)
+        : std::conditional_t<packed_gemm<A, B>, PackedEvaluator<A, B>, DotEvaluator<A, B>>(gemm) {}
+};
+
+// relu(gemm(a, b)) on int8 operands: the ReLU runs in gemm_packed's epilogue
+template <typename A, typename B>
+struct FusedReluEvaluator : PackedEvaluator<A, B> {
+    explicit FusedReluEvaluator(const Map<Gemm<A, B>, ReluOp>& map) : PackedEvaluator<A, B>(map.inner, relu_epilogue()) {}
+    static GemmEpilogue relu_epilogue() {
+        GemmEpilogue epilogue;
+        epilogue.relu = true;
+        return epilogue;
+    }
+};
+
+template <typename A, typename B>
+struct Evaluator<Map<Gemm<A, B>, ReluOp>>
+    : std::conditional_t<packed_gemm<A, B>, FusedReluEvaluator<A, B>, MapEvaluator<Gemm<A, B>, ReluOp>> {
+    explicit Evaluator(const Map<Gemm<A, B>, ReluOp>& map)
+        : std::conditional_t<packed_gemm<A, B>, FusedReluEvaluator<A, B>, MapEvaluator<Gemm<A, B>, ReluOp>>(map) {}
+};
+
+// Computes expr into out in one pass. out must not overlap a GEMM operand
+// that is read in place.
+template <typename T, typename E>
+void evaluate(MatrixView<T> out, const E& expr) {
+    static_assert(is_expr<E>, "evaluate: not a lazy expression");
+    if (out.rows() != expr.rows() || out.cols() != expr.cols()) {
+        throw std::invalid_argument("lazy::evaluate: output shape differs from the expression");
+    }
+    const Evaluator<E> eval(expr);
+    for (int r = 0; r < out.rows(); ++r) {
+        for (int c = 0; c < out.cols(); ++c) {
+            out.at(r, c) = static_cast<T>(eval.coeff(r, c));
+        }
+    }
+}
+
+// Evaluates into a new matrix of the expression's element type
+template <typename E>
+HostMatrix<typename E::value_type> materialize(const E& expr) {
+    HostMatrix<typename E::value_type> out(expr.rows(), expr.cols());
+    evaluate(out.view(), expr);
+    return out;
+}
+
+} // namespace lazy
+} // namespace npu
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "npu_alloc.hpp"
+#include "npu_host.hpp"
+#include "npu_jit.hpp"
+#include "npu_pool.hpp"
+
+// Multithreaded host GEMM. C is split into row strips that run on a
+// ThreadPool; strip s is homed on node pool.home_node(s, strips), so
+// buffers placed with pool.first_touch(..., strip bytes) are read and
+// written by workers on their own node.
+//
+// gemm_packed is the fast int8 path: B is packed once into kJitCols-wide
+// panels of int16 k pairs (PackedB), each kJitRows-row strip of A is packed
+// the same way, and a microkernel computes one kJitRows x kJitCols tile of
+// C over the whole K with the epilogue fused. The microkernel is generated
+// for the exact tile shape when the JIT is available (npu_jit.hpp), and is
+// the portable static_microkernel otherwise; both give identical results.
+// Either operand may be stored transposed: the packers read each layout in
+// its own order, so NN, NT, TN and TT products need no transpose copy.
+namespace npu {
+
+// Rows of C per work item: whole microkernel strips
+constexpr int kGemmStripRows = 6 * kJitRows;
+
+inline int gemm_strips(int rows, int strip_rows = kGemmStripRows) {
+    return (rows + strip_rows - 1) / strip_rows;
+}
+
+// ============================================================================
+// Packing
+// ============================================================================
+
+// K x N int8-range weights as int16 k pairs in kJitCols-wide panels:
+// element (k, n) is at ((n / kJitCols * k_pairs + k / 2) * kJitCols + n % kJitCols) * 2 + k % 2.
+// Odd K and the last panel's missing columns are zero padded. Stored in a
+// huge-page PageBuffer, as packed weights are large and long-lived.
+// With Transpose::Yes, b is the stored B^T (N x K). Packing walks whichever
+// layout b has, so B held transposed is read along its rows, not gathered.
+class PackedB {
+public:
+    PackedB() = default;
+
+    template <typename T>
+    explicit PackedB(MatrixView<T> stored, Transpose tb = Transpose::No, const AllocOptions& options = huge_pages()) {
+        const MatrixView<T> b = transpose_if(stored, tb);
+        k_ = b.rows();
+        n_ = b.cols();
+        k_pairs_ = (k_ + 1) / 2;
+        panels_ = (n_ + kJitCols - 1) / kJitCols;
+        buffer_ = PageBuffer(static_cast<std::size_t>(panels_) * k_pairs_ * kJitCols * 2 * sizeof(int16_t), options);
+        int16_t* out = static_cast<int16_t*>(buffer_.data());
+        auto put = [&](int k, int n) {
+            out[(static_cast<std::size_t>(n / kJitCols) * k_pairs_ + k / 2) * kJitCols * 2 + (n % kJitCols) * 2 +
+                k % 2] = static_cast<int16_t>(b.at(k, n));
+        };
+        if (b.column_major()) {
+            for (int n = 0; n < n_; ++n) {
+                for (int k = 0; k < k_; ++k) {
+                    put(k, n);
+                }
+            }
+            return;
+        }
+        for (int k = 0; k < k_; ++k) {
+            for (int n = 0; n < n_; ++n) {
+                put(k, n);
+            }
+        }
+    }
+
+    int rows() const { return k_; }
+    int cols() const { return n_; }
+    int k_pairs() const { return k_pairs_; }
+    int panels() const { return panels_; }
+    const int16_t* panel(int p) const {
+        return static_cast<const int16_t*>(buffer_.data()) + static_cast<std::size_t>(p) * k_pairs_ * kJitCols * 2;
+    }
+
+private:
+    static AllocOptions huge_pages() {
+        AllocOptions options;
+        options.pages = PageSize::Huge2M;
+        return options;
+    }
+
+    int k_ = 0;
+    int n_ = 0;
+    int k_pairs_ = 0;
+    int panels_ = 0;
+    PageBuffer buffer_;
+};
+
+// Packs rows [r0, r0 + rows) of A (rows <= kJitRows) as int16 k pairs,
+// kJitRows per pair, into out (k_pairs * kJitRows * 2 entries). A column-major
+// A (the stored A^T of a TN product) is read down its columns.
+template <typename T>
+void pack_a_strip(MatrixView<T> a, int r0, int rows, int16_t* out) {
+    const int k_pairs = (a.cols() + 1) / 2;
+    std::fill(out, out + static_cast<std::size_t>(k_pairs) * kJitRows * 2, int16_t{0});
+    auto put = [&](int r, int k) {
+        out[(static_cast<std::size_t>(k / 2) * kJitRows + r) * 2 + k % 2] = static_cast<int16_t>(a.at(r0 + r, k));
+    };
+    if (a.column_major()) {
+        for (int k = 0; k < a.cols(); ++k) {
+            for (int r = 0; r < rows; ++r) {
+                put(r, k);
+            }
+        }
+        return;
+    }
+    for (int r = 0; r < rows; ++r) {
+        for (int k = 0; k < a.cols(); ++k) {
+            put(r, k);
+        }
+    }
+}
+
+// ============================================================================
+// Microkernels
+// ============================================================================
+
+// Fused output stage: C = relu(A * B + bias), each part optional
+struct GemmEpilogue {
+    const int32_t* bias = nullptr; // one entry per column of C
+    bool relu = false;
+};
+
+// Portable kernel for any tile shape, same operands and result as the JIT
+inline void static_microkernel(const JitShape& shape, const int16_t* a, const int16_t* b, int32_t* c,
+                               std::ptrdiff_t ldc, const int32_t* bias) {
+    int32_t acc[kJitRows][kJitCols] = {};
+    for (int kp = 0; kp < shape.k_pairs; ++kp) {
+        const int16_t* b_pair = b + static_cast<std::size_t>(kp) * kJitCols * 2;
+        for (int i = 0; i < kJitRows; ++i) {
+            const int32_t a0 = a[(kp * kJitRows + i) * 2];
+            const int32_t a1 = a[(kp * kJitRows + i) * 2 + 1];
+            for (int j = 0; j < kJitCols; ++j) {
+                acc[i][j] += a0 * b_pair[2 * j] + a1 * b_pair[2 * j + 1];
+            }
+        }
+    }
+    for (int i = 0; i < shape.mr; ++i) {
+        for (int j = 0; j < shape.nr; ++j) {
+            int32_t value = acc[i][j] + (shape.bias ? bias[j] : 0);
+            c[i * ldc + j] = shape.relu ? std::max(value, 0) : value;
+        }
+    }
+}
+
+// One tile shape's kernel: the generated code if there is one, else static
+struct Microkernel {
+    JitShape shape;
+    JitKernelFn jit = nullptr;
+
+    void operator()(const int16_t* a, const int16_t* b, int32_t* c, std::ptrdiff_t ldc, const int32_t* bias) const {
+        if (jit) {
+            jit(a, b, c, ldc, bias);
+        } else {
+            static_microkernel(shape, a, b, c, ldc, bias);
+        }
+    }
+};
+
+// The (at most four) tile shapes of an M x N output: full, short last
+// strip, narrow last panel, and the corner
+class GemmKernels {
+public:
+    GemmKernels(int m, int n, int k_pairs, const GemmEpilogue& epilogue, bool use_jit) {
+        const int m_edge = m % kJitRows;
+        const int n_edge = n % kJitCols;
+        for (int row = 0; row < 2; ++row) {
+            for (int col = 0; col < 2; ++col) {
+                Microkernel& kernel = kernels_[row][col];
+                kernel.shape.mr = row ? m_edge : kJitRows;
+                kernel.shape.nr = col ? n_edge : kJitCols;
+                kernel.shape.k_pairs = k_pairs;
+                kernel.shape.bias = epilogue.bias != nullptr;
+                kernel.shape.relu = epilogue.relu;
+                if (use_jit && kernel.shape.mr > 0 && kernel.shape.nr > 0) {
+                    kernel.jit = jit_kernels().kernel(kernel.shape);
+                }
+            }
+        }
+    }
+
+    const Microkernel& for_tile(int rows, int cols) const { return kernels_[rows < kJitRows][cols < kJitCols]; }
+
+private:
+    Microkernel kernels_[2][2];
+};
+
+// ============================================================================
+// Packed GEMM
+// ============================================================================
+
+namespace detail {
+
+// Rows [r0, r0 + rows) of C = A * B over panels [p0, p1) from the packed A
+// strip holding them. A C view whose columns are not contiguous gets each
+// tile through a small buffer.
+inline void gemm_packed_panels(const int16_t* a_strip, int r0, int rows, const PackedB& b, MatrixView<int32_t> c,
+                               const GemmEpilogue& epilogue, const GemmKernels& kernels, int p0, int p1) {
+    int32_t tile[kJitRows * kJitCols];
+    for (int p = p0; p < p1; ++p) {
+        const int c0 = p * kJitCols;
+        const int cols = std::min(kJitCols, b.cols() - c0);
+        const int32_t* bias = epilogue.bias ? epilogue.bias + c0 : nullptr;
+        const Microkernel& kernel = kernels.for_tile(rows, cols);
+        if (c.col_stride() == 1) {
+            kernel(a_strip, b.panel(p), &c.at(r0, c0), c.row_stride(), bias);
+            continue;
+        }
+        kernel(a_strip, b.panel(p), tile, kJitCols, bias);
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                c.at(r0 + i, c0 + j) = tile[i * kJitCols + j];
+            }
+        }
+    }
+}
+
+// Strips [s0, s1) of C = A * B over panels [p0, p1): packs each A strip
+// once and runs the kernel over the panels
+template <typename TA>
+void gemm_packed_strips(MatrixView<TA> a, const PackedB& b, MatrixView<int32_t> c, const GemmEpilogue& epilogue,
+                        const GemmKernels& kernels, int s0, int s1, int p0, int p1) {
+    std::vector<int16_t> a_strip(static_cast<std::size_t>(b.k_pairs()) * kJitRows * 2);
+    for (int s = s0; s < s1; ++s) {
+        const int r0 = s * kJitRows;
+        const int rows = std::min(kJitRows, a.rows() - r0);
+        pack_a_strip(a, r0, rows, a_strip.data());
+        gemm_packed_panels(a_strip.data(), r0, rows, b, c, epilogue, kernels, p0, p1);
+    }
+}
+
+template <typename TA>
+void check_packed_shapes(MatrixView<TA> a, const PackedB& b, MatrixView<int32_t> c) {
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        throw std::invalid_argument("gemm_packed: shapes do not match C = A * B");
+    }
+}
+
+} // namespace detail
+
+// C = epilogue(A * B) for int8-range A and packed B. use_jit = false forces
+// the static kernels.
+template <typename TA>
+void gemm_packed(MatrixView<TA> a, const PackedB& b, MatrixView<int32_t> c, const GemmEpilogue& epilogue = {},
+                 bool use_jit = true) {
+    detail::check_packed_shapes(a, b, c);
+    const GemmKernels kernels(a.rows(), b.cols(), b.k_pairs(), epilogue, use_jit);
+    detail::gemm_packed_strips(a, b, c, epilogue, kernels, 0, gemm_strips(a.rows(), kJitRows), 0, b.panels());
+}
+
+// C = epilogue(op(A) * B) on the stored A: with Transpose::Yes a is A^T
+// (K x M) and its strips are packed straight from it. B's flag is given
+// when packing it, so every NN/NT/TN/TT product runs without a copy.
+template <typename TA>
+void gemm_packed(Transpose ta, MatrixView<TA> a, const PackedB& b, MatrixView<int32_t> c,
+                 const GemmEpilogue& epilogue = {}, bool use_jit = true) {
+    gemm_packed(transpose_if(a, ta), b, c, epilogue, use_jit);
+}
+
+// ============================================================================
+// Parallel GEMM
+// ============================================================================
+
+// gemm_packed on the pool, kGemmStripRows rows of C per work item
+template <typename TA>
+void gemm_packed(ThreadPool& pool, MatrixView<TA> a, const PackedB& b, MatrixView<int32_t> c,
+                 const GemmEpilogue& epilogue = {}, bool use_jit = true) {
+    detail::check_packed_shapes(a, b, c);
+    const GemmKernels kernels(a.rows(), b.cols(), b.k_pairs(), epilogue, use_jit);
+    constexpr int kStrips = kGemmStripRows / kJitRows;
+    const int strips = gemm_strips(a.rows(), kJitRows);
+    pool.parallel_for(gemm_strips(strips, kStrips), [&](int item, int) {
+        detail::gemm_packed_strips(a, b, c, epilogue, kernels, item * kStrips, std::min(strips, (item + 1) * kStrips), 0,
+                                   b.panels());
+    });
+}
+
+template <typename TA>
+void gemm_packed(ThreadPool& pool, Transpose ta, MatrixView<TA> a, const PackedB& b, MatrixView<int32_t> c,
+                 const GemmEpilogue& epilogue = {}, bool use_jit = true) {
+    gemm_packed(pool, transpose_if(a, ta), b, c, epilogue, use_jit);
+}
+
+// ============================================================================
+// Grouped GEMM
+// ============================================================================
+
+// One product of a grouped GEMM: C = epilogue(A * B) with B packed
+template <typename TA>
+struct GemmProblem {
+    MatrixView<TA> a;
+    const PackedB* b = nullptr;
+    MatrixView<int32_t> c;
+    GemmEpilogue epilogue;
+};
+
+// Fewest panels per grouped work item, so queueing and kernel lookup stay
+// small next to its work
+constexpr int kGroupedMinPanels = 8;
+
+// Runs every problem on the pool as one workload, e.g. the experts of an MoE
+// layer with each expert's routed tokens as its M. Problems are cut into
+// items of up to kGemmStripRows rows by a range of panels, sized so items
+// carry similar work whatever the problem shapes, and queued largest first:
+// no worker is left finishing one big expert alone after the small ones.
+// Every A strip is packed once, in a parallel pass before the items run, so
+// items sharing rows over different panels read the same packed copy.
+template <typename TA>
+void gemm_grouped(ThreadPool& pool, const std::vector<GemmProblem<TA>>& problems, bool use_jit = true) {
+    struct Item {
+        int problem;
+        int s0, s1; // microkernel strips
+        int p0, p1; // panels
+        double macs;
+    };
+    std::vector<GemmKernels> kernels;
+    double total = 0.0;
+    for (const auto& problem : problems) {
+        if (!problem.b) {
+            throw std::invalid_argument("gemm_grouped: problem without packed B");
+        }
+        detail::check_packed_shapes(problem.a, *problem.b, problem.c);
+        kernels.emplace_back(problem.a.rows(), problem.b->cols(), problem.b->k_pairs(), problem.epilogue, use_jit);
+        total += static_cast<double>(problem.a.rows()) * problem.b->cols() * problem.b->rows();
+    }
+    // About eight items per worker leaves room to even out the tail
+    const double target = total / (8.0 * pool.size());
+    constexpr int kStrips = kGemmStripRows / kJitRows;
+    std::vector<Item> items;
+    std::vector<Item> packing; // one per row range, panels unused
+    std::vector<std::vector<int16_t>> packed_a(problems.size());
+    for (int i = 0; i < static_cast<int>(problems.size()); ++i) {
+        const PackedB& b = *problems[i].b;
+        const int strips = gemm_strips(problems[i].a.rows(), kJitRows);
+        packed_a[i].resize(static_cast<std::size_t>(strips) * b.k_pairs() * kJitRows * 2);
+        for (int s0 = 0; s0 < strips; s0 += kStrips) {
+            const int s1 = std::min(strips, s0 + kStrips);
+            const int rows = std::min(problems[i].a.rows(), s1 * kJitRows) - s0 * kJitRows;
+            const double panel_macs = static_cast<double>(rows) * kJitCols * b.rows();
+            packing.push_back({i, s0, s1, 0, 0, 0.0});
+            const int span = std::max(kGroupedMinPanels, static_cast<int>(target / std::max(panel_macs, 1.0)));
+            for (int p0 = 0; p0 < b.panels(); p0 += span) {
+                const int p1 = std::min(b.panels(), p0 + span);
+                items.push_back({i, s0, s1, p0, p1, panel_macs * (p1 - p0)});
+            }
+        }
+    }
+    auto strip = [&](int problem, int s) {
+        return packed_a[problem].data() + static_cast<std::size_t>(s) * problems[problem].b->k_pairs() * kJitRows * 2;
+    };
+    pool.parallel_for(static_cast<int>(packing.size()), [&](int index, int) {
+        const Item& item = packing[index];
+        const MatrixView<TA> a = problems[item.problem].a;
+        for (int s = item.s0; s < item.s1; ++s) {
+            pack_a_strip(a, s * kJitRows, std::min(kJitRows, a.rows() - s * kJitRows), strip(item.problem, s));
+        }
+    });
+    std::stable_sort(items.begin(), items.end(), [](const Item& x, const Item& y) { return x.macs > y.macs; });
+    pool.parallel_for(static_cast<int>(items.size()), [&](int index, int) {
+        const Item& item = items[index];
+        const GemmProblem<TA>& problem = problems[item.problem];
+        for (int s = item.s0; s < item.s1; ++s) {
+            const int r0 = s * kJitRows;
+            detail::gemm_packed_panels(strip(item.problem, s), r0, std::min(kJitRows, problem.a.rows() - r0),
+                                       *problem.b, problem.c, problem.epilogue, kernels[item.problem], item.p0,
+                                       item.p1);
+        }
+    });
+}
+
+// C = A * B on the pool
+template <typename TA, typename TB, typename TC>
+void gemm_parallel(ThreadPool& pool, MatrixView<TA> a, MatrixView<TB> b, MatrixView<TC> c,
+                   int strip_rows = kGemmStripRows) {
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        throw std::invalid_argument("gemm_parallel: shapes do not match C = A * B");
+    }
+    pool.parallel_for(gemm_strips(a.rows(), strip_rows), [&](int strip, int) {
+        const int r0 = strip * strip_rows;
+        const int rows = std::min(strip_rows, a.rows() - r0);
+        gemm(a.rows_slice(r0, rows), b, c.rows_slice(r0, rows));
+    });
+}
+
+// C = A * B with B replicated per node: each strip reads the copy local to
+// the worker that runs it, including stolen strips
+template <typename TA, typename TB, typename TC>
+void gemm_parallel(ThreadPool& pool, MatrixView<TA> a, const Replicated<TB>& b, MatrixView<TC> c,
+                   int strip_rows = kGemmStripRows) {
+    const MatrixView<const TB> b0 = b.for_node(0);
+    if (a.cols() != b0.rows() || c.rows() != a.rows() || c.cols() != b0.cols()) {
+        throw std::invalid_argument("gemm_parallel: shapes do not match C = A * B");
+    }
+    pool.parallel_for(gemm_strips(a.rows(), strip_rows), [&](int strip, int worker) {
+        const int r0 = strip * strip_rows;
+        const int rows = std::min(strip_rows, a.rows() - r0);
+        gemm(a.rows_slice(r0, rows), b.for_node(pool.worker_node(worker)), c.rows_slice(r0, rows));
+    });
+}
+
+} // namespace npu
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(_WIN32)
+#include <immintrin.h>
+#endif
+
+#include "npu_alloc.hpp"
+#include "npu_gemm.hpp"
+#include "npu_pool.hpp"
+
+// Batch-1 matrix-vector product y = x * W for token-by-token decoding. With
+// one activation row there is no reuse of W, so the product is bound by how
+// fast the weights stream from DRAM, and GEMM packing and tiling only add
+// overhead. GemvWeights stores W transposed (one contiguous K-long row per
+// output) as int8 or as packed int4, split into one shard per pool node and
+// bound to that node. gemv() streams each row once, with prefetchnta hints
+// so the stream does not evict x or other hot data, and every worker
+// reads its own node's shard unless it is stealing.
+namespace npu {
+
+enum class GemvFormat {
+    Int8,
+    Int4, // two weights per byte, low nibble first, each in [-8, 7] and stored as w + 8
+};
+
+// Output rows per work item
+constexpr int kGemvBlockRows = 64;
+
+// Prefetch distance along a weight row, in bytes
+constexpr int kGemvPrefetchBytes = 512;
+
+// Row bytes per kernel step: one cache line. Rows are stored padded to it.
+constexpr int kGemvStep = 64;
+
+class GemvWeights {
+public:
+    // w is K x N with int8-range values (int4-range for Int4). The shard
+    // split follows pool.home_node over kGemvBlockRows row blocks, so use the
+    // same pool for gemv().
+    template <typename T>
+    GemvWeights(const ThreadPool& pool, MatrixView<T> w, GemvFormat format = GemvFormat::Int8)
+        : k_(w.rows()), n_(w.cols()), format_(format) {
+        const int row_bytes = format == GemvFormat::Int4 ? (k_ + 1) / 2 : k_;
+        row_stride_ = (static_cast<std::size_t>(row_bytes) + kGemvStep - 1) / kGemvStep * kGemvStep;
+        const int blocks = gemm_strips(n_, kGemvBlockRows);
+        const NumaTopology& topo = numa_topology();
+        int block = 0;
+        for (int node = 0; node < pool.nodes(); ++node) {
+            Shard shard;
+            shard.row0 = std::min(block * kGemvBlockRows, n_);
+            while (block < blocks && pool.home_node(block, blocks) == node) {
+                ++block;
+            }
+            shard.rows = std::min(block * kGemvBlockRows, n_) - shard.row0;
+            AllocOptions options;
+            options.pages = PageSize::Huge2M;
+            options.node = pool.nodes() > 1 ? topo.node_ids[node] : -1;
+            shard.buffer = PageBuffer(static_cast<std::size_t>(shard.rows) * row_stride_, options);
+            for (int r = 0; r < shard.rows; ++r) {
+                pack_row(w, shard.row0 + r, static_cast<int8_t*>(shard.buffer.data()) + r * row_stride_);
+            }
+            shards_.push_back(std::move(shard));
+        }
+    }
+
+    int rows() const { return k_; }
+    int cols() const { return n_; }
+    GemvFormat format() const { return format_; }
+    int shards() const { return static_cast<int>(shards_.size()); }
+    // Bytes gemv() streams from memory per call
+    std::size_t weight_bytes() const {
+        return static_cast<std::size_t>(n_) * (format_ == GemvFormat::Int4 ? (k_ + 1) / 2 : k_);
+    }
+    const PageBuffer& shard_buffer(int shard) const { return shards_.at(static_cast<std::size_t>(shard)).buffer; }
+
+    // Packed weights of output n
+    const int8_t* row(int n) const {
+        const Shard& shard = shard_of(n);
+        return static_cast<const int8_t*>(shard.buffer.data()) + (n - shard.row0) * row_stride_;
+    }
+
+    // Bytes from one output's packed weights to the next within a shard
+    std::size_t row_stride() const { return row_stride_; }
+
+    // End of the packed weights in output n's shard. Outputs of one
+    // kGemvBlockRows block always share a shard, so one lookup serves it.
+    const int8_t* shard_end(int n) const {
+        const Shard& shard = shard_of(n);
+        return static_cast<const int8_t*>(shard.buffer.data()) + shard.rows * row_stride_;
+    }
+
+private:
+    struct Shard {
+        int row0 = 0;
+        int rows = 0;
+        PageBuffer buffer;
+    };
+
+    const Shard& shard_of(int n) const {
+        for (const auto& shard : shards_) {
+            if (n >= shard.row0 && n < shard.row0 + shard.rows) {
+                return shard;
+            }
+        }
+        throw std::out_of_range("GemvWeights: output out of range");
+    }
+
+    template <typename T>
+    void pack_row(MatrixView<T> w, int n, int8_t* out) const {
+        if (format_ == GemvFormat::Int8) {
+            for (int k = 0; k < k_; ++k) {
+                out[k] = static_cast<int8_t>(w.at(k, n));
+            }
+            return;
+        }
+        for (int k = 0; k < k_; k += 2) {
+            const int lo = static_cast<int>(w.at(k, n));
+            const int hi = k + 1 < k_ ? static_cast<int>(w.at(k + 1, n)) : 0;
+            if (lo < -8 || lo > 7 || hi < -8 || hi > 7) {
+                throw std::invalid_argument("GemvWeights: value outside the int4 range");
+            }
+            out[k / 2] = static_cast<int8_t>((lo + 8) | ((hi + 8) << 4));
+        }
+    }
+
+    int k_ = 0;
+    int n_ = 0;
+    GemvFormat format_ = GemvFormat::Int8;
+    std::size_t row_stride_ = 0;
+    std::vector<Shard> shards_;
+};
+
+namespace detail {
+
+// Prefetch kGemvPrefetchBytes ahead of p, unless that is at or past end
+inline void prefetch_stream(const int8_t* p, const int8_t* end) {
+#if defined(__GNUC__)
+    if (end - p > kGemvPrefetchBytes) {
+        __builtin_prefetch(p + kGemvPrefetchBytes, 0, 0); // read, no temporal locality: prefetchnta on x86
+    }
+#else
+    (void)p;
+    (void)end;
+#endif
+}
+
+inline int32_t int4_lo(int8_t packed) { return (packed & 0xf) - 8; }
+inline int32_t int4_hi(int8_t packed) { return ((packed >> 4) & 0xf) - 8; }
+
+// Portable kernels. Each call covers four rows, which share every x load.
+// x is int16 for int8 weights; for int4 it is int8, split into even and
+// odd k so each packed byte meets two contiguous activations. Lengths are
+// padded to kGemvStep with zero x, within the zeroed row padding. Prefetches
+// stop at end, the end of the rows' shard.
+inline void gemv4_int8(const int8_t* const* rows, const int8_t* end, const int16_t* x, int k, int32_t* out) {
+    int32_t acc[4] = {0, 0, 0, 0};
+    for (int k0 = 0; k0 < k; k0 += kGemvStep) {
+        const int k1 = std::min(k, k0 + kGemvStep);
+        for (int r = 0; r < 4; ++r) {
+            prefetch_stream(rows[r] + k0, end);
+        }
+        for (int r = 0; r < 4; ++r) {
+            for (int kk = k0; kk < k1; ++kk) {
+                acc[r] += rows[r][kk] * x[kk];
+            }
+        }
+    }
+    std::copy(acc, acc + 4, out);
+}
+
+inline void gemv4_int4(const int8_t* const* rows, const int8_t* end, const int8_t* x_even, const int8_t* x_odd,
+                       int bytes, int32_t* out) {
+    int32_t acc[4] = {0, 0, 0, 0};
+    for (int b0 = 0; b0 < bytes; b0 += kGemvStep) {
+        const int b1 = std::min(bytes, b0 + kGemvStep);
+        for (int r = 0; r < 4; ++r) {
+            prefetch_stream(rows[r] + b0, end);
+        }
+        for (int r = 0; r < 4; ++r) {
+            for (int b = b0; b < b1; ++b) {
+                acc[r] += int4_lo(rows[r][b]) * x_even[b] + int4_hi(rows[r][b]) * x_odd[b];
+            }
+        }
+    }
+    std::copy(acc, acc + 4, out);
+}
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(_WIN32)
+#define NPU_GEMV_AVX2 1
+
+// AVX2 versions, compiled for AVX2 whatever the build flags and only called
+// when the CPU has it. Each step reads one line of every row.
+__attribute__((target("avx2"))) inline int32_t hsum_epi32(__m256i v) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    return _mm_cvtsi128_si32(sum);
+}
+
+// int8: weights sign-extended to int16 meet x in vpmaddwd. No software
+// prefetch: the four rows are plain sequential streams the hardware
+// prefetchers follow, and prefetchnta measured slower here than without.
+__attribute__((target("avx2"))) inline void gemv4_int8_avx2(const int8_t* const* rows, const int16_t* x, int k,
+                                                             int32_t* out) {
+    __m256i acc[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(),
+                      _mm256_setzero_si256()};
+    for (int k0 = 0; k0 < k; k0 += kGemvStep) {
+        __m256i xs[4];
+        for (int q = 0; q < 4; ++q) {
+            xs[q] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + k0 + 16 * q));
+        }
+        for (int r = 0; r < 4; ++r) {
+            const int8_t* w = rows[r] + k0;
+            for (int q = 0; q < 4; ++q) {
+                const __m256i wq = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 16 * q)));
+                acc[r] = _mm256_add_epi32(acc[r], _mm256_madd_epi16(wq, xs[q]));
+            }
+        }
+    }
+    for (int r = 0; r < 4; ++r) {
+        out[r] = hsum_epi32(acc[r]);
+    }
+}
+
+// int4: the stored nibbles (weight + 8) go into vpmaddubsw as unsigned
+// bytes, so every sum comes out 8 * x_sum high and is corrected at the end.
+// 4-bit unsigned by int8 pair sums cannot saturate int16.
+__attribute__((target("avx2"))) inline void gemv4_int4_avx2(const int8_t* const* rows, const int8_t* end,
+                                                             const int8_t* x_even, const int8_t* x_odd, int bytes,
+                                                             int32_t x_sum, int32_t* out) {
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(),
+                      _mm256_setzero_si256()};
+    for (int b0 = 0; b0 < bytes; b0 += kGemvStep) {
+        __m256i xe[2];
+        __m256i xo[2];
+        for (int h = 0; h < 2; ++h) {
+            xe[h] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x_even + b0 + 32 * h));
+            xo[h] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x_odd + b0 + 32 * h));
+        }
+        for (int r = 0; r < 4; ++r) {
+            const int8_t* w = rows[r] + b0;
+            prefetch_stream(w, end);
+            // Eight products per int16 lane (two per vpmaddubsw, four per
+            // half, two halves), at most 8 * 15 * 128 = 15360: no overflow
+            __m256i pairs = _mm256_setzero_si256();
+            for (int h = 0; h < 2; ++h) {
+                const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + 32 * h));
+                const __m256i lo = _mm256_and_si256(packed, low_nibble);
+                const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(packed, 4), low_nibble);
+                pairs = _mm256_add_epi16(pairs, _mm256_add_epi16(_mm256_maddubs_epi16(lo, xe[h]),
+                                                                 _mm256_maddubs_epi16(hi, xo[h])));
+            }
+            acc[r] = _mm256_add_epi32(acc[r], _mm256_madd_epi16(pairs, ones));
+        }
+    }
+    for (int r = 0; r < 4; ++r) {
+        out[r] = hsum_epi32(acc[r]) - 8 * x_sum;
+    }
+}
+#endif
+
+inline bool gemv_avx2() {
+#ifdef NPU_GEMV_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+} // namespace detail
+
+// y = epilogue(x * W) for an int8-range activation row x (1 x K) into y
+// (1 x N), on the pool the weights were sharded for
+template <typename TX>
+void gemv(ThreadPool& pool, MatrixView<TX> x, const GemvWeights& w, MatrixView<int32_t> y,
+          const GemmEpilogue& epilogue = {}) {
+    if (x.rows() != 1 || y.rows() != 1 || x.cols() != w.rows() || y.cols() != w.cols()) {
+        throw std::invalid_argument("gemv: shapes do not match y = x * W");
+    }
+    const int k = w.rows();
+    const bool int4 = w.format() == GemvFormat::Int4;
+    // Activations converted once and zero padded to whole kernel steps:
+    // int16 for int8, int8 split into even k then odd k for int4
+    const int padded = ((int4 ? (k + 1) / 2 : k) + kGemvStep - 1) / kGemvStep * kGemvStep;
+    std::vector<int16_t> x16(int4 ? 0 : padded, 0);
+    std::vector<int8_t> x8(int4 ? 2 * static_cast<std::size_t>(padded) : 0, 0);
+    int32_t x_sum = 0;
+    for (int kk = 0; kk < k; ++kk) {
+        const int32_t value = static_cast<int32_t>(x.at(0, kk));
+        if (int4) {
+            x8[(kk % 2) * padded + kk / 2] = static_cast<int8_t>(value);
+        } else {
+            x16[kk] = static_cast<int16_t>(value);
+        }
+        x_sum += value;
+    }
+    const bool avx2 = detail::gemv_avx2();
+    pool.parallel_for(gemm_strips(w.cols(), kGemvBlockRows), [&](int block, int) {
+        const int n_begin = block * kGemvBlockRows;
+        const int n_end = std::min(w.cols(), n_begin + kGemvBlockRows);
+        // The block lies in one shard: find it once, then step by the stride
+        const int8_t* first = w.row(n_begin);
+        const int8_t* end = w.shard_end(n_begin);
+        for (int n0 = n_begin; n0 < n_end; n0 += 4) {
+            // A short last group repeats its last row and drops the extras
+            const int count = std::min(4, n_end - n0);
+            const int8_t* rows[4];
+            for (int r = 0; r < 4; ++r) {
+                rows[r] = first + static_cast<std::size_t>(n0 - n_begin + std::min(r, count - 1)) * w.row_stride();
+            }
+            int32_t out[4];
+#ifdef NPU_GEMV_AVX2
+            if (avx2) {
+                if (int4) {
+                    detail::gemv4_int4_avx2(rows, end, x8.data(), x8.data() + padded, padded, x_sum, out);
+                } else {
+                    detail::gemv4_int8_avx2(rows, x16.data(), padded, out);
+                }
+            } else
+#endif
+            if (int4) {
+                detail::gemv4_int4(rows, end, x8.data(), x8.data() + padded, padded, out);
+            } else {
+                detail::gemv4_int8(rows, end, x16.data(), padded, out);
+            }
+            for (int r = 0; r < count; ++r) {
+                const int32_t value = out[r] + (epilogue.bias ? epilogue.bias[n0 + r] : 0);
+                y.at(0, n0 + r) = epilogue.relu ? std::max(value, 0) : value;
+            }
+        }
+    });
+}
+
+} // namespace npu
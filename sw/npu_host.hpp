@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "npu_config.hpp"
+#include "npu_view.hpp"
+
+// Host-side reference kernels for the NPU data path: symmetric int8
+// quantization, GEMM, activation and dequantization. Every kernel reads and
+// writes through MatrixView, so callers pass slices, transposes or rows of a
+// larger buffer directly; outputs go to a caller-provided view rather than a
+// new matrix.
+namespace npu {
+
+// ============================================================================
+// Host Matrix Storage
+// ============================================================================
+
+// Owning row-major matrix for host code; view() exposes it to the kernels
+template <typename T>
+struct HostMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<T> data;
+
+    HostMatrix() = default;
+    HostMatrix(int r, int c) : rows(r), cols(c), data(static_cast<std::size_t>(r) * c, T{}) {}
+
+    T& at(int r, int c) { return data[static_cast<std::size_t>(r) * cols + c]; }
+    const T& at(int r, int c) const { return data[static_cast<std::size_t>(r) * cols + c]; }
+
+    MatrixView<T> view() { return {data.data(), rows, cols}; }
+    MatrixView<const T> view() const { return {data.data(), rows, cols}; }
+};
+
+using FloatMatrix = HostMatrix<float>;
+using Int8Matrix = HostMatrix<int8_t>;
+using Int32Matrix = HostMatrix<int32_t>;
+
+// ============================================================================
+// Quantization
+// ============================================================================
+
+constexpr int kInt8Max = (1 << (kNpuParams.data_width - 1)) - 1;
+constexpr int kInt8Min = -(1 << (kNpuParams.data_width - 1));
+
+struct QuantParams {
+    float scale;
+    int zero_point;
+
+    QuantParams() : scale(1.0f), zero_point(0) {}
+    QuantParams(float s, int zp) : scale(s), zero_point(zp) {}
+};
+
+inline int8_t quantize(float value, const QuantParams& params) {
+    int32_t quantized = static_cast<int32_t>(std::round(value / params.scale)) + params.zero_point;
+    if (quantized < kInt8Min) return kInt8Min;
+    if (quantized > kInt8Max) return kInt8Max;
+    return static_cast<int8_t>(quantized);
+}
+
+inline float dequantize(int32_t value, const QuantParams& params) {
+    return (static_cast<float>(value) - params.zero_point) * params.scale;
+}
+
+inline QuantParams compute_quant_params(float min_val, float max_val) {
+    // Symmetric quantization for signed int8
+    float abs_max = std::max(std::abs(min_val), std::abs(max_val));
+    if (abs_max < 1e-8f) {
+        return QuantParams(1.0f, 0);
+    }
+    float scale = abs_max / kInt8Max;
+    return QuantParams(scale, 0);
+}
+
+// ============================================================================
+// Kernels
+// ============================================================================
+
+namespace detail {
+
+template <typename TA, typename TB>
+void check_same_shape(const MatrixView<TA>& a, const MatrixView<TB>& b, const char* what) {
+    if (a.rows() != b.rows() || a.cols() != b.cols()) {
+        throw std::invalid_argument(std::string(what) + ": input and output shapes differ");
+    }
+}
+
+// Applies op(in) element by element into out (which may alias in)
+template <typename TIn, typename TOut, typename Op>
+void map(MatrixView<TIn> in, MatrixView<TOut> out, Op op) {
+    for (int r = 0; r < in.rows(); ++r) {
+        for (int c = 0; c < in.cols(); ++c) {
+            out.at(r, c) = op(in.at(r, c));
+        }
+    }
+}
+
+} // namespace detail
+
+template <typename T>
+void find_range(MatrixView<T> m, float& min_val, float& max_val) {
+    if (m.empty()) {
+        throw std::invalid_argument("find_range: empty view");
+    }
+    min_val = static_cast<float>(m.at(0, 0));
+    max_val = min_val;
+    for (int r = 0; r < m.rows(); ++r) {
+        for (int c = 0; c < m.cols(); ++c) {
+            min_val = std::min(min_val, static_cast<float>(m.at(r, c)));
+            max_val = std::max(max_val, static_cast<float>(m.at(r, c)));
+        }
+    }
+}
+
+template <typename TIn, typename TOut>
+void quantize_matrix(MatrixView<TIn> in, const QuantParams& params, MatrixView<TOut> out) {
+    detail::check_same_shape(in, out, "quantize_matrix");
+    detail::map(in, out, [&](float value) { return static_cast<TOut>(quantize(value, params)); });
+}
+
+template <typename TIn, typename TOut>
+void dequantize_matrix(MatrixView<TIn> in, const QuantParams& params, MatrixView<TOut> out) {
+    detail::check_same_shape(in, out, "dequantize_matrix");
+    detail::map(in, out, [&](TIn value) { return static_cast<TOut>(dequantize(static_cast<int32_t>(value), params)); });
+}
+
+template <typename TIn, typename TOut>
+void relu(MatrixView<TIn> in, MatrixView<TOut> out) {
+    detail::check_same_shape(in, out, "relu");
+    detail::map(in, out, [](TIn value) { return static_cast<TOut>(value < TIn{} ? TIn{} : value); });
+}
+
+// In place
+template <typename T>
+void relu(MatrixView<T> m) {
+    relu(m, m);
+}
+
+// C = A * B, or C += A * B with accumulate. Integer inputs accumulate in
+// int32 like the host reference; float inputs in float. C must not overlap
+// A or B.
+template <typename TA, typename TB, typename TC>
+void gemm(MatrixView<TA> a, MatrixView<TB> b, MatrixView<TC> c, bool accumulate = false) {
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        throw std::invalid_argument("gemm: shapes do not match C = A * B");
+    }
+    using Acc = std::conditional_t<std::is_floating_point<std::remove_const_t<TC>>::value, TC, int32_t>;
+    for (int i = 0; i < a.rows(); ++i) {
+        for (int j = 0; j < b.cols(); ++j) {
+            Acc sum = accumulate ? static_cast<Acc>(c.at(i, j)) : Acc{};
+            for (int k = 0; k < a.cols(); ++k) {
+                sum += static_cast<Acc>(a.at(i, k)) * static_cast<Acc>(b.at(k, j));
+            }
+            c.at(i, j) = static_cast<TC>(sum);
+        }
+    }
+}
+
+// BLAS-style C = op(A) * op(B) on the stored operands (NN, NT, TN or TT)
+template <typename TA, typename TB, typename TC>
+void gemm(Transpose ta, Transpose tb, MatrixView<TA> a, MatrixView<TB> b, MatrixView<TC> c,
+          bool accumulate = false) {
+    gemm(transpose_if(a, ta), transpose_if(b, tb), c, accumulate);
+}
+
+// ============================================================================
+// Incremental GEMM
+// ============================================================================
+
+struct IncrementalStats {
+    uint64_t refreshes = 0;
+    uint64_t macs = 0;       // multiply-accumulates actually performed
+    uint64_t dense_macs = 0; // what recomputing all of C each refresh would cost
+
+    double saved_fraction() const {
+        return dense_macs == 0 ? 0.0 : 1.0 - static_cast<double>(macs) / static_cast<double>(dense_macs);
+    }
+};
+
+// Keeps C = A * B current while A rows and B columns change. Each update
+// marks the changed rows of A and columns of B dirty. result() then
+// recomputes only the output strips they touch: whole rows of C for dirty A
+// rows, and the dirty B columns over the remaining rows. Work per refresh is
+// (dirty_rows * N + dirty_cols * (M - dirty_rows)) * K instead of M * N * K.
+template <typename T>
+class IncrementalGemm {
+public:
+    using acc_type = std::conditional_t<std::is_floating_point<T>::value, T, int32_t>;
+
+    IncrementalGemm(int m, int k, int n)
+        : a_(m, k), b_(k, n), c_(m, n), dirty_rows_(static_cast<std::size_t>(m), true),
+          dirty_cols_(static_cast<std::size_t>(n), false) {}
+
+    MatrixView<const T> a() const { return a_.view(); }
+    MatrixView<const T> b() const { return b_.view(); }
+    const IncrementalStats& stats() const { return stats_; }
+
+    // Copies rows into A starting at row r0
+    void update_a_rows(int r0, MatrixView<const T> rows) {
+        copy_into(a_.view().rows_slice(r0, rows.rows()), rows);
+        for (int r = r0; r < r0 + rows.rows(); ++r) {
+            dirty_rows_[r] = true;
+        }
+    }
+
+    // Copies cols into B starting at column c0
+    void update_b_cols(int c0, MatrixView<const T> cols) {
+        copy_into(b_.view().cols_slice(c0, cols.cols()), cols);
+        for (int c = c0; c < c0 + cols.cols(); ++c) {
+            dirty_cols_[c] = true;
+        }
+    }
+
+    // In-place access to one A row or B column; the strip is marked dirty
+    MatrixView<T> a_row(int r) {
+        dirty_rows_.at(r) = true;
+        return a_.view().rows_slice(r, 1);
+    }
+    MatrixView<T> b_col(int c) {
+        dirty_cols_.at(c) = true;
+        return b_.view().cols_slice(c, 1);
+    }
+
+    // C, with every dirty strip recomputed first
+    MatrixView<const acc_type> result() {
+        const int m = c_.rows;
+        const int n = c_.cols;
+        const uint64_t k = static_cast<uint64_t>(a_.cols);
+        for (int r0 = 0; r0 < m;) {
+            const int r1 = run_end(dirty_rows_, r0);
+            if (dirty_rows_[r0]) {
+                gemm(a().rows_slice(r0, r1 - r0), b(), c_.view().rows_slice(r0, r1 - r0));
+                stats_.macs += static_cast<uint64_t>(r1 - r0) * n * k;
+            } else {
+                for (int c0 = 0; c0 < n;) {
+                    const int c1 = run_end(dirty_cols_, c0);
+                    if (dirty_cols_[c0]) {
+                        gemm(a().rows_slice(r0, r1 - r0), b().cols_slice(c0, c1 - c0),
+                             c_.view().submatrix(r0, c0, r1 - r0, c1 - c0));
+                        stats_.macs += static_cast<uint64_t>(r1 - r0) * (c1 - c0) * k;
+                    }
+                    c0 = c1;
+                }
+            }
+            r0 = r1;
+        }
+        std::fill(dirty_rows_.begin(), dirty_rows_.end(), false);
+        std::fill(dirty_cols_.begin(), dirty_cols_.end(), false);
+        stats_.dense_macs += static_cast<uint64_t>(m) * n * k;
+        ++stats_.refreshes;
+        return c_.view();
+    }
+
+private:
+    static void copy_into(MatrixView<T> dst, MatrixView<const T> src) {
+        if (dst.rows() != src.rows() || dst.cols() != src.cols()) {
+            throw std::invalid_argument("IncrementalGemm: update shape does not fit");
+        }
+        for (int r = 0; r < src.rows(); ++r) {
+            for (int c = 0; c < src.cols(); ++c) {
+                dst.at(r, c) = src.at(r, c);
+            }
+        }
+    }
+
+    // End of the run of equal flags starting at begin
+    static int run_end(const std::vector<bool>& flags, int begin) {
+        int end = begin + 1;
+        while (end < static_cast<int>(flags.size()) && flags[end] == flags[begin]) {
+            ++end;
+        }
+        return end;
+    }
+
+    HostMatrix<T> a_;
+    HostMatrix<T> b_;
+    HostMatrix<acc_type> c_;
+    std::vector<bool> dirty_rows_;
+    std::vector<bool> dirty_cols_;
+    IncrementalStats stats_;
+};
+
+// Values of m in the NPU result-stream order (row-major)
+template <typename T>
+std::vector<std::remove_const_t<T>> stream_order(MatrixView<T> m) {
+    std::vector<std::remove_const_t<T>> values;
+    values.reserve(static_cast<std::size_t>(m.rows()) * m.cols());
+    for (int r = 0; r < m.rows(); ++r) {
+        for (int c = 0; c < m.cols(); ++c) {
+            values.push_back(m.at(r, c));
+        }
+    }
+    return values;
+}
+
+} // namespace npu
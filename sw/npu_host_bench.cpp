@@ -0,0 +1,496 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "npu_gemm.hpp"
+#include "npu_gemv.hpp"
+#include "npu_host.hpp"
+#include "npu_pool.hpp"
+#include "npu_sparse.hpp"
+
+// Host kernel benchmarks. Each section times one kernel against the dense
+// view-based gemm on the same problem and checks that the results match.
+//   npu_host_bench [--only=<section>] [--m=256] [--k=1024] [--n=1024] [--reps=3]
+// Sections: sparse24, bsr, pool, jit, gemv, transpose, grouped
+namespace {
+
+struct BenchShape {
+    int m = 256;
+    int k = 1024;
+    int n = 1024;
+    int reps = 3;
+};
+
+// Best-of-reps wall time in seconds
+template <typename Fn>
+double time_best(int reps, Fn fn) {
+    double best = 0.0;
+    for (int rep = 0; rep < reps; ++rep) {
+        const auto begin = std::chrono::steady_clock::now();
+        fn();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (rep == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+void fill_random(npu::Int8Matrix& m, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(-128, 127);
+    for (auto& value : m.data) {
+        value = static_cast<int8_t>(dist(rng));
+    }
+}
+
+void report(const std::string& label, double seconds, double macs) {
+    std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << seconds * 1e3 << " ms " << std::setw(8) << macs / seconds * 1e-9 << " GMAC/s\n";
+}
+
+// Dense counterpart of gemm_2_4 with the same 4-row blocking, reading W^T
+// (N x K, K contiguous): isolates the saving from skipping zero weights
+void gemm_dense_blocked(const npu::Int8Matrix& a, const npu::Int8Matrix& wt, npu::Int32Matrix& c) {
+    const int k_len = a.cols;
+    for (int i0 = 0; i0 < a.rows; i0 += 4) {
+        const int rows = std::min(4, a.rows - i0);
+        const int8_t* row[4];
+        for (int r = 0; r < 4; ++r) {
+            row[r] = &a.at(i0 + std::min(r, rows - 1), 0);
+        }
+        for (int n = 0; n < wt.rows; ++n) {
+            const int8_t* w = &wt.at(n, 0);
+            int32_t acc[4] = {0, 0, 0, 0};
+            for (int k = 0; k < k_len; ++k) {
+                for (int r = 0; r < 4; ++r) {
+                    acc[r] += static_cast<int32_t>(row[r][k]) * w[k];
+                }
+            }
+            for (int r = 0; r < rows; ++r) {
+                c.at(i0 + r, n) = acc[r];
+            }
+        }
+    }
+}
+
+// 2:4 pruned weights: compressed kernel vs dense kernels on the same pruned
+// weights, so all results must match exactly
+bool bench_sparse24(const BenchShape& shape) {
+    std::mt19937 rng(1);
+    npu::Int8Matrix a(shape.m, shape.k);
+    npu::Int8Matrix wt(shape.n, shape.k); // W^T
+    fill_random(a, rng);
+    fill_random(wt, rng);
+    const auto w = wt.view().transposed();
+    npu::prune_2_4(w);
+    const npu::Sparse24Matrix packed = npu::compress_2_4(w);
+
+    npu::Int32Matrix dense(shape.m, shape.n);
+    npu::Int32Matrix blocked(shape.m, shape.n);
+    npu::Int32Matrix packed_dense(shape.m, shape.n);
+    npu::Int32Matrix sparse(shape.m, shape.n);
+    const npu::PackedB packed_b(w);
+    const double dense_s = time_best(shape.reps, [&] { npu::gemm(a.view(), w, dense.view()); });
+    const double blocked_s = time_best(shape.reps, [&] { gemm_dense_blocked(a, wt, blocked); });
+    const double packed_s =
+        time_best(shape.reps, [&] { npu::gemm_packed(a.view(), packed_b, packed_dense.view()); });
+    const double sparse_s = time_best(shape.reps, [&] { npu::gemm_2_4(a.view(), packed, sparse.view()); });
+    const double macs = static_cast<double>(shape.m) * shape.k * shape.n;
+    const bool match = dense.data == sparse.data && blocked.data == sparse.data && packed_dense.data == sparse.data;
+
+    std::cout << "sparse24: " << shape.m << "x" << shape.k << "x" << shape.n << ", weights "
+              << wt.data.size() << " B dense -> " << packed.values.size() + packed.indices.size() << " B\n";
+    report("dense gemm (views)", dense_s, macs);
+    report("dense, same blocking", blocked_s, macs);
+    report("dense gemm_packed", packed_s, macs);
+    report("2:4 gemm (effective)", sparse_s, macs);
+    std::cout << "  speedup " << std::setprecision(2) << dense_s / sparse_s << "x vs gemm, " << blocked_s / sparse_s
+              << "x vs same blocking, " << packed_s / sparse_s << "x vs gemm_packed, results "
+              << (match ? "match" : "DIFFER") << "\n";
+    return match;
+}
+
+// Block-pruned weights at 25% block density, for 4x4 and 8x8 blocks. The
+// dense kernels run on the same pruned weights, so results must match.
+bool bench_bsr(const BenchShape& shape) {
+    bool ok = true;
+    for (int block : {4, 8}) {
+        std::mt19937 rng(2);
+        npu::Int8Matrix a(shape.m, shape.k);
+        npu::Int8Matrix wt(shape.n, shape.k); // W^T
+        fill_random(a, rng);
+        fill_random(wt, rng);
+        const auto w = wt.view().transposed();
+        for (int k0 = 0; k0 < shape.k; k0 += block) {
+            for (int n0 = 0; n0 < shape.n; n0 += block) {
+                if (rng() % 4 == 0) {
+                    continue;
+                }
+                for (int k = k0; k < std::min(shape.k, k0 + block); ++k) {
+                    for (int n = n0; n < std::min(shape.n, n0 + block); ++n) {
+                        w.at(k, n) = 0;
+                    }
+                }
+            }
+        }
+        const npu::BsrMatrix packed = npu::to_bsr(w, block);
+
+        npu::Int32Matrix blocked(shape.m, shape.n);
+        npu::Int32Matrix sparse(shape.m, shape.n);
+        const double blocked_s = time_best(shape.reps, [&] { gemm_dense_blocked(a, wt, blocked); });
+        const double sparse_s = time_best(shape.reps, [&] { npu::gemm_bsr(a.view(), packed, sparse.view()); });
+        const double macs = static_cast<double>(shape.m) * shape.k * shape.n;
+        const bool match = blocked.data == sparse.data;
+        ok = ok && match;
+
+        std::cout << "bsr " << block << "x" << block << ": " << shape.m << "x" << shape.k << "x" << shape.n
+                  << ", block density " << std::setprecision(2) << packed.block_density() << ", weights "
+                  << wt.data.size() << " B dense -> "
+                  << packed.values.size() + (packed.row_ptr.size() + packed.col_idx.size()) * sizeof(int) << " B\n";
+        report("dense, 4-row blocking", blocked_s, macs);
+        report("bsr gemm (effective)", sparse_s, macs);
+        std::cout << "  speedup " << std::setprecision(2) << blocked_s / sparse_s << "x, results "
+                  << (match ? "match" : "DIFFER") << "\n";
+    }
+    return ok;
+}
+
+// Row-strip GEMM on one worker vs every CPU, both on weights replicated per
+// node on huge pages. The all-CPU run writes a C first-touched strip by
+// strip, so each strip reads and writes memory on its own node.
+bool bench_pool(const BenchShape& shape) {
+    std::mt19937 rng(3);
+    npu::Int8Matrix a(shape.m, shape.k);
+    npu::Int8Matrix w(shape.k, shape.n);
+    fill_random(a, rng);
+    fill_random(w, rng);
+    npu::ThreadPool single(1);
+    npu::ThreadPool pool;
+    npu::AllocOptions options;
+    options.pages = npu::PageSize::Huge2M;
+    const npu::Replicated<int8_t> weights(w.view(), npu::PageSize::Huge2M);
+    npu::PageMatrix<int32_t> local(shape.m, shape.n, options);
+    pool.first_touch(local.view().data(), static_cast<std::size_t>(shape.m) * shape.n * sizeof(int32_t),
+                     static_cast<std::size_t>(npu::kGemmStripRows) * shape.n * sizeof(int32_t));
+
+    npu::Int32Matrix serial(shape.m, shape.n);
+    const double serial_s = time_best(shape.reps, [&] { npu::gemm_parallel(single, a.view(), weights, serial.view()); });
+    const double pool_s = time_best(shape.reps, [&] { npu::gemm_parallel(pool, a.view(), weights, local.view()); });
+    const double macs = static_cast<double>(shape.m) * shape.k * shape.n;
+    bool match = true;
+    for (int r = 0; r < shape.m && match; ++r) {
+        for (int c = 0; c < shape.n && match; ++c) {
+            match = serial.at(r, c) == local.view().at(r, c);
+        }
+    }
+
+    std::cout << "pool: " << shape.m << "x" << shape.k << "x" << shape.n << ", " << pool.size() << " workers on "
+              << pool.nodes() << " node(s), weights on " << npu::page_backing_name(weights.buffer(0).backing())
+              << " pages x" << weights.copies() << "\n";
+    report("1 worker", serial_s, macs);
+    report("all workers, node-local", pool_s, macs);
+    std::cout << "  speedup " << std::setprecision(2) << serial_s / pool_s << "x, results "
+              << (match ? "match" : "DIFFER") << "\n";
+    return match;
+}
+
+// Packed GEMM with a bias + ReLU epilogue: static microkernels vs kernels
+// generated for the exact shape. Both are checked against the unpacked
+// dense kernel with the epilogue applied afterwards.
+bool bench_jit(const BenchShape& shape) {
+    std::mt19937 rng(4);
+    npu::Int8Matrix a(shape.m, shape.k);
+    npu::Int8Matrix wt(shape.n, shape.k); // W^T
+    fill_random(a, rng);
+    fill_random(wt, rng);
+    std::vector<int32_t> bias(static_cast<std::size_t>(shape.n));
+    for (auto& value : bias) {
+        value = static_cast<int32_t>(rng() % 20001) - 10000;
+    }
+    npu::GemmEpilogue epilogue;
+    epilogue.bias = bias.data();
+    epilogue.relu = true;
+    const npu::PackedB packed(wt.view().transposed());
+
+    npu::Int32Matrix blocked(shape.m, shape.n);
+    npu::Int32Matrix fixed(shape.m, shape.n);
+    npu::Int32Matrix jit(shape.m, shape.n);
+    const double blocked_s = time_best(shape.reps, [&] { gemm_dense_blocked(a, wt, blocked); });
+    const double static_s =
+        time_best(shape.reps, [&] { npu::gemm_packed(a.view(), packed, fixed.view(), epilogue, false); });
+    const auto generate = std::chrono::steady_clock::now();
+    npu::gemm_packed(a.view(), packed, jit.view(), epilogue);
+    const double first_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - generate).count();
+    const double jit_s = time_best(shape.reps, [&] { npu::gemm_packed(a.view(), packed, jit.view(), epilogue); });
+    for (int r = 0; r < shape.m; ++r) {
+        for (int c = 0; c < shape.n; ++c) {
+            blocked.at(r, c) = std::max(blocked.at(r, c) + bias[c], 0);
+        }
+    }
+    const double macs = static_cast<double>(shape.m) * shape.k * shape.n;
+    const bool match = blocked.data == fixed.data && blocked.data == jit.data;
+
+    std::cout << "jit: " << shape.m << "x" << shape.k << "x" << shape.n << ", bias + ReLU epilogue, JIT "
+              << (npu::JitKernelCache::available() ? "available" : "unavailable (static kernels only)") << ", "
+              << npu::jit_kernels().kernels() << " kernel(s) cached\n";
+    report("dense, 4-row blocking", blocked_s, macs);
+    report("packed, static kernels", static_s, macs);
+    report("packed, JIT (first call)", first_s, macs);
+    report("packed, JIT kernels", jit_s, macs);
+    std::cout << "  speedup " << std::setprecision(2) << static_s / jit_s << "x vs static kernels, results "
+              << (match ? "match" : "DIFFER") << "\n";
+    return match;
+}
+
+// MoE-style grouped GEMM: eight experts of K x N weights with a skewed
+// split of the m tokens, run expert by expert with the pooled gemm_packed
+// vs as one gemm_grouped workload
+bool bench_grouped(const BenchShape& shape) {
+    std::mt19937 rng(7);
+    npu::ThreadPool pool;
+    const int shares[] = {96, 48, 40, 30, 20, 12, 8, 2}; // of 256
+    std::vector<npu::Int8Matrix> a;
+    std::vector<npu::PackedB> packed;
+    std::vector<npu::Int32Matrix> one_by_one;
+    std::vector<npu::Int32Matrix> grouped;
+    for (int share : shares) {
+        const int tokens = std::max(1, shape.m * share / 256);
+        npu::Int8Matrix w(shape.k, shape.n);
+        a.emplace_back(tokens, shape.k);
+        fill_random(a.back(), rng);
+        fill_random(w, rng);
+        packed.emplace_back(w.view());
+        one_by_one.emplace_back(tokens, shape.n);
+        grouped.emplace_back(tokens, shape.n);
+    }
+    std::vector<npu::GemmProblem<const int8_t>> problems;
+    double macs = 0.0;
+    for (std::size_t e = 0; e < a.size(); ++e) {
+        npu::GemmProblem<const int8_t> problem;
+        problem.a = a[e].view();
+        problem.b = &packed[e];
+        problem.c = grouped[e].view();
+        problems.push_back(problem);
+        macs += static_cast<double>(a[e].rows) * shape.k * shape.n;
+    }
+    const double single_s = time_best(shape.reps, [&] {
+        for (std::size_t e = 0; e < a.size(); ++e) {
+            npu::gemm_packed(pool, a[e].view(), packed[e], one_by_one[e].view());
+        }
+    });
+    const double grouped_s = time_best(shape.reps, [&] { npu::gemm_grouped(pool, problems); });
+    bool match = true;
+    for (std::size_t e = 0; e < a.size(); ++e) {
+        match = match && one_by_one[e].data == grouped[e].data;
+    }
+
+    std::cout << "grouped: 8 experts of " << shape.k << "x" << shape.n << ", "
+              << static_cast<int>(macs / (static_cast<double>(shape.k) * shape.n)) << " tokens, " << pool.size()
+              << " workers\n";
+    report("expert by expert", single_s, macs);
+    report("grouped", grouped_s, macs);
+    std::cout << "  speedup " << std::setprecision(2) << single_s / grouped_s << "x, results "
+              << (match ? "match" : "DIFFER") << "\n";
+    return match;
+}
+
+// Row-major copy of a view: the explicit transpose the flags avoid
+npu::Int8Matrix copy_rows(npu::MatrixView<const int8_t> view) {
+    npu::Int8Matrix m(view.rows(), view.cols());
+    for (int r = 0; r < view.rows(); ++r) {
+        for (int c = 0; c < view.cols(); ++c) {
+            m.at(r, c) = view.at(r, c);
+        }
+    }
+    return m;
+}
+
+// Packed GEMM on each stored layout (NN, NT, TN, TT), packing B and A
+// straight from it vs copying the transposed operands to row-major first.
+// Times include packing B, as for activations that change every call.
+bool bench_transpose(const BenchShape& shape) {
+    std::mt19937 rng(6);
+    npu::Int8Matrix a(shape.m, shape.k);
+    npu::Int8Matrix b(shape.k, shape.n);
+    fill_random(a, rng);
+    fill_random(b, rng);
+    const npu::Int8Matrix at = copy_rows(a.view().transposed());
+    const npu::Int8Matrix bt = copy_rows(b.view().transposed());
+    npu::Int32Matrix reference(shape.m, shape.n);
+    npu::gemm_packed(a.view(), npu::PackedB(b.view()), reference.view());
+
+    const double macs = static_cast<double>(shape.m) * shape.k * shape.n;
+    const npu::Transpose flags[] = {npu::Transpose::No, npu::Transpose::Yes};
+    const char* names[] = {"N", "T"};
+    bool match = true;
+    std::cout << "transpose: " << shape.m << "x" << shape.k << "x" << shape.n << ", B packed every call\n";
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            const npu::Transpose ta = flags[i];
+            const npu::Transpose tb = flags[j];
+            const npu::Int8Matrix& stored_a = i ? at : a;
+            const npu::Int8Matrix& stored_b = j ? bt : b;
+            npu::Int32Matrix direct(shape.m, shape.n);
+            npu::Int32Matrix copied(shape.m, shape.n);
+            const double direct_s = time_best(shape.reps, [&] {
+                npu::gemm_packed(ta, stored_a.view(), npu::PackedB(stored_b.view(), tb), direct.view());
+            });
+            const double copied_s = time_best(shape.reps, [&] {
+                const npu::Int8Matrix a_rows = copy_rows(npu::transpose_if(stored_a.view(), ta));
+                const npu::Int8Matrix b_rows = copy_rows(npu::transpose_if(stored_b.view(), tb));
+                npu::gemm_packed(a_rows.view(), npu::PackedB(b_rows.view()), copied.view());
+            });
+            match = match && direct.data == reference.data && copied.data == reference.data;
+            const std::string layout = std::string(names[i]) + names[j];
+            report(layout + ", packed from layout", direct_s, macs);
+            report(layout + ", transpose copy first", copied_s, macs);
+        }
+    }
+    std::cout << "  results " << (match ? "match" : "DIFFER") << "\n";
+    return match;
+}
+
+// Sums 1 MB at p: the bandwidth probe's inner loop, vectorized where the
+// GEMV kernels are so that the probe is not compute-bound either
+#ifdef NPU_GEMV_AVX2
+__attribute__((target("avx2"))) uint64_t sum_megabyte_avx2(const uint64_t* p) {
+    __m256i acc[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(),
+                      _mm256_setzero_si256()};
+    for (int i = 0; i < (1 << 17); i += 16) {
+        for (int j = 0; j < 4; ++j) {
+            acc[j] = _mm256_add_epi64(acc[j], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 4 * j)));
+        }
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes),
+                       _mm256_add_epi64(_mm256_add_epi64(acc[0], acc[1]), _mm256_add_epi64(acc[2], acc[3])));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#endif
+
+uint64_t sum_megabyte(const uint64_t* p) {
+#ifdef NPU_GEMV_AVX2
+    if (npu::detail::gemv_avx2()) {
+        return sum_megabyte_avx2(p);
+    }
+#endif
+    uint64_t sum = 0;
+    for (int i = 0; i < (1 << 17); ++i) {
+        sum += p[i];
+    }
+    return sum;
+}
+
+// Batch-1 GEMV against the machine's read bandwidth. The weights are
+// (4k) x (64n), 256 MB of int8 at the defaults, so they stream from DRAM
+// rather than cache. Bandwidth is measured by summing a buffer of the same
+// size on the same pool.
+bool bench_gemv(const BenchShape& shape) {
+    const int k = 4 * shape.k;
+    const int n = 64 * shape.n;
+    std::mt19937 rng(5);
+    npu::ThreadPool pool;
+    npu::Int8Matrix x(1, k);
+    npu::Int8Matrix wt(n, k); // W^T
+    fill_random(x, rng);
+    fill_random(wt, rng);
+    for (auto& value : wt.data) {
+        value = static_cast<int8_t>(value >> 4); // int4 range, so both formats hold the same weights
+    }
+    const auto w = wt.view().transposed();
+    const npu::GemvWeights w8(pool, w, npu::GemvFormat::Int8);
+    const npu::GemvWeights w4(pool, w, npu::GemvFormat::Int4);
+
+    npu::AllocOptions options;
+    options.pages = npu::PageSize::Huge2M;
+    const std::size_t bytes = w8.weight_bytes();
+    npu::PageBuffer stream(bytes, options);
+    pool.first_touch(stream.data(), bytes, 1 << 20);
+    const int chunks = static_cast<int>(bytes >> 20);
+    std::vector<uint64_t> sums(static_cast<std::size_t>(pool.size()));
+    const double read_s = time_best(shape.reps, [&] {
+        pool.parallel_for(chunks, [&](int chunk, int worker) {
+            sums[worker] +=
+                sum_megabyte(static_cast<const uint64_t*>(stream.data()) + (static_cast<std::size_t>(chunk) << 17));
+        });
+    });
+
+    npu::Int32Matrix y8(1, n);
+    npu::Int32Matrix y4(1, n);
+    npu::Int32Matrix reference(1, n);
+    const double gemv8_s = time_best(shape.reps, [&] { npu::gemv(pool, x.view(), w8, y8.view()); });
+    const double gemv4_s = time_best(shape.reps, [&] { npu::gemv(pool, x.view(), w4, y4.view()); });
+    const double gemm_s = time_best(1, [&] { npu::gemm(x.view(), w, reference.view()); });
+    const bool match = y8.data == reference.data && y4.data == reference.data;
+
+    const double dram = static_cast<double>(bytes) / read_s;
+    auto line = [&](const std::string& label, double seconds, std::size_t streamed) {
+        const double rate = static_cast<double>(streamed) / seconds;
+        std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(9) << seconds * 1e3 << " ms " << std::setw(8) << rate * 1e-9 << " GB/s "
+                  << std::setw(6) << std::setprecision(1) << rate / dram * 100.0 << "% of read bandwidth\n";
+    };
+    std::cout << "gemv: 1x" << k << "x" << n << ", " << pool.size() << " workers, " << w8.shards()
+              << " shard(s) on " << npu::page_backing_name(w8.shard_buffer(0).backing()) << " pages\n";
+    line("read bandwidth", read_s, bytes);
+    line("int8 gemv", gemv8_s, w8.weight_bytes());
+    line("int4 gemv", gemv4_s, w4.weight_bytes());
+    line("gemm() with M = 1", gemm_s, w8.weight_bytes());
+    std::cout << "  int4 runs " << std::setprecision(2) << gemv8_s / gemv4_s << "x the int8 token rate, results "
+              << (match ? "match" : "DIFFER") << "\n";
+    return match;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchShape shape;
+    std::string only;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg.substr(0, 7) == "--only=") {
+            only = arg.substr(7);
+        } else if (arg.substr(0, 4) == "--m=") {
+            shape.m = std::stoi(arg.substr(4));
+        } else if (arg.substr(0, 4) == "--k=") {
+            shape.k = std::stoi(arg.substr(4));
+        } else if (arg.substr(0, 4) == "--n=") {
+            shape.n = std::stoi(arg.substr(4));
+        } else if (arg.substr(0, 7) == "--reps=") {
+            shape.reps = std::stoi(arg.substr(7));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--only=sparse24|bsr|pool|jit|gemv|transpose|grouped] [--m=M] [--k=K] [--n=N] [--reps=R]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool ok = true;
+    if (only.empty() || only == "sparse24") {
+        ok = bench_sparse24(shape) && ok;
+    }
+    if (only.empty() || only == "bsr") {
+        ok = bench_bsr(shape) && ok;
+    }
+    if (only.empty() || only == "pool") {
+        ok = bench_pool(shape) && ok;
+    }
+    if (only.empty() || only == "jit") {
+        ok = bench_jit(shape) && ok;
+    }
+    if (only.empty() || only == "gemv") {
+        ok = bench_gemv(shape) && ok;
+    }
+    if (only.empty() || only == "transpose") {
+        ok = bench_transpose(shape) && ok;
+    }
+    if (only.empty() || only == "grouped") {
+        ok = bench_grouped(shape) && ok;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
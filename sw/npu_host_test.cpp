@@ -0,0 +1,777 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "npu_alloc.hpp"
+#include "npu_expr.hpp"
+#include "npu_gemm.hpp"
+#include "npu_gemv.hpp"
+#include "npu_host.hpp"
+#include "npu_model.hpp"
+#include "npu_pool.hpp"
+#include "npu_sparse.hpp"
+
+namespace {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+};
+
+npu::IntMatrix random_int8_matrix(int rows, int cols, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(-128, 127);
+    npu::IntMatrix m(rows, cols);
+    for (auto& value : m.data) {
+        value = dist(rng);
+    }
+    return m;
+}
+
+// Dense copy of a view, for checking against the reference kernels
+template <typename T>
+npu::IntMatrix copy_of(npu::MatrixView<T> view) {
+    npu::IntMatrix m(view.rows(), view.cols());
+    for (int r = 0; r < view.rows(); ++r) {
+        for (int c = 0; c < view.cols(); ++c) {
+            m.at(r, c) = static_cast<int32_t>(view.at(r, c));
+        }
+    }
+    return m;
+}
+
+template <typename T>
+bool view_equals(npu::MatrixView<T> view, const npu::IntMatrix& expected) {
+    return copy_of(view).data == expected.data && view.rows() == expected.rows && view.cols() == expected.cols;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TestResult test_view_slicing() {
+    npu::IntMatrix m(6, 8);
+    for (std::size_t i = 0; i < m.data.size(); ++i) {
+        m.data[i] = static_cast<int32_t>(i);
+    }
+    const npu::MatrixView<int32_t> block = m.view().submatrix(2, 3, 3, 4);
+    if (block.at(0, 0) != 2 * 8 + 3 || block.at(2, 3) != 4 * 8 + 6 || block.contiguous()) {
+        return {"view_slicing", false, "submatrix reads the wrong elements"};
+    }
+    // Writes through a slice land in the parent buffer
+    block.at(1, 1) = -1;
+    if (m.at(3, 4) != -1) {
+        return {"view_slicing", false, "submatrix does not alias its parent"};
+    }
+    const npu::MatrixView<const int32_t> t = npu::MatrixView<const int32_t>(block).transposed();
+    if (t.rows() != 4 || t.cols() != 3 || t.at(3, 2) != block.at(2, 3) || t.transposed().at(2, 3) != block.at(2, 3)) {
+        return {"view_slicing", false, "transposed view has the wrong shape or elements"};
+    }
+    if (block.submatrix(1, 1, 2, 2).at(1, 1) != m.at(4, 5) || !m.view().rows_slice(1, 2).contiguous()) {
+        return {"view_slicing", false, "nested slice or row slice is wrong"};
+    }
+    bool threw = false;
+    try {
+        block.submatrix(2, 0, 2, 1);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    if (!threw) {
+        return {"view_slicing", false, "out-of-range submatrix was accepted"};
+    }
+    return {"view_slicing", true, ""};
+}
+
+TestResult test_strided_gemm() {
+    // A is a block of a wider buffer, B is held transposed, and C is written
+    // into the middle of a larger output, all without copies
+    std::mt19937 rng(3);
+    const npu::IntMatrix a_buf = random_int8_matrix(20, 30, rng);
+    const npu::IntMatrix bt_buf = random_int8_matrix(9, 17, rng); // B^T, N x K
+    npu::IntMatrix c_buf(16, 16);
+    c_buf.data.assign(c_buf.data.size(), 7);
+
+    const auto a = a_buf.view().submatrix(3, 5, 11, 17);
+    const auto b = bt_buf.view().transposed();
+    const auto c = c_buf.view().submatrix(2, 4, 11, 9);
+    npu::gemm(a, b, c);
+    if (!view_equals(c, npu::gemm_reference(copy_of(a), copy_of(b)))) {
+        return {"strided_gemm", false, "GEMM on strided views differs from the reference"};
+    }
+    if (c_buf.at(1, 4) != 7 || c_buf.at(2, 3) != 7 || c_buf.at(13, 12) != 7 || c_buf.at(12, 13) != 7) {
+        return {"strided_gemm", false, "GEMM wrote outside the output view"};
+    }
+
+    // Accumulating over two K halves matches one full product
+    npu::IntMatrix split(11, 9);
+    npu::gemm(a.cols_slice(0, 8), b.rows_slice(0, 8), split.view());
+    npu::gemm(a.cols_slice(8, 9), b.rows_slice(8, 9), split.view(), true);
+    if (!view_equals(c, split)) {
+        return {"strided_gemm", false, "accumulated K split differs"};
+    }
+    return {"strided_gemm", true, ""};
+}
+
+TestResult test_quantize_views() {
+    // Quantize one column band of a float buffer into an int8 buffer and
+    // dequantize it back, all through views
+    npu::FloatMatrix x(5, 12);
+    for (int r = 0; r < x.rows; ++r) {
+        for (int c = 0; c < x.cols; ++c) {
+            x.at(r, c) = static_cast<float>((r - 2) * 10 + c) * 0.37f;
+        }
+    }
+    const auto band = x.view().cols_slice(4, 6);
+    float lo = 0.0f;
+    float hi = 0.0f;
+    npu::find_range(band, lo, hi);
+    if (lo != x.at(0, 4) || hi != x.at(4, 9)) {
+        return {"quantize_views", false, "find_range read outside the band"};
+    }
+    const npu::QuantParams params = npu::compute_quant_params(lo, hi);
+    npu::Int8Matrix q(5, 6);
+    npu::quantize_matrix(band, params, q.view());
+    npu::FloatMatrix back(6, 5);
+    npu::dequantize_matrix(q.view(), params, back.view().transposed());
+    for (int r = 0; r < band.rows(); ++r) {
+        for (int c = 0; c < band.cols(); ++c) {
+            if (q.at(r, c) != npu::quantize(band.at(r, c), params) ||
+                std::abs(back.at(c, r) - band.at(r, c)) > params.scale) {
+                return {"quantize_views", false, "quantize/dequantize through views is wrong"};
+            }
+        }
+    }
+    npu::relu(back.view());
+    for (float value : back.data) {
+        if (value < 0.0f) {
+            return {"quantize_views", false, "in-place ReLU left a negative value"};
+        }
+    }
+    return {"quantize_views", true, ""};
+}
+
+TestResult test_tiler_on_views() {
+    std::mt19937 rng(9);
+    const npu::IntMatrix a_buf = random_int8_matrix(24, 40, rng);
+    const npu::IntMatrix b_buf = random_int8_matrix(30, 40, rng); // holds B^T
+    const auto a = a_buf.view().submatrix(1, 2, 13, 21);
+    const auto b = b_buf.view().submatrix(4, 10, 10, 21).transposed();
+    npu::CoreConfig cfg;
+    npu::TileStats view_stats;
+    npu::TileStats copy_stats;
+    const npu::Tiler tiler(cfg);
+    const npu::IntMatrix c = tiler.run(a, b, &view_stats);
+    const npu::IntMatrix expected = tiler.run(copy_of(a), copy_of(b), &copy_stats);
+    if (c.data != expected.data || c.data != npu::gemm_reference(copy_of(a), copy_of(b)).data) {
+        return {"tiler_on_views", false, "tiler on views differs from the copied operands"};
+    }
+    if (view_stats.core_cycles != copy_stats.core_cycles || view_stats.tiles != copy_stats.tiles) {
+        return {"tiler_on_views", false, "stats differ"};
+    }
+    return {"tiler_on_views", true, ""};
+}
+
+TestResult test_lazy_fusion() {
+    // quantize -> gemm -> relu -> dequantize / requantize, fused on
+    // assignment, against the same chain run kernel by kernel
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+    npu::FloatMatrix x(7, 12);
+    npu::FloatMatrix w(12, 5);
+    for (float& value : x.data) {
+        value = dist(rng);
+    }
+    for (float& value : w.data) {
+        value = dist(rng);
+    }
+    float lo = 0.0f;
+    float hi = 0.0f;
+    npu::find_range(x.view(), lo, hi);
+    const npu::QuantParams px = npu::compute_quant_params(lo, hi);
+    npu::find_range(w.view(), lo, hi);
+    const npu::QuantParams pw = npu::compute_quant_params(lo, hi);
+    const npu::QuantParams acc_params(px.scale * pw.scale, 0);
+    const float to_int8 = px.scale * pw.scale / 0.05f;
+
+    npu::Int8Matrix xq(7, 12);
+    npu::Int8Matrix wq(12, 5);
+    npu::Int32Matrix acc(7, 5);
+    npu::FloatMatrix expected(7, 5);
+    npu::quantize_matrix(x.view(), px, xq.view());
+    npu::quantize_matrix(w.view(), pw, wq.view());
+    npu::gemm(xq.view(), wq.view(), acc.view());
+    npu::relu(acc.view());
+    npu::dequantize_matrix(acc.view(), acc_params, expected.view());
+
+    namespace lazy = npu::lazy;
+    // Epilogue fusion over int8 operands read in place
+    npu::FloatMatrix fused(7, 5);
+    lazy::evaluate(fused.view(), lazy::dequantize(lazy::relu(lazy::gemm(xq.view(), wq.view())), acc_params));
+    if (fused.data != expected.data) {
+        return {"lazy_fusion", false, "fused GEMM epilogue differs from the kernel chain"};
+    }
+
+    // Float operands quantized in the prologue, result written transposed
+    npu::FloatMatrix fused_t(5, 7);
+    const auto chain = lazy::dequantize(
+        lazy::relu(lazy::gemm(lazy::quantize(x.view(), px), lazy::quantize(w.view(), pw))), acc_params);
+    lazy::evaluate(fused_t.view().transposed(), chain);
+    for (int r = 0; r < 7; ++r) {
+        for (int c = 0; c < 5; ++c) {
+            if (fused_t.at(c, r) != expected.at(r, c)) {
+                return {"lazy_fusion", false, "quantizing prologue or strided output is wrong"};
+            }
+        }
+    }
+
+    // Requantized int8 output for the next layer
+    const npu::Int8Matrix next = lazy::materialize(lazy::requantize(lazy::relu(lazy::gemm(xq.view(), wq.view())), to_int8));
+    for (int r = 0; r < 7; ++r) {
+        for (int c = 0; c < 5; ++c) {
+            if (next.at(r, c) != lazy::RequantizeOp{to_int8}(acc.at(r, c))) {
+                return {"lazy_fusion", false, "requantized output differs"};
+            }
+        }
+    }
+
+    // An int32 operand takes the per-element dot product. A copy of the
+    // evaluator must read its own copy of the quantized operand.
+    npu::Int32Matrix wi(12, 5);
+    std::copy(wq.data.begin(), wq.data.end(), wi.data.begin());
+    const auto dot = lazy::relu(lazy::gemm(lazy::quantize(x.view(), px), wi.view()));
+    std::optional<lazy::Evaluator<std::decay_t<decltype(dot)>>> original(std::in_place, dot);
+    const lazy::Evaluator<std::decay_t<decltype(dot)>> copy(*original);
+    original.reset();
+    for (int r = 0; r < 7; ++r) {
+        for (int c = 0; c < 5; ++c) {
+            if (copy.coeff(r, c) != acc.at(r, c)) {
+                return {"lazy_fusion", false, "copied dot-product evaluator differs"};
+            }
+        }
+    }
+    return {"lazy_fusion", true, ""};
+}
+
+TestResult test_incremental_gemm() {
+    std::mt19937 rng(29);
+    const int m = 64;
+    const int k = 32;
+    const int n = 48;
+    npu::IntMatrix a = random_int8_matrix(m, k, rng);
+    npu::IntMatrix b = random_int8_matrix(k, n, rng);
+    npu::IncrementalGemm<int32_t> inc(m, k, n);
+    inc.update_a_rows(0, a.view());
+    inc.update_b_cols(0, b.view());
+    if (!view_equals(inc.result(), npu::gemm_reference(a, b)) || inc.stats().saved_fraction() != 0.0) {
+        return {"incremental_gemm", false, "first refresh is not a full product"};
+    }
+
+    // Each step changes two rows of A and one column of B
+    for (int step = 0; step < 5; ++step) {
+        const npu::IntMatrix rows = random_int8_matrix(2, k, rng);
+        const npu::IntMatrix col = random_int8_matrix(k, 1, rng);
+        const int r0 = (step * 13) % (m - 1);
+        const int c0 = (step * 7) % n;
+        inc.update_a_rows(r0, rows.view());
+        inc.update_b_cols(c0, col.view());
+        for (int c = 0; c < k; ++c) {
+            a.at(r0, c) = rows.at(0, c);
+            a.at(r0 + 1, c) = rows.at(1, c);
+            b.at(c, c0) = col.at(c, 0);
+        }
+        if (!view_equals(inc.result(), npu::gemm_reference(a, b))) {
+            return {"incremental_gemm", false, "incremental result differs at step " + std::to_string(step)};
+        }
+    }
+
+    // In-place edit through a row view, and a refresh with nothing dirty
+    inc.a_row(5).at(0, 3) = 17;
+    a.at(5, 3) = 17;
+    if (!view_equals(inc.result(), npu::gemm_reference(a, b)) || !view_equals(inc.result(), npu::gemm_reference(a, b))) {
+        return {"incremental_gemm", false, "in-place row edit was missed"};
+    }
+
+    // 1 full refresh, 5 x (2 rows + 1 column), 1 row, 1 clean
+    const uint64_t dense = static_cast<uint64_t>(m) * n * k;
+    const uint64_t expected = dense + 5 * (2 * n + (m - 2)) * static_cast<uint64_t>(k) + n * static_cast<uint64_t>(k);
+    if (inc.stats().refreshes != 8 || inc.stats().macs != expected || inc.stats().dense_macs != 8 * dense) {
+        return {"incremental_gemm", false, "work accounting is wrong"};
+    }
+    std::cout << "incremental GEMM 64x32x48 (2 A rows + 1 B column per update): " << inc.stats().saved_fraction() * 100.0 << "% of MACs saved\n";
+    return {"incremental_gemm", true, ""};
+}
+
+TestResult test_sparse_2_4() {
+    std::mt19937 rng(31);
+    std::uniform_int_distribution<int> dist(-128, 127);
+    const int m = 9;
+    const int k = 38; // last group is partial
+    const int n = 21; // two AVX2 column panels, the second partial
+    npu::Int8Matrix a(m, k);
+    npu::Int8Matrix w(k, n);
+    for (auto& value : a.data) {
+        value = static_cast<int8_t>(dist(rng));
+    }
+    for (auto& value : w.data) {
+        value = static_cast<int8_t>(dist(rng));
+    }
+
+    bool threw = false;
+    try {
+        npu::compress_2_4(w.view());
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    if (!threw || npu::is_2_4_sparse(w.view())) {
+        return {"sparse_2_4", false, "dense weights were accepted as 2:4"};
+    }
+
+    npu::prune_2_4(w.view());
+    if (!npu::is_2_4_sparse(w.view())) {
+        return {"sparse_2_4", false, "pruned weights are not 2:4"};
+    }
+    const npu::Sparse24Matrix packed = npu::compress_2_4(w.view());
+    if (packed.values.size() != static_cast<std::size_t>(n) * 10 * 2 ||
+        packed.indices.size() != static_cast<std::size_t>(n) * 5 || npu::decompress_2_4(packed).data != w.data) {
+        return {"sparse_2_4", false, "compressed format does not round-trip"};
+    }
+
+    // Same product as the dense kernel on the pruned weights, read through a
+    // strided A (a column band of a wider buffer)
+    npu::Int8Matrix wide(m, k + 6);
+    for (int r = 0; r < m; ++r) {
+        for (int c = 0; c < k; ++c) {
+            wide.at(r, c + 3) = a.at(r, c);
+        }
+    }
+    npu::Int32Matrix dense(m, n);
+    npu::Int32Matrix sparse(m, n);
+    npu::gemm(a.view(), w.view(), dense.view());
+    npu::gemm_2_4(wide.view().cols_slice(3, k), packed, sparse.view());
+    if (sparse.data != dense.data) {
+        return {"sparse_2_4", false, "2:4 GEMM differs from the dense GEMM"};
+    }
+    // int32 A always takes the portable kernel
+    npu::Int32Matrix a32(m, k);
+    std::copy(a.data.begin(), a.data.end(), a32.data.begin());
+    npu::Int32Matrix portable(m, n);
+    npu::gemm_2_4(a32.view(), packed, portable.view());
+    if (portable.data != dense.data) {
+        return {"sparse_2_4", false, "portable 2:4 GEMM differs from the dense GEMM"};
+    }
+    return {"sparse_2_4", true, ""};
+}
+
+TestResult test_block_sparse() {
+    std::mt19937 rng(37);
+    const int m = 10;
+    const int k = 26; // edge blocks are partial in both K and N
+    const int n = 18;
+    npu::CoreConfig cfg;
+    const int bs = cfg.array_size;
+    const npu::IntMatrix a = random_int8_matrix(m, k, rng);
+    npu::IntMatrix w = random_int8_matrix(k, n, rng);
+    // Keep about a quarter of the blocks, like a block-pruned layer
+    int stored = 0;
+    for (int k0 = 0; k0 < k; k0 += bs) {
+        for (int n0 = 0; n0 < n; n0 += bs) {
+            const bool keep = rng() % 4 == 0;
+            stored += keep;
+            for (int kk = k0; kk < std::min(k, k0 + bs) && !keep; ++kk) {
+                for (int nn = n0; nn < std::min(n, n0 + bs); ++nn) {
+                    w.at(kk, nn) = 0;
+                }
+            }
+        }
+    }
+
+    const npu::BsrMatrix bsr = npu::to_bsr(w.view(), bs);
+    if (bsr.nonzero_blocks() != stored || npu::from_bsr<int32_t>(bsr).data != w.data) {
+        return {"block_sparse", false, "BSR format does not round-trip"};
+    }
+    const npu::IntMatrix expected = npu::gemm_reference(a, w);
+    npu::Int32Matrix c(m, n);
+    npu::gemm_bsr(a.view(), bsr, c.view());
+    if (c.data != expected.data) {
+        return {"block_sparse", false, "BSR GEMM differs from the dense GEMM"};
+    }
+
+    // The tiler sends only stored blocks, in both loop orders
+    npu::TileStats dense_stats;
+    npu::TileStats sparse_stats;
+    const npu::IntMatrix dense_c = npu::Tiler(cfg).run(a, w, &dense_stats);
+    npu::Tiler sparse_tiler(cfg);
+    sparse_tiler.set_skip_zero_b(true);
+    const npu::IntMatrix sparse_c = sparse_tiler.run(a, w, &sparse_stats);
+    cfg.operand_reuse = true;
+    npu::Tiler reuse_tiler(cfg);
+    reuse_tiler.set_skip_zero_b(true);
+    const npu::IntMatrix reuse_c = reuse_tiler.run(a, w);
+    if (dense_c.data != expected.data || sparse_c.data != expected.data || reuse_c.data != expected.data) {
+        return {"block_sparse", false, "tiler with skip_zero_b differs from the dense GEMM"};
+    }
+    const uint64_t row_jobs = static_cast<uint64_t>((m + bs - 1) / bs);
+    if (sparse_stats.b_bytes != row_jobs * stored * bs * bs || sparse_stats.tiles >= dense_stats.tiles) {
+        return {"block_sparse", false, "tiler sent B beats outside the stored blocks"};
+    }
+    std::cout << "block-sparse tiles: " << std::fixed << std::setprecision(2) << bsr.block_density()
+              << " density, " << sparse_stats.tiles << "/" << dense_stats.tiles << " jobs, "
+              << sparse_stats.b_bytes << "/" << dense_stats.b_bytes << " B bytes\n";
+    return {"block_sparse", true, ""};
+}
+
+TestResult test_numa_pool() {
+    // Huge pages fall back quietly; whatever backs the buffer, it must be
+    // page aligned, zeroed and usable
+    npu::AllocOptions options;
+    options.pages = npu::PageSize::Huge2M;
+    options.node = npu::numa_topology().node_ids[0];
+    const std::size_t bytes = (std::size_t{3} << 20) + 100;
+    npu::PageBuffer buffer(bytes, options);
+    auto* raw = static_cast<unsigned char*>(buffer.data());
+    if (reinterpret_cast<std::uintptr_t>(raw) % 4096 != 0 || buffer.mapped_bytes() < bytes ||
+        std::any_of(raw, raw + bytes, [](unsigned char v) { return v != 0; })) {
+        return {"numa_pool", false, "page buffer is not aligned, sized and zeroed"};
+    }
+    raw[bytes - 1] = 1;
+
+    npu::Arena arena(4096);
+    auto* first = arena.allocate_array<int32_t>(10);
+    auto* second = arena.allocate_array<int8_t>(3);
+    if (reinterpret_cast<std::uintptr_t>(second) % 64 != 0 || second <= reinterpret_cast<int8_t*>(first + 9)) {
+        return {"numa_pool", false, "arena allocations overlap or are misaligned"};
+    }
+    bool full = false;
+    try {
+        arena.allocate(4096);
+    } catch (const std::bad_alloc&) {
+        full = true;
+    }
+    arena.reset();
+    if (!full || arena.used() != 0) {
+        return {"numa_pool", false, "arena does not report exhaustion or reset"};
+    }
+
+    // Every item runs exactly once, even with more workers than CPUs
+    npu::ThreadPool pool(3);
+    std::vector<std::atomic<int>> runs(100);
+    pool.parallel_for(100, [&](int index, int) { ++runs[index]; });
+    if (std::any_of(runs.begin(), runs.end(), [](const std::atomic<int>& n) { return n != 1; })) {
+        return {"numa_pool", false, "parallel_for did not run every item once"};
+    }
+
+    std::mt19937 rng(41);
+    const int m = 77;
+    const npu::IntMatrix a = random_int8_matrix(m, 50, rng);
+    const npu::IntMatrix b = random_int8_matrix(50, 23, rng);
+    const npu::IntMatrix expected = npu::gemm_reference(a, b);
+    npu::PageMatrix<int32_t> c(m, b.cols, options);
+    pool.first_touch(c.view().data(), static_cast<std::size_t>(m) * b.cols * sizeof(int32_t),
+                     static_cast<std::size_t>(npu::kGemmStripRows) * b.cols * sizeof(int32_t));
+    npu::gemm_parallel(pool, a.view(), b.view(), c.view());
+    if (!view_equals(c.view(), expected)) {
+        return {"numa_pool", false, "parallel GEMM differs from the reference"};
+    }
+    const npu::Replicated<int8_t> weights(b.view());
+    npu::Int32Matrix c2(m, b.cols);
+    npu::gemm_parallel(pool, a.view(), weights, c2.view());
+    if (weights.copies() != npu::numa_topology().nodes() || !view_equals(c2.view(), expected)) {
+        return {"numa_pool", false, "GEMM on replicated weights differs from the reference"};
+    }
+    std::cout << "page buffer: " << npu::page_backing_name(buffer.backing()) << " pages, "
+              << npu::numa_topology().nodes() << " node(s), bound " << (buffer.bound() ? "yes" : "no") << "\n";
+    return {"numa_pool", true, ""};
+}
+
+TestResult test_jit_microkernels() {
+    std::mt19937 rng(43);
+    npu::ThreadPool pool(2);
+    // Shapes cover short strips, narrow panels, odd K and the corner tile
+    const int shapes[][3] = {{6, 16, 8}, {13, 9, 21}, {1, 1, 3}, {40, 33, 17}};
+    for (const auto& shape : shapes) {
+        const int m = shape[0];
+        const int k = shape[1];
+        const int n = shape[2];
+        const npu::IntMatrix a = random_int8_matrix(m, k, rng);
+        const npu::IntMatrix b = random_int8_matrix(k, n, rng);
+        std::vector<int32_t> bias(static_cast<std::size_t>(n));
+        for (auto& value : bias) {
+            value = static_cast<int32_t>(rng() % 40001) - 20000;
+        }
+        const npu::PackedB packed(b.view());
+        for (int variant = 0; variant < 4; ++variant) {
+            npu::GemmEpilogue epilogue;
+            epilogue.bias = (variant & 1) ? bias.data() : nullptr;
+            epilogue.relu = (variant & 2) != 0;
+            npu::IntMatrix expected = npu::gemm_reference(a, b);
+            for (int r = 0; r < m; ++r) {
+                for (int c = 0; c < n; ++c) {
+                    const int32_t value = expected.at(r, c) + (epilogue.bias ? bias[c] : 0);
+                    expected.at(r, c) = epilogue.relu ? std::max(value, 0) : value;
+                }
+            }
+            npu::Int32Matrix fixed(m, n);
+            npu::Int32Matrix jit(m, n);
+            npu::Int32Matrix pooled(m, n);
+            npu::Int32Matrix ct(n, m); // C written through a transposed view
+            npu::gemm_packed(a.view(), packed, fixed.view(), epilogue, false);
+            npu::gemm_packed(a.view(), packed, jit.view(), epilogue);
+            npu::gemm_packed(pool, a.view(), packed, pooled.view(), epilogue);
+            npu::gemm_packed(a.view(), packed, ct.view().transposed(), epilogue);
+            if (!view_equals(fixed.view(), expected) || !view_equals(jit.view(), expected) ||
+                !view_equals(pooled.view(), expected) || !view_equals(ct.view().transposed(), expected)) {
+                return {"jit_microkernels", false,
+                        "packed GEMM differs from the reference at " + std::to_string(m) + "x" + std::to_string(k) +
+                            "x" + std::to_string(n)};
+            }
+        }
+    }
+    std::cout << "JIT microkernels: "
+              << (npu::JitKernelCache::available() ? std::to_string(npu::jit_kernels().kernels()) + " shapes cached"
+                                                   : std::string("unavailable, static kernels checked"))
+              << "\n";
+    return {"jit_microkernels", true, ""};
+}
+
+TestResult test_gemv_decode() {
+    std::mt19937 rng(47);
+    npu::ThreadPool pool(3);
+    // Odd K exercises the int4 half byte; N covers short row groups and
+    // blocks split across workers
+    const int shapes[][2] = {{1, 1}, {7, 5}, {130, 67}, {257, 200}};
+    for (const auto& shape : shapes) {
+        const int k = shape[0];
+        const int n = shape[1];
+        const npu::IntMatrix x = random_int8_matrix(1, k, rng);
+        npu::IntMatrix w = random_int8_matrix(k, n, rng);
+        for (auto& value : w.data) {
+            value >>= 4; // int4 range, so both formats hold the same weights
+        }
+        std::vector<int32_t> bias(static_cast<std::size_t>(n));
+        for (auto& value : bias) {
+            value = static_cast<int32_t>(rng() % 40001) - 20000;
+        }
+        const npu::GemvWeights w8(pool, w.view(), npu::GemvFormat::Int8);
+        const npu::GemvWeights w4(pool, w.view(), npu::GemvFormat::Int4);
+        for (int variant = 0; variant < 4; ++variant) {
+            npu::GemmEpilogue epilogue;
+            epilogue.bias = (variant & 1) ? bias.data() : nullptr;
+            epilogue.relu = (variant & 2) != 0;
+            npu::IntMatrix expected = npu::gemm_reference(x, w);
+            for (int c = 0; c < n; ++c) {
+                const int32_t value = expected.at(0, c) + (epilogue.bias ? bias[c] : 0);
+                expected.at(0, c) = epilogue.relu ? std::max(value, 0) : value;
+            }
+            npu::Int32Matrix y8(1, n);
+            npu::Int32Matrix y4(1, n);
+            npu::gemv(pool, x.view(), w8, y8.view(), epilogue);
+            npu::gemv(pool, x.view(), w4, y4.view(), epilogue);
+            if (!view_equals(y8.view(), expected) || !view_equals(y4.view(), expected)) {
+                return {"gemv_decode", false,
+                        "GEMV differs from the reference at 1x" + std::to_string(k) + "x" + std::to_string(n)};
+            }
+        }
+    }
+    npu::IntMatrix wide(4, 4);
+    wide.at(2, 1) = 8;
+    try {
+        npu::GemvWeights rejected(pool, wide.view(), npu::GemvFormat::Int4);
+        return {"gemv_decode", false, "int4 packing accepted a weight of 8"};
+    } catch (const std::invalid_argument&) {
+    }
+    std::cout << "GEMV: int8 and int4 match the reference, "
+              << (npu::detail::gemv_avx2() ? "AVX2" : "portable") << " kernels\n";
+    return {"gemv_decode", true, ""};
+}
+
+TestResult test_transpose_flags() {
+    std::mt19937 rng(53);
+    npu::ThreadPool pool(2);
+    npu::CoreConfig cfg;
+    const npu::Tiler tiler(cfg);
+    const int m = 19;
+    const int k = 23;
+    const int n = 17;
+    const npu::IntMatrix a = random_int8_matrix(m, k, rng);
+    const npu::IntMatrix b = random_int8_matrix(k, n, rng);
+    // Each operand also stored transposed, as a pipeline would hold it
+    const npu::IntMatrix at = copy_of(a.view().transposed());
+    const npu::IntMatrix bt = copy_of(b.view().transposed());
+    const npu::IntMatrix expected = npu::gemm_reference(a, b);
+    const npu::Transpose flags[] = {npu::Transpose::No, npu::Transpose::Yes};
+    const char* names[] = {"N", "T"};
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            const npu::Transpose ta = flags[i];
+            const npu::Transpose tb = flags[j];
+            const npu::IntMatrix& stored_a = i ? at : a;
+            const npu::IntMatrix& stored_b = j ? bt : b;
+            npu::IntMatrix plain(m, n);
+            npu::Int32Matrix packed_c(m, n);
+            npu::Int32Matrix pooled(m, n);
+            npu::gemm(ta, tb, stored_a.view(), stored_b.view(), plain.view());
+            const npu::PackedB packed(stored_b.view(), tb);
+            npu::gemm_packed(ta, stored_a.view(), packed, packed_c.view());
+            npu::gemm_packed(pool, ta, stored_a.view(), packed, pooled.view());
+            const npu::IntMatrix tiled = tiler.run(ta, stored_a.view(), tb, stored_b.view());
+            if (plain.data != expected.data || !view_equals(packed_c.view(), expected) ||
+                !view_equals(pooled.view(), expected) || tiled.data != expected.data) {
+                return {"transpose_flags", false,
+                        std::string(names[i]) + names[j] + " product differs from the reference"};
+            }
+        }
+    }
+    return {"transpose_flags", true, ""};
+}
+
+TestResult test_grouped_gemm() {
+    std::mt19937 rng(59);
+    npu::ThreadPool pool(3);
+    // Expert token counts as routed by an MoE layer: skewed, with an idle
+    // expert; the last expert has its own K and N
+    const int token_counts[] = {45, 1, 0, 7, 130, 13};
+    const int k = 40;
+    const int n = 29;
+    std::vector<npu::IntMatrix> a;
+    std::vector<npu::IntMatrix> w;
+    std::vector<npu::PackedB> packed;
+    std::vector<npu::Int32Matrix> c;
+    std::vector<int32_t> bias(static_cast<std::size_t>(n + 8));
+    for (auto& value : bias) {
+        value = static_cast<int32_t>(rng() % 40001) - 20000;
+    }
+    for (int e = 0; e < 6; ++e) {
+        const int ke = e == 5 ? k + 9 : k;
+        const int ne = e == 5 ? n + 8 : n;
+        a.push_back(random_int8_matrix(token_counts[e], ke, rng));
+        w.push_back(random_int8_matrix(ke, ne, rng));
+        c.emplace_back(token_counts[e], ne);
+    }
+    for (int e = 0; e < 6; ++e) {
+        packed.emplace_back(w[e].view());
+    }
+    std::vector<npu::GemmProblem<const int32_t>> problems;
+    std::vector<npu::TileProblem> tiles;
+    for (int e = 0; e < 6; ++e) {
+        npu::GemmProblem<const int32_t> problem;
+        problem.a = a[e].view();
+        problem.b = &packed[e];
+        problem.c = c[e].view();
+        problem.epilogue.bias = (e % 2) ? bias.data() : nullptr;
+        problem.epilogue.relu = e >= 3;
+        problems.push_back(problem);
+        tiles.push_back({a[e].view(), w[e].view()});
+    }
+    npu::gemm_grouped(pool, problems);
+
+    npu::CoreConfig cfg;
+    const npu::Tiler tiler(cfg);
+    npu::TileStats grouped_stats;
+    npu::TileStats single_stats;
+    const std::vector<npu::IntMatrix> tiled = tiler.run_grouped(tiles, &grouped_stats);
+    for (int e = 0; e < 6; ++e) {
+        const npu::IntMatrix reference = npu::gemm_reference(a[e], w[e]);
+        npu::IntMatrix expected = reference;
+        for (int r = 0; r < expected.rows; ++r) {
+            for (int col = 0; col < expected.cols; ++col) {
+                const int32_t value = expected.at(r, col) + (problems[e].epilogue.bias ? bias[col] : 0);
+                expected.at(r, col) = problems[e].epilogue.relu ? std::max(value, 0) : value;
+            }
+        }
+        if (!view_equals(c[e].view(), expected)) {
+            return {"grouped_gemm", false, "expert " + std::to_string(e) + " differs from the reference"};
+        }
+        if (tiled[static_cast<std::size_t>(e)].data != reference.data ||
+            tiler.run(a[e], w[e], &single_stats).data != reference.data) {
+            return {"grouped_gemm", false, "tiler expert " + std::to_string(e) + " differs from the reference"};
+        }
+    }
+    if (grouped_stats.tiles != single_stats.tiles || grouped_stats.core_cycles != single_stats.core_cycles) {
+        return {"grouped_gemm", false, "grouped tiler stats differ from the per-expert runs"};
+    }
+
+    // In-core ReLU is decided per problem: an expert whose K fits one job
+    // sends a sparse result stream in the group as it does on its own
+    npu::CoreConfig relu_cfg;
+    relu_cfg.relu = true;
+    relu_cfg.sparse_stream = true;
+    const npu::Tiler relu_tiler(relu_cfg);
+    const npu::IntMatrix short_a = random_int8_matrix(9, relu_cfg.max_k, rng);
+    const npu::IntMatrix short_w = random_int8_matrix(relu_cfg.max_k, n, rng);
+    std::vector<npu::TileProblem> mixed = tiles;
+    mixed.push_back({short_a.view(), short_w.view()});
+    npu::TileStats mixed_stats;
+    npu::TileStats mixed_single;
+    const std::vector<npu::IntMatrix> activated = relu_tiler.run_grouped(mixed, &mixed_stats);
+    for (std::size_t e = 0; e < mixed.size(); ++e) {
+        if (activated[e].data != relu_tiler.run(mixed[e].a, mixed[e].b, &mixed_single).data) {
+            return {"grouped_gemm", false, "grouped ReLU expert " + std::to_string(e) + " differs from its own run"};
+        }
+    }
+    if (mixed_stats.output_words != mixed_single.output_words || mixed_stats.core_cycles != mixed_single.core_cycles) {
+        return {"grouped_gemm", false, "grouped ReLU stats differ from the per-expert runs"};
+    }
+    std::cout << "Grouped GEMM: 6 experts, " << grouped_stats.tiles << " tiles in one stream\n";
+    return {"grouped_gemm", true, ""};
+}
+
+} // namespace
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "  NPU Host Library Testbench\n";
+    std::cout << "========================================\n\n";
+
+    std::vector<TestResult> results;
+
+    results.push_back(test_view_slicing());
+    results.push_back(test_strided_gemm());
+    results.push_back(test_quantize_views());
+    results.push_back(test_tiler_on_views());
+    results.push_back(test_lazy_fusion());
+    results.push_back(test_incremental_gemm());
+    results.push_back(test_sparse_2_4());
+    results.push_back(test_block_sparse());
+    results.push_back(test_numa_pool());
+    results.push_back(test_jit_microkernels());
+    results.push_back(test_gemv_decode());
+    results.push_back(test_transpose_flags());
+    results.push_back(test_grouped_gemm());
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto& result : results) {
+        std::cout << "[" << (result.passed ? "PASS" : "FAIL") << "] "
+                  << result.name;
+        if (!result.passed) {
+            std::cout << " - " << result.message;
+        }
+        std::cout << "\n";
+
+        if (result.passed) {
+            ++passed;
+        } else {
+            ++failed;
+        }
+    }
+
+    std::cout << "\n========================================\n";
+    std::cout << "Results: " << passed << " passed, " << failed << " failed\n";
+    std::cout << "========================================\n";
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) && !defined(_WIN32) && defined(__GNUC__)
+#define NPU_JIT_X86_64 1
+#include <sys/mman.h>
+#endif
+
+// Runtime-generated GEMM microkernels for x86-64 with AVX2. A kernel is
+// emitted for one exact tile shape: mr x nr outputs over k_pairs pairs of K,
+// with the K loop fully unrolled, the tile edge baked into its store mask
+// and the bias/ReLU epilogue applied in registers before the single store.
+// Kernels are generated on first use and cached per shape for the life of
+// the process. On other targets (or without AVX2) kernel() returns null and
+// the caller runs its static kernel instead.
+//
+// Operand layout (see npu_gemm.hpp): A strips hold kJitRows rows as int16
+// pairs (a[k], a[k+1]) per row, so one dword broadcast feeds vpmaddwd; B
+// panels hold kJitCols columns as int16 pairs, 32 bytes per k pair. Kernels
+// use the System V calling convention and ymm0-ymm10.
+namespace npu {
+
+constexpr int kJitRows = 6; // MR: accumulator rows per tile
+constexpr int kJitCols = 8; // NR: int32 lanes of one ymm
+
+// (a strip, b panel, c, ldc in elements, bias for this tile's columns)
+using JitKernelFn = void (*)(const int16_t*, const int16_t*, int32_t*, std::ptrdiff_t, const int32_t*);
+
+struct JitShape {
+    int mr = kJitRows;
+    int nr = kJitCols;
+    int k_pairs = 0;
+    bool bias = false;
+    bool relu = false;
+
+    bool operator<(const JitShape& other) const {
+        return std::tie(mr, nr, k_pairs, bias, relu) <
+               std::tie(other.mr, other.nr, other.k_pairs, other.bias, other.relu);
+    }
+};
+
+// ============================================================================
+// Emitter
+// ============================================================================
+
+// Just enough of the x86-64 encoding for the microkernels: VEX-encoded AVX2
+// ops on ymm registers with [base + disp32] or RIP-relative memory operands
+class X86Emitter {
+public:
+    enum Reg { rax = 0, rcx = 1, rdx = 2, rsi = 6, rdi = 7, r8 = 8 };
+
+    const std::vector<uint8_t>& code() const { return code_; }
+    std::size_t size() const { return code_.size(); }
+
+    void vpxor(int dst, int src1, int src2) { vex_rr(1, 1, 0xef, dst, src1, src2); }
+    void vpaddd(int dst, int src1, int src2) { vex_rr(1, 1, 0xfe, dst, src1, src2); }
+    void vpmaddwd(int dst, int src1, int src2) { vex_rr(1, 1, 0xf5, dst, src1, src2); }
+    void vpmaxsd(int dst, int src1, int src2) { vex_rr(1, 2, 0x3d, dst, src1, src2); }
+
+    void vpbroadcastd(int dst, Reg base, int32_t disp) { vex_mem(1, 2, 0x58, dst, 0, base, disp); }
+    void vmovdqu_load(int dst, Reg base, int32_t disp) { vex_mem(2, 1, 0x6f, dst, 0, base, disp); }
+    void vmovdqu_store(Reg base, int32_t disp, int src) { vex_mem(2, 1, 0x7f, src, 0, base, disp); }
+    void vpmaskmovd_load(int dst, int mask, Reg base, int32_t disp) { vex_mem(1, 2, 0x8c, dst, mask, base, disp); }
+    void vpmaskmovd_store(Reg base, int32_t disp, int mask, int src) { vex_mem(1, 2, 0x8e, src, mask, base, disp); }
+
+    // vmovdqu dst, [rip + disp32]; returns the displacement offset for bind_data
+    std::size_t vmovdqu_rip(int dst) {
+        vex_prefix(2, 1, dst, 0, 0);
+        code_.push_back(0x6f);
+        code_.push_back(static_cast<uint8_t>(((dst & 7) << 3) | 5));
+        const std::size_t fixup = code_.size();
+        put32(0);
+        return fixup;
+    }
+
+    void shl_rcx_2() { code_.insert(code_.end(), {0x48, 0xc1, 0xe1, 0x02}); }
+    void add_rdx_rcx() { code_.insert(code_.end(), {0x48, 0x01, 0xca}); }
+    void vzeroupper() { code_.insert(code_.end(), {0xc5, 0xf8, 0x77}); }
+    void ret() { code_.push_back(0xc3); }
+
+    // Appends 32-byte aligned data and points the RIP-relative load at it
+    void bind_data(std::size_t fixup, const void* data, std::size_t bytes) {
+        while (code_.size() % 32 != 0) {
+            code_.push_back(0xcc);
+        }
+        const int32_t disp = static_cast<int32_t>(code_.size() - (fixup + 4));
+        std::memcpy(&code_[fixup], &disp, sizeof(disp));
+        const auto* bytes_in = static_cast<const uint8_t*>(data);
+        code_.insert(code_.end(), bytes_in, bytes_in + bytes);
+    }
+
+private:
+    void put32(int32_t value) {
+        uint8_t bytes[4];
+        std::memcpy(bytes, &value, sizeof(bytes));
+        code_.insert(code_.end(), bytes, bytes + 4);
+    }
+
+    // Three-byte VEX, 256-bit, W0. pp: 1 = 66, 2 = F3; map: 1 = 0F, 2 = 0F38
+    void vex_prefix(int pp, int map, int reg, int vvvv, int rm) {
+        code_.push_back(0xc4);
+        code_.push_back(static_cast<uint8_t>(((reg & 8) ? 0 : 0x80) | 0x40 | ((rm & 8) ? 0 : 0x20) | map));
+        code_.push_back(static_cast<uint8_t>(((~vvvv & 15) << 3) | 0x04 | pp));
+    }
+
+    void vex_rr(int pp, int map, uint8_t op, int dst, int src1, int src2) {
+        vex_prefix(pp, map, dst, src1, src2);
+        code_.push_back(op);
+        code_.push_back(static_cast<uint8_t>(0xc0 | ((dst & 7) << 3) | (src2 & 7)));
+    }
+
+    // [base + disp32]; base is never rsp or r12, so no SIB byte is needed
+    void vex_mem(int pp, int map, uint8_t op, int reg, int vvvv, Reg base, int32_t disp) {
+        vex_prefix(pp, map, reg, vvvv, base);
+        code_.push_back(op);
+        code_.push_back(static_cast<uint8_t>(0x80 | ((reg & 7) << 3) | (base & 7)));
+        put32(disp);
+    }
+
+    std::vector<uint8_t> code_;
+};
+
+// Machine code for one tile shape. Registers: ymm0..mr-1 accumulators,
+// ymm6 B pair row, ymm7 A broadcast, ymm8 products, ymm9 column mask,
+// ymm10 zero.
+inline std::vector<uint8_t> emit_gemm_kernel(const JitShape& shape) {
+    using E = X86Emitter;
+    constexpr int kB = 6;
+    constexpr int kA = 7;
+    constexpr int kProd = 8;
+    constexpr int kMask = 9;
+    constexpr int kZero = 10;
+    const bool edge = shape.nr < kJitCols;
+    E e;
+    for (int i = 0; i < shape.mr; ++i) {
+        e.vpxor(i, i, i);
+    }
+    for (int kp = 0; kp < shape.k_pairs; ++kp) {
+        e.vmovdqu_load(kB, E::rsi, kp * kJitCols * 4);
+        for (int i = 0; i < shape.mr; ++i) {
+            e.vpbroadcastd(kA, E::rdi, (kp * kJitRows + i) * 4);
+            e.vpmaddwd(kProd, kA, kB);
+            e.vpaddd(i, i, kProd);
+        }
+    }
+    std::size_t mask_fixup = 0;
+    if (edge) {
+        mask_fixup = e.vmovdqu_rip(kMask);
+    }
+    if (shape.bias) {
+        if (edge) {
+            e.vpmaskmovd_load(kB, kMask, E::r8, 0);
+        } else {
+            e.vmovdqu_load(kB, E::r8, 0);
+        }
+        for (int i = 0; i < shape.mr; ++i) {
+            e.vpaddd(i, i, kB);
+        }
+    }
+    if (shape.relu) {
+        e.vpxor(kZero, kZero, kZero);
+        for (int i = 0; i < shape.mr; ++i) {
+            e.vpmaxsd(i, i, kZero);
+        }
+    }
+    e.shl_rcx_2(); // ldc in bytes
+    for (int i = 0; i < shape.mr; ++i) {
+        if (edge) {
+            e.vpmaskmovd_store(E::rdx, 0, kMask, i);
+        } else {
+            e.vmovdqu_store(E::rdx, 0, i);
+        }
+        if (i + 1 < shape.mr) {
+            e.add_rdx_rcx();
+        }
+    }
+    e.vzeroupper();
+    e.ret();
+    if (edge) {
+        int32_t mask[kJitCols];
+        for (int j = 0; j < kJitCols; ++j) {
+            mask[j] = j < shape.nr ? -1 : 0;
+        }
+        e.bind_data(mask_fixup, mask, sizeof(mask));
+    }
+    return e.code();
+}
+
+// ============================================================================
+// Kernel Cache
+// ============================================================================
+
+class JitKernelCache {
+public:
+    JitKernelCache() = default;
+    ~JitKernelCache() {
+#ifdef NPU_JIT_X86_64
+        for (const auto& region : regions_) {
+            ::munmap(region.first, region.second);
+        }
+#endif
+    }
+
+    JitKernelCache(const JitKernelCache&) = delete;
+    JitKernelCache& operator=(const JitKernelCache&) = delete;
+
+    // True when this build and CPU can run generated kernels
+    static bool available() {
+#ifdef NPU_JIT_X86_64
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+#else
+        return false;
+#endif
+    }
+
+    // Kernel for shape, generated on first use; null if the JIT is
+    // unavailable or the shape is outside its limits
+    JitKernelFn kernel(const JitShape& shape) {
+        if (!available() || shape.mr < 1 || shape.mr > kJitRows || shape.nr < 1 || shape.nr > kJitCols ||
+            shape.k_pairs < 1 || shape.k_pairs > kMaxKPairs) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto found = kernels_.find(shape);
+        if (found != kernels_.end()) {
+            return found->second;
+        }
+        JitKernelFn fn = install(emit_gemm_kernel(shape));
+        kernels_[shape] = fn;
+        return fn;
+    }
+
+    std::size_t kernels() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return kernels_.size();
+    }
+
+    // Fully unrolled K keeps code size linear in K: ~140 bytes per k pair
+    // at mr = 6, so 4096-deep K is a ~280 KB kernel
+    static constexpr int kMaxKPairs = 2048;
+
+private:
+    // Copies code into fresh pages and makes them executable (never
+    // writable and executable at once); null if the OS refuses
+    JitKernelFn install(const std::vector<uint8_t>& code) {
+#ifdef NPU_JIT_X86_64
+        const std::size_t bytes = (code.size() + 4095) / 4096 * 4096;
+        void* mem = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            return nullptr;
+        }
+        std::memcpy(mem, code.data(), code.size());
+        if (::mprotect(mem, bytes, PROT_READ | PROT_EXEC) != 0) {
+            ::munmap(mem, bytes);
+            return nullptr;
+        }
+        regions_.emplace_back(mem, bytes);
+        return reinterpret_cast<JitKernelFn>(mem);
+#else
+        (void)code;
+        return nullptr;
+#endif
+    }
+
+    mutable std::mutex mutex_;
+    std::map<JitShape, JitKernelFn> kernels_;
+    std::vector<std::pair<void*, std::size_t>> regions_;
+};
+
+// Process-wide cache shared by every GEMM call
+inline JitKernelCache& jit_kernels() {
+    static JitKernelCache cache;
+    return cache;
+}
+
+} // namespace npu
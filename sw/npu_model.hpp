@@ -0,0 +1,776 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "npu_config.hpp"
+#include "npu_view.hpp"
+
+// Cycle-approximate C++ model of the NPU cores plus a host-side tiler that
+// maps arbitrary M x K x N int8 GEMMs onto ARRAY_SIZE x ARRAY_SIZE tiles.
+namespace npu {
+
+// ============================================================================
+// Core Configuration
+// ============================================================================
+
+enum class CoreVariant {
+    Broadcast, // rtl/npu_core.sv: operands broadcast along rows/columns
+    Systolic   // rtl/npu_systolic.sv: operands forwarded PE to PE
+};
+
+struct CoreConfig {
+    int array_size = kNpuParams.array_size;
+    int data_width = kNpuParams.data_width;
+    int max_k = kNpuParams.max_k; // MAX_K: longest accumulation per job, in beats
+    int extra_acc_bits = kNpuParams.extra_acc_bits;
+    int pe_pipeline = 0;    // PE_PIPELINE: product register stages in each PE
+    bool back_to_back = false; // BACK_TO_BACK: start with the first beat, overlap streaming (npu_core only)
+    bool relu = false;
+    bool int4_weights = false; // int4_mode on a DUAL_INT4 build (broadcast core only)
+    bool sparse_stream = false; // SPARSE_STREAM: only non-zero results + end marker
+    int num_cores = 1;      // NUM_CORES of an npu_cluster sharing the B broadcast
+    bool operand_reuse = false; // npu_reuse front end: A panel stays resident while B panels stream
+    CoreVariant variant = CoreVariant::Broadcast;
+};
+
+inline int ceil_log2(int value) {
+    int bits = 0;
+    while ((1 << bits) < value) {
+        ++bits;
+    }
+    return bits;
+}
+
+inline int acc_width(const CoreConfig& cfg) {
+    return (2 * cfg.data_width) + ceil_log2(cfg.max_k) + cfg.extra_acc_bits;
+}
+
+// Output columns per tile: each b_stream lane carries two weights in int4 mode
+inline int tile_cols(const CoreConfig& cfg) {
+    return cfg.int4_weights ? 2 * cfg.array_size : cfg.array_size;
+}
+
+// Words streamed per tile
+inline int output_count(const CoreConfig& cfg) {
+    return cfg.array_size * tile_cols(cfg);
+}
+
+// Cycles from the last operand beat entering stage0 to the final accumulate.
+// Broadcast: stage1 register + PE, plus the PE product register if enabled.
+// Systolic adds the skew/forwarding path across the array diagonal.
+inline int pipeline_depth(const CoreConfig& cfg) {
+    int depth = 2 + cfg.pe_pipeline;
+    if (cfg.variant == CoreVariant::Systolic) {
+        depth += 2 * (cfg.array_size - 1);
+    }
+    return depth;
+}
+
+// Cycles from the start pulse being sampled until done/c_valid is asserted,
+// for a job of k beats (k = array_size unless in_last ends it early).
+// BACK_TO_BACK pops the first beat in the start cycle itself.
+inline int compute_latency(const CoreConfig& cfg, int k) {
+    return (cfg.back_to_back ? 0 : 1) + k + pipeline_depth(cfg);
+}
+
+inline int compute_latency(const CoreConfig& cfg) {
+    return compute_latency(cfg, cfg.array_size);
+}
+
+// Start-to-start period for one tile with result_ready held high:
+// compute, one cycle to launch the streamer, one word per cycle, final handshake.
+// BACK_TO_BACK restarts on the done cycle and streams from a snapshot, so in
+// steady state a tile costs the longer of its compute and its stream; done
+// waits for the streamer to go idle, one cycle after the final handshake.
+inline int tile_cycles(const CoreConfig& cfg, int k, int words) {
+    if (cfg.back_to_back) {
+        return std::max(compute_latency(cfg, k), words + 3);
+    }
+    return compute_latency(cfg, k) + 1 + words + 1;
+}
+
+inline int tile_cycles(const CoreConfig& cfg, int k) {
+    return tile_cycles(cfg, k, output_count(cfg));
+}
+
+inline int tile_cycles(const CoreConfig& cfg) {
+    return tile_cycles(cfg, cfg.array_size);
+}
+
+// ============================================================================
+// Matrix Storage
+// ============================================================================
+
+struct IntMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int32_t> data;
+
+    IntMatrix() = default;
+    IntMatrix(int r, int c) : rows(r), cols(c), data(static_cast<std::size_t>(r) * c, 0) {}
+
+    int32_t& at(int r, int c) { return data[static_cast<std::size_t>(r) * cols + c]; }
+    int32_t at(int r, int c) const { return data[static_cast<std::size_t>(r) * cols + c]; }
+
+    MatrixView<int32_t> view() { return {data.data(), rows, cols}; }
+    MatrixView<const int32_t> view() const { return {data.data(), rows, cols}; }
+};
+
+inline IntMatrix gemm_reference(const IntMatrix& a, const IntMatrix& b) {
+    if (a.cols != b.rows) {
+        throw std::invalid_argument("gemm_reference: inner dimensions differ");
+    }
+    IntMatrix c(a.rows, b.cols);
+    for (int i = 0; i < a.rows; ++i) {
+        for (int j = 0; j < b.cols; ++j) {
+            int32_t sum = 0;
+            for (int k = 0; k < a.cols; ++k) {
+                sum += a.at(i, k) * b.at(k, j);
+            }
+            c.at(i, j) = sum;
+        }
+    }
+    return c;
+}
+
+// Sign-extend the low `width` bits, mirroring the RTL accumulator wrap
+inline int32_t wrap_to_width(int64_t value, int width) {
+    const int64_t mask = (int64_t{1} << width) - 1;
+    int64_t v = value & mask;
+    if (v & (int64_t{1} << (width - 1))) {
+        v -= (int64_t{1} << width);
+    }
+    return static_cast<int32_t>(v);
+}
+
+// k indices whose A column is non-zero within rows [r0, r0 + rows). A beat
+// for any other k adds nothing to that output tile row, so it can be skipped.
+// Never empty for K > 0, since every job needs at least one beat.
+inline std::vector<int> nonzero_k_beats(MatrixView<const int32_t> a, int r0, int rows) {
+    std::vector<int> kept;
+    const int r_end = std::min(a.rows(), r0 + rows);
+    for (int k = 0; k < a.cols(); ++k) {
+        for (int r = r0; r < r_end; ++r) {
+            if (a.at(r, k) != 0) {
+                kept.push_back(k);
+                break;
+            }
+        }
+    }
+    if (kept.empty() && a.cols() > 0) {
+        kept.push_back(0);
+    }
+    return kept;
+}
+
+inline std::vector<int> nonzero_k_beats(const IntMatrix& a, int r0, int rows) {
+    return nonzero_k_beats(a.view(), r0, rows);
+}
+
+// ============================================================================
+// Result Stream
+// ============================================================================
+
+// One result_valid/result_ready handshake of npu_result_stream
+struct StreamWord {
+    int index = 0;     // result_index: row-major position in the tile
+    int32_t data = 0;  // result_data
+    bool last = false; // result_last: end of tile
+};
+
+// Words emitted for one activated tile. Sparse streams skip zero results but
+// always emit the final element as the end-of-tile marker.
+inline std::vector<StreamWord> stream_tile(const IntMatrix& tile, bool sparse) {
+    std::vector<StreamWord> words;
+    const int count = static_cast<int>(tile.data.size());
+    for (int idx = 0; idx < count; ++idx) {
+        const bool last = (idx == count - 1);
+        if (!sparse || last || tile.data[idx] != 0) {
+            words.push_back({idx, tile.data[idx], last});
+        }
+    }
+    return words;
+}
+
+// Host-side scatter decoder: rebuilds a rows x cols tile from a (sparse or
+// dense) result stream; indices that were not sent are zero.
+inline IntMatrix scatter_stream(const std::vector<StreamWord>& words, int rows, int cols) {
+    IntMatrix tile(rows, cols);
+    bool ended = false;
+    for (const auto& word : words) {
+        if (ended) {
+            throw std::invalid_argument("scatter_stream: word after end-of-tile marker");
+        }
+        if (word.index < 0 || word.index >= rows * cols) {
+            throw std::out_of_range("scatter_stream: result_index outside the tile");
+        }
+        tile.data[word.index] = word.data;
+        ended = word.last;
+    }
+    if (!ended) {
+        throw std::invalid_argument("scatter_stream: missing end-of-tile marker");
+    }
+    return tile;
+}
+
+// ============================================================================
+// Int4 Weight Packing
+// ============================================================================
+
+// Signed range of one weight in int4 mode (DATA_WIDTH/2 bits)
+inline int int4_min(const CoreConfig& cfg) { return -(1 << (cfg.data_width / 2 - 1)); }
+inline int int4_max(const CoreConfig& cfg) { return (1 << (cfg.data_width / 2 - 1)) - 1; }
+
+// Packs a K x 2n weight matrix into the K x n b_stream lanes used by int4
+// mode: lane col holds column 2*col in the low half and 2*col+1 in the high
+// half. Lanes are returned as signed DATA_WIDTH values, like int8 operands.
+inline IntMatrix pack_int4_weights(const CoreConfig& cfg, const IntMatrix& w) {
+    if (w.cols % 2 != 0) {
+        throw std::invalid_argument("pack_int4_weights: column count must be even");
+    }
+    const int half = cfg.data_width / 2;
+    const uint32_t mask = (1u << half) - 1u;
+    IntMatrix packed(w.rows, w.cols / 2);
+    for (int k = 0; k < w.rows; ++k) {
+        for (int col = 0; col < packed.cols; ++col) {
+            const int32_t lo = w.at(k, 2 * col);
+            const int32_t hi = w.at(k, 2 * col + 1);
+            if (lo < int4_min(cfg) || lo > int4_max(cfg) || hi < int4_min(cfg) || hi > int4_max(cfg)) {
+                throw std::out_of_range("pack_int4_weights: weight outside int4 range");
+            }
+            const uint32_t lane = (static_cast<uint32_t>(lo) & mask) | ((static_cast<uint32_t>(hi) & mask) << half);
+            packed.at(k, col) = wrap_to_width(lane, cfg.data_width);
+        }
+    }
+    return packed;
+}
+
+inline IntMatrix unpack_int4_weights(const CoreConfig& cfg, const IntMatrix& packed) {
+    const int half = cfg.data_width / 2;
+    const uint32_t mask = (1u << half) - 1u;
+    IntMatrix w(packed.rows, packed.cols * 2);
+    for (int k = 0; k < packed.rows; ++k) {
+        for (int col = 0; col < packed.cols; ++col) {
+            const uint32_t lane = static_cast<uint32_t>(packed.at(k, col));
+            w.at(k, 2 * col) = wrap_to_width(lane & mask, half);
+            w.at(k, 2 * col + 1) = wrap_to_width((lane >> half) & mask, half);
+        }
+    }
+    return w;
+}
+
+// ============================================================================
+// Operand Activity
+// ============================================================================
+
+// Switching activity of the operand pipeline registers (stage0 onward, up to
+// the PE inputs), in register bits. With enable gating a register only loads
+// behind a valid beat; clocked_bits_ungated is what the same registers would
+// load if every stage behind stage0 were clocked on each cycle of the job.
+// Reloading a held value flips no bits, so bit_toggles is the same either
+// way: gating saves clock/enable power rather than data switching.
+struct OperandActivity {
+    uint64_t beats = 0;
+    uint64_t clocked_bits = 0;
+    uint64_t clocked_bits_ungated = 0;
+    uint64_t bit_toggles = 0;
+};
+
+// Operand registers behind stage0 on the path of operand lane `lane`.
+// npu_core: stage1. npu_systolic: lane+1 skew slots, then one forwarding
+// register per PE the operand passes through.
+inline int operand_chain_registers(const CoreConfig& cfg, int lane) {
+    if (cfg.variant == CoreVariant::Systolic) {
+        return (lane + 1) + cfg.array_size;
+    }
+    return 1;
+}
+
+inline int bit_count(uint32_t value) {
+    int bits = 0;
+    for (; value != 0; value &= value - 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+// ============================================================================
+// Core Model
+// ============================================================================
+
+// Functional + cycle-count model of a single npu_core / npu_systolic instance.
+// One call to run_tile() is one start/feed/stream job.
+class CoreModel {
+public:
+    explicit CoreModel(const CoreConfig& cfg) : cfg_(cfg) {}
+
+    const CoreConfig& config() const { return cfg_; }
+    uint64_t cycles() const { return cycles_; }
+    uint64_t tiles() const { return tiles_; }
+    uint64_t macs() const { return macs_; }
+    uint64_t output_words() const { return output_words_; }
+    const OperandActivity& activity() const { return activity_; }
+
+    // a_tile is ARRAY_SIZE x K (rows of A, k), b_tile is K x ARRAY_SIZE as fed
+    // on b_stream (packed weight pairs in int4 mode), 1 <= K <= MAX_K.
+    // Returns ARRAY_SIZE x tile_cols(cfg).
+    IntMatrix run_tile(const IntMatrix& a_tile, const IntMatrix& b_tile) {
+        const int n = cfg_.array_size;
+        const int k_len = a_tile.cols;
+        if (a_tile.rows != n || b_tile.cols != n || b_tile.rows != k_len) {
+            throw std::invalid_argument("run_tile: tile shape must match ARRAY_SIZE");
+        }
+        if (k_len < 1 || k_len > cfg_.max_k) {
+            throw std::invalid_argument("run_tile: K must be in 1..MAX_K");
+        }
+        if (cfg_.int4_weights && cfg_.variant != CoreVariant::Broadcast) {
+            throw std::invalid_argument("run_tile: int4 mode is only built into npu_core");
+        }
+        if (cfg_.back_to_back && cfg_.variant != CoreVariant::Broadcast) {
+            throw std::invalid_argument("run_tile: BACK_TO_BACK is only built into npu_core");
+        }
+        const IntMatrix weights = cfg_.int4_weights ? unpack_int4_weights(cfg_, b_tile) : b_tile;
+        const int cols = weights.cols;
+        const int width = acc_width(cfg_);
+        IntMatrix acc(n, cols);
+        for (int k = 0; k < k_len; ++k) {
+            for (int r = 0; r < n; ++r) {
+                for (int c = 0; c < cols; ++c) {
+                    acc.at(r, c) = wrap_to_width(
+                        static_cast<int64_t>(acc.at(r, c)) + a_tile.at(r, k) * weights.at(k, c), width);
+                }
+            }
+        }
+        if (cfg_.relu) {
+            for (auto& value : acc.data) {
+                value = std::max(value, 0);
+            }
+        }
+        const int words = static_cast<int>(stream_tile(acc, cfg_.sparse_stream).size());
+        record_activity(a_tile, b_tile);
+        cycles_ += static_cast<uint64_t>(tile_cycles(cfg_, k_len, words));
+        output_words_ += static_cast<uint64_t>(words);
+        macs_ += static_cast<uint64_t>(n) * cols * k_len;
+        ++tiles_;
+        return acc;
+    }
+
+private:
+    // Every register on a lane's path sees the lane's beat sequence, so each
+    // one toggles as often as stage0. The registers start at reset (zero) and
+    // hold the previous job's last beat between jobs.
+    void record_activity(const IntMatrix& a_tile, const IntMatrix& b_tile) {
+        const int n = cfg_.array_size;
+        const int k_len = a_tile.cols;
+        const uint32_t mask = (cfg_.data_width >= 32) ? ~0u : ((1u << cfg_.data_width) - 1u);
+        const uint64_t window = static_cast<uint64_t>(compute_latency(cfg_, k_len));
+        if (last_beat_.empty()) {
+            last_beat_.assign(2 * n, 0u);
+        }
+        for (int lane = 0; lane < 2 * n; ++lane) {
+            const int chain = operand_chain_registers(cfg_, lane % n);
+            uint64_t toggles = 0;
+            for (int k = 0; k < k_len; ++k) {
+                const int value = (lane < n) ? a_tile.at(lane, k) : b_tile.at(k, lane - n);
+                const uint32_t beat = static_cast<uint32_t>(value) & mask;
+                toggles += static_cast<uint64_t>(bit_count(beat ^ last_beat_[lane]));
+                last_beat_[lane] = beat;
+            }
+            const uint64_t width = static_cast<uint64_t>(cfg_.data_width);
+            activity_.clocked_bits += static_cast<uint64_t>(1 + chain) * k_len * width;
+            activity_.clocked_bits_ungated += (static_cast<uint64_t>(k_len) + chain * window) * width;
+            activity_.bit_toggles += static_cast<uint64_t>(1 + chain) * toggles;
+        }
+        activity_.beats += static_cast<uint64_t>(k_len);
+    }
+
+    CoreConfig cfg_;
+    uint64_t cycles_ = 0;
+    uint64_t tiles_ = 0;
+    uint64_t macs_ = 0;
+    uint64_t output_words_ = 0;
+    OperandActivity activity_;
+    std::vector<uint32_t> last_beat_;
+};
+
+// ============================================================================
+// Cluster Model
+// ============================================================================
+
+// Functional + cycle-count model of rtl/npu_cluster.sv: num_cores lockstep
+// npu_core instances fed by one operand bus (B broadcast, A split by rows).
+// One call to run_job() is one start/feed/stream job. With num_cores = 1 the
+// counts match CoreModel exactly.
+class ClusterModel {
+public:
+    explicit ClusterModel(const CoreConfig& cfg) : cfg_(cfg), core_(cfg) {
+        if (cfg.num_cores < 1) {
+            throw std::invalid_argument("ClusterModel: num_cores must be at least 1");
+        }
+        if (cfg.num_cores > 1 && (cfg.variant != CoreVariant::Broadcast || cfg.int4_weights || cfg.back_to_back)) {
+            throw std::invalid_argument("ClusterModel: npu_cluster is built from int8 npu_core instances");
+        }
+        if (cfg.operand_reuse && (cfg.num_cores > 1 || cfg.variant != CoreVariant::Broadcast ||
+                                  cfg.int4_weights || cfg.back_to_back)) {
+            throw std::invalid_argument("ClusterModel: npu_reuse wraps a single default int8 npu_core");
+        }
+    }
+
+    const CoreConfig& config() const { return cfg_; }
+    uint64_t cycles() const { return cycles_; }
+    uint64_t jobs() const { return jobs_; }
+    uint64_t tiles() const { return core_.tiles(); }
+    uint64_t macs() const { return core_.macs(); }
+    uint64_t output_words() const { return core_.output_words(); }
+    uint64_t operand_beats() const { return operand_beats_; }
+
+    // a_tiles holds one ARRAY_SIZE x K tile per core, b_tile is the shared
+    // K x ARRAY_SIZE panel. Returns one output tile per core.
+    std::vector<IntMatrix> run_job(const std::vector<IntMatrix>& a_tiles, const IntMatrix& b_tile) {
+        if (static_cast<int>(a_tiles.size()) != cfg_.num_cores) {
+            throw std::invalid_argument("run_job: need one A tile per core");
+        }
+        const uint64_t words_before = core_.output_words();
+        std::vector<IntMatrix> results;
+        results.reserve(a_tiles.size());
+        for (const auto& a_tile : a_tiles) {
+            results.push_back(core_.run_tile(a_tile, b_tile));
+        }
+        // The cores compute in lockstep, then every word drains through the
+        // shared result arbiter one handshake per cycle
+        const int words = static_cast<int>(core_.output_words() - words_before);
+        cycles_ += static_cast<uint64_t>(tile_cycles(cfg_, b_tile.rows, words));
+        operand_beats_ += static_cast<uint64_t>(b_tile.rows);
+        ++jobs_;
+        return results;
+    }
+
+private:
+    CoreConfig cfg_;
+    CoreModel core_; // functional model only; its own cycle count is unused
+    uint64_t cycles_ = 0;
+    uint64_t jobs_ = 0;
+    uint64_t operand_beats_ = 0;
+};
+
+// ============================================================================
+// Tiler
+// ============================================================================
+
+// Executes tile jobs outside the model, e.g. in a running RTL simulation
+// (see npu_cosim.hpp). Jobs complete in submission order and up to depth()
+// may be outstanding at once.
+class TileRunner {
+public:
+    virtual ~TileRunner() = default;
+    virtual int depth() const = 0;
+    // One ARRAY_SIZE x K job, as for CoreModel::run_tile()
+    virtual void submit(const IntMatrix& a_tile, const IntMatrix& b_tile) = 0;
+    // Output tile of the oldest outstanding job
+    virtual IntMatrix collect() = 0;
+};
+
+// One product of a grouped run: C = A * B, as for Tiler::run
+struct TileProblem {
+    MatrixView<const int32_t> a;
+    MatrixView<const int32_t> b;
+};
+
+struct TileStats {
+    uint64_t tiles = 0;
+    uint64_t core_cycles = 0;
+    uint64_t macs = 0;
+    uint64_t skipped_beats = 0; // zero k-beats dropped before reaching the core
+    uint64_t output_words = 0;  // result stream handshakes
+    uint64_t operand_beats = 0; // beats fetched on the operand bus
+    uint64_t a_bytes = 0;       // A operand bytes sent to the core front end
+    uint64_t b_bytes = 0;       // B operand bytes sent to the core front end
+};
+
+// Splits C = A * B into ARRAY_SIZE x tile_cols output tiles and MAX_K-deep K
+// chunks. Edge tiles are zero padded; partial sums over K are accumulated on
+// the host, so the activation is applied after the last K chunk rather than in
+// the core. In int4 mode B holds unpacked int4 weights and is packed per tile.
+// With skip_zero_k, each tile row only feeds the k beats whose A column is
+// non-zero (e.g. post-ReLU activations), packed densely into MAX_K chunks.
+// set_skip_zero_b does the same from the B side: each column tile only
+// feeds the beats whose B row is non-zero across the tile, and column tiles
+// with no such beat send nothing. With block-sparse weights in ARRAY_SIZE
+// blocks, only the beats of stored blocks are sent, so jobs, cycles and
+// operand bytes follow the block density.
+// When K fits one job the core applies the activation itself, so a sparse
+// result stream only carries the non-zero outputs.
+// With num_cores > 1 each job covers num_cores vertically stacked tiles that
+// share one B panel, so every fetched beat feeds all cores of the cluster.
+// Each output tile normally walks its K chunks in turn and resends its A
+// columns every job. With operand_reuse the K chunk is the outer loop, so one
+// A panel is loaded into npu_reuse and serves every column tile of that tile
+// row: A traffic drops by the number of column tiles. Panel loads overlap the
+// previous job's drain and are not counted in core_cycles.
+// With a TileRunner the output tiles come from the runner instead of the model,
+// one job per core, kept depth() jobs ahead of collection. The model still
+// runs alongside and provides the stats.
+class Tiler {
+public:
+    explicit Tiler(const CoreConfig& cfg, bool skip_zero_k = false, TileRunner* runner = nullptr)
+        : cfg_(cfg), skip_zero_k_(skip_zero_k), runner_(runner) {}
+
+    // Skip beats and tiles where B is zero, e.g. block-sparse weights
+    void set_skip_zero_b(bool skip) { skip_zero_b_ = skip; }
+
+    IntMatrix run(const IntMatrix& a, const IntMatrix& b, TileStats* stats = nullptr) const {
+        return run(a.view(), b.view(), stats);
+    }
+
+    // op(A) * op(B) on the stored operands: A held as K x M for the NPU's
+    // column feed, B held as N x K, or both
+    IntMatrix run(Transpose ta, MatrixView<const int32_t> a, Transpose tb, MatrixView<const int32_t> b,
+                  TileStats* stats = nullptr) const {
+        return run(transpose_if(a, ta), transpose_if(b, tb), stats);
+    }
+
+    // A and B may be slices or transposed views of larger buffers; tiles are
+    // gathered straight from them, in the order of each view's layout
+    IntMatrix run(MatrixView<const int32_t> a, MatrixView<const int32_t> b, TileStats* stats = nullptr) const {
+        std::vector<IntMatrix> c = run_grouped({{a, b}}, stats);
+        return std::move(c.front());
+    }
+
+    // Runs C_i = A_i * B_i for every problem as one job stream, e.g. the
+    // experts of an MoE layer with their own token counts. A TileRunner is
+    // kept depth() jobs ahead across problem boundaries rather than drained
+    // after each, and stats cover the whole group.
+    std::vector<IntMatrix> run_grouped(const std::vector<TileProblem>& problems, TileStats* stats = nullptr) const {
+        for (const auto& problem : problems) {
+            if (problem.a.cols() != problem.b.rows()) {
+                throw std::invalid_argument("Tiler::run: inner dimensions differ");
+            }
+        }
+        const int n = cfg_.array_size;
+        const int job_rows = n * cfg_.num_cores;
+        // The core applies ReLU only to problems whose K fits one job; the
+        // others get it on the host after the last K chunk. Each kind runs on
+        // its own cluster model and the stats add up both.
+        CoreConfig host_relu_cfg = cfg_;
+        host_relu_cfg.relu = false;
+        ClusterModel core_relu(cfg_);
+        ClusterModel host_relu(host_relu_cfg);
+
+        const int cols = tile_cols(cfg_);
+        uint64_t skipped = 0;
+        uint64_t a_bytes = 0;
+        uint64_t b_bytes = 0;
+        std::vector<IntMatrix> results;
+        for (const auto& problem : problems) {
+            results.emplace_back(problem.a.rows(), problem.b.cols());
+        }
+        std::vector<IntMatrix> a_tiles(cfg_.num_cores);
+        struct Pending {
+            IntMatrix* c;
+            int r0;
+            int c0;
+        };
+        std::deque<Pending> pending; // output of each runner job
+        auto retire = [&]() {
+            add_tile(*pending.front().c, runner_->collect(), pending.front().r0, pending.front().c0);
+            pending.pop_front();
+        };
+        for (std::size_t p = 0; p < problems.size(); ++p) {
+            const MatrixView<const int32_t> a = problems[p].a;
+            const MatrixView<const int32_t> b = problems[p].b;
+            IntMatrix& c = results[p];
+            ClusterModel& cluster = a.cols() <= cfg_.max_k ? core_relu : host_relu;
+            const int col_tiles = (b.cols() + cols - 1) / cols;
+            // Runs the job for column tile jt over beats[k0 .. k0 + k_len). A is
+            // gathered only when load_a is set; reuse order keeps the panel
+            auto run_job = [&](int i0, int jt, const std::vector<int>& beats, int k0, bool load_a) {
+                const int j0 = jt * cols;
+                const int k_len = std::min(cfg_.max_k, static_cast<int>(beats.size()) - k0);
+                if (load_a) {
+                    for (int core = 0; core < cfg_.num_cores; ++core) {
+                        a_tiles[core] = gather_a_tile(a, i0 + core * n, n, &beats[k0], k_len);
+                    }
+                    a_bytes += operand_bytes(k_len, job_rows);
+                }
+                IntMatrix b_tile = gather_b_tile(b, &beats[k0], k_len, j0, cols);
+                if (skip_zero_b_ &&
+                    std::all_of(b_tile.data.begin(), b_tile.data.end(), [](int32_t v) { return v == 0; })) {
+                    skipped += static_cast<uint64_t>(k_len);
+                    return;
+                }
+                if (cfg_.int4_weights) {
+                    b_tile = pack_int4_weights(cfg_, b_tile);
+                }
+                b_bytes += operand_bytes(b_tile.rows, b_tile.cols);
+                const std::vector<IntMatrix> partials = cluster.run_job(a_tiles, b_tile);
+                for (int core = 0; core < cfg_.num_cores; ++core) {
+                    if (!runner_) {
+                        add_tile(c, partials[core], i0 + core * n, j0);
+                        continue;
+                    }
+                    while (static_cast<int>(pending.size()) >= std::max(runner_->depth(), 1)) {
+                        retire();
+                    }
+                    runner_->submit(a_tiles[core], b_tile);
+                    pending.push_back({&c, i0 + core * n, j0});
+                }
+            };
+            for (int i0 = 0; i0 < a.rows(); i0 += job_rows) {
+                // The cores share B beats, so a k beat is skipped only when it is
+                // zero across every row of the job
+                std::vector<int> k_beats(a.cols());
+                for (int k = 0; k < a.cols(); ++k) {
+                    k_beats[k] = k;
+                }
+                if (skip_zero_k_) {
+                    k_beats = nonzero_k_beats(a, i0, job_rows);
+                }
+                const int beats = static_cast<int>(k_beats.size());
+                if (cfg_.operand_reuse) {
+                    // Reuse order keeps one A panel while every column tile runs,
+                    // so the beat list is shared and only all-zero B tiles drop
+                    skipped += static_cast<uint64_t>(a.cols() - beats) * static_cast<uint64_t>(col_tiles);
+                    for (int k0 = 0; k0 < beats; k0 += cfg_.max_k) {
+                        for (int jt = 0; jt < col_tiles; ++jt) {
+                            run_job(i0, jt, k_beats, k0, jt == 0);
+                        }
+                    }
+                    continue;
+                }
+                // Output-stationary order finishes one column tile before the
+                // next. With skip_zero_b each column tile also drops the beats
+                // whose B row is zero across it, and a tile with none left is
+                // not sent at all
+                for (int jt = 0; jt < col_tiles; ++jt) {
+                    const std::vector<int> tile_beats =
+                        skip_zero_b_ ? nonzero_b_beats(b, k_beats, jt * cols, cols) : k_beats;
+                    skipped += static_cast<uint64_t>(a.cols() - static_cast<int>(tile_beats.size()));
+                    for (int k0 = 0; k0 < static_cast<int>(tile_beats.size()); k0 += cfg_.max_k) {
+                        run_job(i0, jt, tile_beats, k0, true);
+                    }
+                }
+            }
+        }
+        while (!pending.empty()) {
+            retire();
+        }
+
+        if (cfg_.relu) {
+            for (auto& c : results) {
+                for (auto& value : c.data) {
+                    value = std::max(value, 0);
+                }
+            }
+        }
+
+        if (stats) {
+            for (const ClusterModel* cluster : {&core_relu, &host_relu}) {
+                stats->tiles += cluster->tiles();
+                stats->core_cycles += cluster->cycles();
+                stats->macs += cluster->macs();
+                stats->output_words += cluster->output_words();
+                stats->operand_beats += cluster->operand_beats();
+            }
+            stats->skipped_beats += skipped;
+            stats->a_bytes += a_bytes;
+            stats->b_bytes += b_bytes;
+        }
+        return results;
+    }
+
+    // Estimated core cycles for a dense M x K x N GEMM without running it
+    uint64_t estimate_cycles(int m, int k, int n_cols) const {
+        const int job_rows = cfg_.array_size * cfg_.num_cores;
+        const int cols = tile_cols(cfg_);
+        const int job_words = cfg_.num_cores * output_count(cfg_);
+        const uint64_t output_jobs = static_cast<uint64_t>((m + job_rows - 1) / job_rows) *
+                                     static_cast<uint64_t>((n_cols + cols - 1) / cols);
+        uint64_t per_output_job = 0;
+        for (int k0 = 0; k0 < k; k0 += cfg_.max_k) {
+            per_output_job += static_cast<uint64_t>(tile_cycles(cfg_, std::min(cfg_.max_k, k - k0), job_words));
+        }
+        return output_jobs * per_output_job;
+    }
+
+private:
+    // Adds an output tile's in-range part to C at (r0, c0)
+    static void add_tile(IntMatrix& c, const IntMatrix& tile, int r0, int c0) {
+        for (int r = 0; r < tile.rows && (r0 + r) < c.rows; ++r) {
+            for (int col = 0; col < tile.cols && (c0 + col) < c.cols; ++col) {
+                c.at(r0 + r, c0 + col) += tile.at(r, col);
+            }
+        }
+    }
+
+    // Bytes for a k_len-beat panel of lanes data_width-bit operands
+    uint64_t operand_bytes(int k_len, int lanes) const {
+        return static_cast<uint64_t>(k_len) * static_cast<uint64_t>(lanes * cfg_.data_width / 8);
+    }
+
+    // rows x k_len tile of A holding the listed k columns
+    static IntMatrix gather_a_tile(MatrixView<const int32_t> a, int r0, int rows, const int* k_idx, int k_len) {
+        IntMatrix tile(rows, k_len);
+        const int valid = std::min(rows, a.rows() - r0);
+        if (a.column_major()) {
+            for (int k = 0; k < k_len; ++k) {
+                for (int r = 0; r < valid; ++r) {
+                    tile.at(r, k) = a.at(r0 + r, k_idx[k]);
+                }
+            }
+            return tile;
+        }
+        for (int r = 0; r < valid; ++r) {
+            for (int k = 0; k < k_len; ++k) {
+                tile.at(r, k) = a.at(r0 + r, k_idx[k]);
+            }
+        }
+        return tile;
+    }
+
+    // The listed k beats whose B row has a non-zero in columns [c0, c0 + cols)
+    static std::vector<int> nonzero_b_beats(MatrixView<const int32_t> b, const std::vector<int>& k_beats, int c0, int cols) {
+        std::vector<int> kept;
+        const int c_end = std::min(b.cols(), c0 + cols);
+        for (int k : k_beats) {
+            for (int c = c0; c < c_end; ++c) {
+                if (b.at(k, c) != 0) {
+                    kept.push_back(k);
+                    break;
+                }
+            }
+        }
+        return kept;
+    }
+
+    // k_len x cols tile of B holding the listed k rows
+    static IntMatrix gather_b_tile(MatrixView<const int32_t> b, const int* k_idx, int k_len, int c0, int cols) {
+        IntMatrix tile(k_len, cols);
+        const int valid = std::min(cols, b.cols() - c0);
+        if (b.column_major()) {
+            for (int c = 0; c < valid; ++c) {
+                for (int k = 0; k < k_len; ++k) {
+                    tile.at(k, c) = b.at(k_idx[k], c0 + c);
+                }
+            }
+            return tile;
+        }
+        for (int k = 0; k < k_len; ++k) {
+            for (int c = 0; c < valid; ++c) {
+                tile.at(k, c) = b.at(k_idx[k], c0 + c);
+            }
+        }
+        return tile;
+    }
+
+    CoreConfig cfg_;
+    bool skip_zero_k_ = false;
+    bool skip_zero_b_ = false;
+    TileRunner* runner_ = nullptr;
+};
+
+} // namespace npu
@@ -0,0 +1,739 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "npu_cosim.hpp"
+#include "npu_driver.hpp"
+#include "npu_model.hpp"
+#include "npu_vcd.hpp"
+
+namespace {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+};
+
+npu::IntMatrix random_int8_matrix(int rows, int cols, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(-128, 127);
+    npu::IntMatrix m(rows, cols);
+    for (auto& value : m.data) {
+        value = dist(rng);
+    }
+    return m;
+}
+
+npu::IntMatrix random_int4_matrix(int rows, int cols, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(-8, 7);
+    npu::IntMatrix m(rows, cols);
+    for (auto& value : m.data) {
+        value = dist(rng);
+    }
+    return m;
+}
+
+// Hidden activations of a quantized int8 layer: requant(ReLU(X * W + bias))
+npu::IntMatrix post_relu_activations(int rows, int in_features, int out_features, std::mt19937& rng) {
+    const npu::IntMatrix x = random_int8_matrix(rows, in_features, rng);
+    const npu::IntMatrix w = random_int8_matrix(in_features, out_features, rng);
+    std::uniform_int_distribution<int> bias_dist(-100000, 20000);
+    std::vector<int> bias(out_features);
+    for (auto& value : bias) {
+        value = bias_dist(rng);
+    }
+    npu::IntMatrix h = npu::gemm_reference(x, w);
+    for (int r = 0; r < h.rows; ++r) {
+        for (int c = 0; c < h.cols; ++c) {
+            h.at(r, c) = std::min(127, std::max(0, h.at(r, c) + bias[c]) >> 10);
+        }
+    }
+    return h;
+}
+
+bool matrices_equal(const npu::IntMatrix& x, const npu::IntMatrix& y) {
+    return x.rows == y.rows && x.cols == y.cols && x.data == y.data;
+}
+
+// ============================================================================
+// Test Cases
+// ============================================================================
+
+TestResult test_single_tile_matches_reference() {
+    std::mt19937 rng(1);
+    npu::CoreConfig cfg;
+    npu::CoreModel core(cfg);
+
+    const npu::IntMatrix a = random_int8_matrix(cfg.array_size, cfg.array_size, rng);
+    const npu::IntMatrix b = random_int8_matrix(cfg.array_size, cfg.array_size, rng);
+    if (!matrices_equal(core.run_tile(a, b), npu::gemm_reference(a, b))) {
+        return {"single_tile_matches_reference", false, "Core tile differs from reference GEMM"};
+    }
+    return {"single_tile_matches_reference", true, ""};
+}
+
+TestResult test_systolic_latency() {
+    npu::CoreConfig broadcast;
+    npu::CoreConfig systolic;
+    systolic.variant = npu::CoreVariant::Systolic;
+
+    // Start-to-start period of npu_core with result_ready held high: K + 21
+    if (npu::tile_cycles(broadcast) != 25) {
+        return {"systolic_latency", false,
+                "Broadcast tile period " + std::to_string(npu::tile_cycles(broadcast)) + ", expected 25"};
+    }
+
+    const int skew = npu::compute_latency(systolic) - npu::compute_latency(broadcast);
+    if (skew != 2 * (systolic.array_size - 1)) {
+        return {"systolic_latency", false,
+                "Systolic skew latency " + std::to_string(skew) + ", expected " +
+                std::to_string(2 * (systolic.array_size - 1))};
+    }
+
+    // PE_PIPELINE delays done by one cycle on either variant
+    for (auto cfg : {broadcast, systolic}) {
+        npu::CoreConfig pipelined = cfg;
+        pipelined.pe_pipeline = 1;
+        if (npu::tile_cycles(pipelined) != npu::tile_cycles(cfg) + 1) {
+            return {"systolic_latency", false, "PE_PIPELINE should add exactly one cycle per tile"};
+        }
+    }
+    return {"systolic_latency", true, ""};
+}
+
+TestResult test_tiler_ragged_shapes() {
+    std::mt19937 rng(7);
+    for (auto variant : {npu::CoreVariant::Broadcast, npu::CoreVariant::Systolic}) {
+        npu::CoreConfig cfg;
+        cfg.variant = variant;
+        npu::Tiler tiler(cfg);
+
+        const npu::IntMatrix a = random_int8_matrix(13, 10, rng);
+        const npu::IntMatrix b = random_int8_matrix(10, 7, rng);
+        npu::TileStats stats;
+        const npu::IntMatrix c = tiler.run(a, b, &stats);
+        if (!matrices_equal(c, npu::gemm_reference(a, b))) {
+            return {"tiler_ragged_shapes", false, "Tiled GEMM differs from reference"};
+        }
+        if (stats.core_cycles != tiler.estimate_cycles(13, 10, 7)) {
+            return {"tiler_ragged_shapes", false, "Cycle estimate disagrees with simulated tiles"};
+        }
+    }
+    return {"tiler_ragged_shapes", true, ""};
+}
+
+TestResult test_tiler_relu_after_k() {
+    // A partial K chunk can be negative while the full sum is positive,
+    // so ReLU must only be applied once all chunks are accumulated.
+    npu::CoreConfig cfg;
+    cfg.relu = true;
+    npu::Tiler tiler(cfg);
+
+    npu::IntMatrix a(1, 8);
+    npu::IntMatrix b(8, 1);
+    for (int k = 0; k < 8; ++k) {
+        a.at(0, k) = 1;
+        b.at(k, 0) = (k < 4) ? -1 : 3;
+    }
+    const npu::IntMatrix c = tiler.run(a, b);
+    if (c.at(0, 0) != 8) {
+        return {"tiler_relu_after_k", false, "Expected 8, got " + std::to_string(c.at(0, 0))};
+    }
+    return {"tiler_relu_after_k", true, ""};
+}
+
+TestResult test_descriptor_chain() {
+    // 1024 output tiles pushed through a 16-entry ring with no per-tile host work
+    std::mt19937 rng(11);
+    npu::CoreConfig cfg;
+    cfg.max_k = 64;
+    constexpr int kRingEntries = 16;
+
+    npu::LocalMemory mem(1 << 16);
+    const uint32_t ring_base = mem.allocate(kRingEntries * npu::kDescriptorWords);
+
+    const npu::IntMatrix a = random_int8_matrix(128, 48, rng);
+    const npu::IntMatrix b = random_int8_matrix(48, 128, rng);
+    const npu::GemmChain chain = npu::build_gemm_chain(cfg, mem, a, b, true);
+
+    npu::CommandProcessorModel cp(cfg, mem, ring_base, kRingEntries);
+    const uint64_t doorbells = npu::submit_chain(cp, mem, ring_base, kRingEntries, chain.descriptors);
+
+    npu::IntMatrix expected = npu::gemm_reference(a, b);
+    for (auto& value : expected.data) {
+        value = std::max(value, 0);
+    }
+    if (!matrices_equal(npu::collect_gemm_chain(cfg, mem, chain), expected)) {
+        return {"descriptor_chain", false, "Chain results differ from reference GEMM + ReLU"};
+    }
+    if (cp.stats().descriptors != chain.descriptors.size() || cp.stats().irqs != 1) {
+        return {"descriptor_chain", false, "Unexpected descriptor/irq count"};
+    }
+    const uint64_t expected_doorbells = (chain.descriptors.size() + kRingEntries - 2) / (kRingEntries - 1);
+    if (doorbells != expected_doorbells) {
+        return {"descriptor_chain", false, "Expected " + std::to_string(expected_doorbells) +
+                                           " doorbells, got " + std::to_string(doorbells)};
+    }
+    for (int slot = 0; slot < kRingEntries; ++slot) {
+        if (mem.read(ring_base + slot * npu::kDescriptorWords + 3) & npu::kCtrlValidBit) {
+            return {"descriptor_chain", false, "Completed descriptor still marked valid"};
+        }
+    }
+    if (cp.stats().cycles != chain.descriptors.size() * static_cast<uint64_t>(cp.descriptor_cycles(48))) {
+        return {"descriptor_chain", false, "Cycle count disagrees with per-descriptor timing"};
+    }
+    return {"descriptor_chain", true, ""};
+}
+
+TestResult test_int4_pairs() {
+    std::mt19937 rng(13);
+    npu::CoreConfig int8_cfg;
+    int8_cfg.max_k = 64;
+    npu::CoreConfig int4_cfg = int8_cfg;
+    int4_cfg.int4_weights = true;
+
+    const npu::IntMatrix w = random_int4_matrix(6, 8, rng);
+    if (!matrices_equal(npu::unpack_int4_weights(int4_cfg, npu::pack_int4_weights(int4_cfg, w)), w)) {
+        return {"int4_pairs", false, "Pack/unpack round trip lost weights"};
+    }
+
+    // Same int4 weights through both modes: identical results, and the
+    // int4 run covers twice the output columns per tile
+    const npu::IntMatrix a = random_int8_matrix(13, 70, rng);
+    const npu::IntMatrix b = random_int4_matrix(70, 19, rng);
+    npu::TileStats int8_stats;
+    npu::TileStats int4_stats;
+    const npu::IntMatrix c8 = npu::Tiler(int8_cfg).run(a, b, &int8_stats);
+    const npu::IntMatrix c4 = npu::Tiler(int4_cfg).run(a, b, &int4_stats);
+    const npu::IntMatrix expected = npu::gemm_reference(a, b);
+    if (!matrices_equal(c8, expected) || !matrices_equal(c4, expected)) {
+        return {"int4_pairs", false, "Tiled GEMM differs from reference"};
+    }
+    if (int4_stats.core_cycles != npu::Tiler(int4_cfg).estimate_cycles(13, 70, 19)) {
+        return {"int4_pairs", false, "Cycle estimate disagrees with simulated tiles"};
+    }
+
+    // Long K: compute dominates the doubled result stream
+    const uint64_t int8_cycles = npu::Tiler(int8_cfg).estimate_cycles(64, 4096, 64);
+    const uint64_t int4_cycles = npu::Tiler(int4_cfg).estimate_cycles(64, 4096, 64);
+    const double speedup = static_cast<double>(int8_cycles) / static_cast<double>(int4_cycles);
+    std::cout << "int4 weight pairs: " << int8_cycles << " -> " << int4_cycles
+              << " cycles for 64x4096x64 (" << speedup << "x)\n";
+    if (speedup < 1.6) {
+        return {"int4_pairs", false, "Expected at least 1.6x from int4 mode, got " + std::to_string(speedup)};
+    }
+    return {"int4_pairs", true, ""};
+}
+
+TestResult test_zero_k_skip() {
+    std::mt19937 rng(17);
+    npu::CoreConfig cfg;
+    cfg.max_k = 64;
+
+    const npu::IntMatrix a = post_relu_activations(64, 96, 64, rng);
+    const npu::IntMatrix b = random_int8_matrix(64, 64, rng);
+    const npu::IntMatrix expected = npu::gemm_reference(a, b);
+    const int zeros = static_cast<int>(std::count(a.data.begin(), a.data.end(), 0));
+
+    // Tiler path
+    npu::TileStats dense_stats;
+    npu::TileStats sparse_stats;
+    const npu::IntMatrix dense = npu::Tiler(cfg).run(a, b, &dense_stats);
+    const npu::IntMatrix sparse = npu::Tiler(cfg, true).run(a, b, &sparse_stats);
+    if (!matrices_equal(dense, expected) || !matrices_equal(sparse, expected)) {
+        return {"zero_k_skip", false, "Tiled GEMM differs from reference"};
+    }
+    if (sparse_stats.skipped_beats == 0 || sparse_stats.core_cycles >= dense_stats.core_cycles) {
+        return {"zero_k_skip", false, "No k beats skipped on post-ReLU activations"};
+    }
+
+    // Descriptor path: compressed A panels + k-index maps through the ring
+    uint64_t chain_cycles[2] = {0, 0};
+    for (int skip = 0; skip < 2; ++skip) {
+        constexpr int kRingEntries = 16;
+        npu::LocalMemory mem(1 << 16);
+        const uint32_t ring_base = mem.allocate(kRingEntries * npu::kDescriptorWords);
+        const npu::GemmChain chain = npu::build_gemm_chain(cfg, mem, a, b, false, skip != 0);
+        npu::CommandProcessorModel cp(cfg, mem, ring_base, kRingEntries);
+        npu::submit_chain(cp, mem, ring_base, kRingEntries, chain.descriptors);
+        if (!matrices_equal(npu::collect_gemm_chain(cfg, mem, chain), expected)) {
+            return {"zero_k_skip", false, "Descriptor chain differs from reference GEMM"};
+        }
+        chain_cycles[skip] = cp.stats().cycles;
+    }
+
+    std::cout << "zero k-beat skip on post-ReLU activations (" << (100 * zeros / static_cast<int>(a.data.size()))
+              << "% zeros): tiler " << dense_stats.core_cycles << " -> " << sparse_stats.core_cycles
+              << " cycles (" << static_cast<double>(dense_stats.core_cycles) / sparse_stats.core_cycles
+              << "x), descriptors " << chain_cycles[0] << " -> " << chain_cycles[1] << " cycles ("
+              << static_cast<double>(chain_cycles[0]) / chain_cycles[1] << "x)\n";
+    if (chain_cycles[1] >= chain_cycles[0]) {
+        return {"zero_k_skip", false, "Sparse descriptors were not faster"};
+    }
+    return {"zero_k_skip", true, ""};
+}
+
+TestResult test_sparse_stream() {
+    // Scatter decoder round trip, including a zero final element as the marker
+    npu::IntMatrix tile(4, 4);
+    tile.at(0, 1) = 5;
+    tile.at(2, 3) = -7;
+    const std::vector<npu::StreamWord> words = npu::stream_tile(tile, true);
+    if (words.size() != 3 || !words.back().last || words.back().index != 15) {
+        return {"sparse_stream", false, "Unexpected sparse word sequence"};
+    }
+    if (!matrices_equal(npu::scatter_stream(words, 4, 4), tile)) {
+        return {"sparse_stream", false, "Scatter decoder did not rebuild the tile"};
+    }
+
+    // Second layer of a quantized MLP with ReLU in the core
+    std::mt19937 rng(19);
+    npu::CoreConfig dense_cfg;
+    dense_cfg.max_k = 64;
+    dense_cfg.relu = true;
+    npu::CoreConfig sparse_cfg = dense_cfg;
+    sparse_cfg.sparse_stream = true;
+
+    const npu::IntMatrix a = post_relu_activations(64, 96, 64, rng);
+    const npu::IntMatrix b = random_int8_matrix(64, 64, rng);
+    npu::IntMatrix expected = npu::gemm_reference(a, b);
+    for (auto& value : expected.data) {
+        value = std::max(value, 0);
+    }
+
+    npu::TileStats dense_stats;
+    npu::TileStats sparse_stats;
+    const npu::IntMatrix dense = npu::Tiler(dense_cfg).run(a, b, &dense_stats);
+    const npu::IntMatrix sparse = npu::Tiler(sparse_cfg).run(a, b, &sparse_stats);
+    if (!matrices_equal(dense, expected) || !matrices_equal(sparse, expected)) {
+        return {"sparse_stream", false, "Tiled GEMM + ReLU differs from reference"};
+    }
+    if (dense_stats.output_words != dense_stats.tiles * npu::output_count(dense_cfg) ||
+        sparse_stats.output_words >= dense_stats.output_words) {
+        return {"sparse_stream", false, "Sparse stream did not save output words"};
+    }
+    const uint64_t saved = dense_stats.core_cycles - sparse_stats.core_cycles;
+    if (saved != dense_stats.output_words - sparse_stats.output_words) {
+        return {"sparse_stream", false, "Each skipped word should save one cycle"};
+    }
+
+    std::cout << "sparse result stream after ReLU: " << dense_stats.output_words << " -> "
+              << sparse_stats.output_words << " output words, " << dense_stats.core_cycles << " -> "
+              << sparse_stats.core_cycles << " cycles ("
+              << static_cast<double>(dense_stats.core_cycles) / sparse_stats.core_cycles << "x)\n";
+    return {"sparse_stream", true, ""};
+}
+
+TestResult test_cluster_split() {
+    std::mt19937 rng(23);
+    npu::CoreConfig single;
+    single.max_k = 64;
+    npu::CoreConfig cluster = single;
+    cluster.num_cores = 4;
+
+    // Ragged shape: the last job has idle cores and a partial core tile
+    const npu::IntMatrix a_ragged = random_int8_matrix(22, 70, rng);
+    const npu::IntMatrix b_ragged = random_int8_matrix(70, 9, rng);
+    npu::TileStats ragged_stats;
+    npu::Tiler ragged_tiler(cluster);
+    if (!matrices_equal(ragged_tiler.run(a_ragged, b_ragged, &ragged_stats), npu::gemm_reference(a_ragged, b_ragged))) {
+        return {"cluster_split", false, "Cluster GEMM differs from reference"};
+    }
+    if (ragged_stats.core_cycles != ragged_tiler.estimate_cycles(22, 70, 9)) {
+        return {"cluster_split", false, "Cluster cycle estimate disagrees with simulated jobs"};
+    }
+
+    // One B fetch feeds all four cores
+    const npu::IntMatrix a = random_int8_matrix(64, 64, rng);
+    const npu::IntMatrix b = random_int8_matrix(64, 64, rng);
+    npu::TileStats single_stats;
+    npu::TileStats cluster_stats;
+    const npu::IntMatrix expected = npu::gemm_reference(a, b);
+    if (!matrices_equal(npu::Tiler(single).run(a, b, &single_stats), expected) ||
+        !matrices_equal(npu::Tiler(cluster).run(a, b, &cluster_stats), expected)) {
+        return {"cluster_split", false, "Cluster GEMM differs from reference"};
+    }
+    if (cluster_stats.tiles != single_stats.tiles ||
+        cluster_stats.operand_beats * cluster.num_cores != single_stats.operand_beats) {
+        return {"cluster_split", false, "Operand beats should drop by the core count"};
+    }
+    if (cluster_stats.core_cycles >= single_stats.core_cycles) {
+        return {"cluster_split", false, "Cluster was not faster than one core"};
+    }
+
+    std::cout << "4-core cluster on 64x64x64: operand beats " << single_stats.operand_beats << " -> "
+              << cluster_stats.operand_beats << ", cycles " << single_stats.core_cycles << " -> "
+              << cluster_stats.core_cycles << " ("
+              << static_cast<double>(single_stats.core_cycles) / cluster_stats.core_cycles << "x)\n";
+    return {"cluster_split", true, ""};
+}
+
+TestResult test_back_to_back() {
+    npu::CoreConfig cfg;
+    npu::CoreConfig b2b = cfg;
+    b2b.back_to_back = true;
+
+    // 4x4 tiles: streaming 16 words dominates, 25 -> 19 cycles per tile
+    if (npu::tile_cycles(b2b) != 19 || npu::compute_latency(b2b) != npu::compute_latency(cfg) - 1) {
+        return {"back_to_back", false,
+                "BACK_TO_BACK tile period " + std::to_string(npu::tile_cycles(b2b)) + ", expected 19"};
+    }
+    // Long K: compute dominates and streaming is hidden entirely
+    b2b.max_k = 64;
+    if (npu::tile_cycles(b2b, 64) != npu::compute_latency(b2b, 64)) {
+        return {"back_to_back", false, "Long-K tiles should be compute bound"};
+    }
+    b2b.max_k = cfg.max_k;
+
+    std::mt19937 rng(29);
+    const npu::IntMatrix a = random_int8_matrix(64, 4, rng);
+    const npu::IntMatrix b = random_int8_matrix(4, 64, rng);
+    npu::TileStats base_stats;
+    npu::TileStats b2b_stats;
+    const npu::IntMatrix expected = npu::gemm_reference(a, b);
+    if (!matrices_equal(npu::Tiler(cfg).run(a, b, &base_stats), expected) ||
+        !matrices_equal(npu::Tiler(b2b).run(a, b, &b2b_stats), expected)) {
+        return {"back_to_back", false, "Tiled GEMM differs from reference"};
+    }
+    if (b2b_stats.core_cycles * 25 != base_stats.core_cycles * 19) {
+        return {"back_to_back", false, "Tiler cycles do not follow the per-tile period"};
+    }
+
+    std::cout << "back-to-back jobs on 64x4x64 (K=4 tiles): " << base_stats.core_cycles << " -> "
+              << b2b_stats.core_cycles << " cycles ("
+              << static_cast<double>(base_stats.core_cycles) / b2b_stats.core_cycles << "x)\n";
+    return {"back_to_back", true, ""};
+}
+
+TestResult test_operand_reuse() {
+    std::mt19937 rng(31);
+    npu::CoreConfig cfg;
+    cfg.max_k = 64;
+    npu::CoreConfig reuse = cfg;
+    reuse.operand_reuse = true;
+
+    // K spans several chunks, so the reuse order also reorders the K walk
+    const npu::IntMatrix a_ragged = random_int8_matrix(10, 150, rng);
+    const npu::IntMatrix b_ragged = random_int8_matrix(150, 13, rng);
+    if (!matrices_equal(npu::Tiler(reuse).run(a_ragged, b_ragged), npu::gemm_reference(a_ragged, b_ragged))) {
+        return {"operand_reuse", false, "Reuse-ordered GEMM differs from reference"};
+    }
+
+    // 64 column tiles share each resident A panel
+    const npu::IntMatrix a = random_int8_matrix(64, 64, rng);
+    const npu::IntMatrix b = random_int8_matrix(64, 256, rng);
+    npu::TileStats base_stats;
+    npu::TileStats reuse_stats;
+    const npu::IntMatrix expected = npu::gemm_reference(a, b);
+    if (!matrices_equal(npu::Tiler(cfg).run(a, b, &base_stats), expected) ||
+        !matrices_equal(npu::Tiler(reuse).run(a, b, &reuse_stats), expected)) {
+        return {"operand_reuse", false, "Reuse-ordered GEMM differs from reference"};
+    }
+    const uint64_t col_tiles = 256 / cfg.array_size;
+    if (reuse_stats.a_bytes * col_tiles != base_stats.a_bytes || reuse_stats.b_bytes != base_stats.b_bytes) {
+        return {"operand_reuse", false, "A traffic should drop by the number of column tiles"};
+    }
+    if (reuse_stats.core_cycles != base_stats.core_cycles || reuse_stats.macs != base_stats.macs) {
+        return {"operand_reuse", false, "Reuse ordering should not change the jobs run"};
+    }
+
+    const double base_per_mac = static_cast<double>(base_stats.a_bytes + base_stats.b_bytes) / base_stats.macs;
+    const double reuse_per_mac = static_cast<double>(reuse_stats.a_bytes + reuse_stats.b_bytes) / reuse_stats.macs;
+    std::cout << "operand reuse on 64x64x256: A bytes " << base_stats.a_bytes << " -> " << reuse_stats.a_bytes
+              << ", input bytes/MAC " << base_per_mac << " -> " << reuse_per_mac << " ("
+              << base_per_mac / reuse_per_mac << "x)\n";
+    return {"operand_reuse", true, ""};
+}
+
+TestResult test_operand_gating() {
+    std::mt19937 rng(37);
+    for (const npu::CoreVariant variant : {npu::CoreVariant::Broadcast, npu::CoreVariant::Systolic}) {
+        npu::CoreConfig cfg;
+        cfg.variant = variant;
+        npu::CoreModel core(cfg);
+        for (int tile = 0; tile < 64; ++tile) {
+            core.run_tile(random_int8_matrix(cfg.array_size, cfg.array_size, rng),
+                          random_int8_matrix(cfg.array_size, cfg.array_size, rng));
+        }
+        const npu::OperandActivity& activity = core.activity();
+        const bool systolic = variant == npu::CoreVariant::Systolic;
+        const char* name = systolic ? "npu_systolic" : "npu_core";
+        if (activity.clocked_bits >= activity.clocked_bits_ungated || activity.bit_toggles > activity.clocked_bits) {
+            return {"operand_gating", false, std::string(name) + " activity counts are inconsistent"};
+        }
+        // npu_core K=4: stage0 + stage1 load 4 times each per job instead of
+        // 4 + 7 (one per active cycle)
+        if (!systolic && activity.clocked_bits * 11 != activity.clocked_bits_ungated * 8) {
+            return {"operand_gating", false, "npu_core stage1 should load once per beat"};
+        }
+        std::cout << name << " operand registers over 64 K=4 tiles: clocked bits " << activity.clocked_bits_ungated
+                  << " -> " << activity.clocked_bits << " ("
+                  << 100.0 * (activity.clocked_bits_ungated - activity.clocked_bits) / activity.clocked_bits_ungated
+                  << "% fewer), bit toggles " << activity.bit_toggles << "\n";
+    }
+    return {"operand_gating", true, ""};
+}
+
+TestResult test_vcd_trace_diff() {
+    std::mt19937 rng(41);
+    npu::CoreConfig cfg;
+    std::vector<npu::IntMatrix> a_tiles;
+    std::vector<npu::IntMatrix> b_tiles;
+    for (int tile = 0; tile < 3; ++tile) {
+        a_tiles.push_back(random_int8_matrix(cfg.array_size, cfg.array_size, rng));
+        b_tiles.push_back(random_int8_matrix(cfg.array_size, cfg.array_size, rng));
+    }
+    npu::IntMatrix corrupted = a_tiles[2];
+    corrupted.at(1, 2) += 1;
+
+    // Trace b starts two cycles later and corrupts one A element of tile 2
+    npu::IntMatrix tile2_good;
+    npu::IntMatrix tile2_bad;
+    {
+        npu::VcdWriter vcd_a("npu_trace_a.vcd", 256);
+        npu::VcdWriter vcd_b("npu_trace_b.vcd", 256);
+        npu::CoreTracer trace_a(cfg, vcd_a);
+        npu::CoreTracer trace_b(cfg, vcd_b, "npu_core_tb.dut");
+        trace_a.idle(3);
+        trace_b.idle(5);
+        for (int tile = 0; tile < 3; ++tile) {
+            tile2_good = trace_a.run_tile(a_tiles[tile], b_tiles[tile]);
+            tile2_bad = trace_b.run_tile(tile == 2 ? corrupted : a_tiles[tile], b_tiles[tile]);
+        }
+        trace_a.idle(2);
+        trace_b.idle(2);
+    }
+
+    int first_bad = 0;
+    while (tile2_good.data[first_bad] == tile2_bad.data[first_bad]) {
+        ++first_bad;
+    }
+    const npu::VcdDiff diff = npu::diff_vcd("npu_trace_a.vcd", "npu_core", "npu_trace_b.vcd", "npu_core_tb.dut");
+    // Word i of a tile is on result_data compute_latency + 2 + i cycles after its start
+    const uint64_t expected = 2 * npu::tile_cycles(cfg) + npu::compute_latency(cfg) + 2 + first_bad;
+    if (diff.match || diff.signal != "result_data" || diff.cycle != expected ||
+        diff.time_a != (3 + expected + 1) * 10) {
+        return {"vcd_trace_diff", false,
+                "Expected result_data to diverge at cycle " + std::to_string(expected) + ", got " + diff.signal +
+                " at cycle " + std::to_string(diff.cycle)};
+    }
+    npu::VcdDiffOptions control_only;
+    control_only.signals = {"active", "valid_stage0", "valid_stage1", "done", "busy", "result_valid", "result_last"};
+    const npu::VcdDiff control = npu::diff_vcd("npu_trace_a.vcd", "npu_core", "npu_trace_b.vcd", "npu_core_tb.dut",
+                                               control_only);
+    if (!control.match || control.cycles != 3 * static_cast<uint64_t>(npu::tile_cycles(cfg)) + 1) {
+        return {"vcd_trace_diff", false, "Control signals should match over every aligned cycle"};
+    }
+
+    // Simulator-style dump: nested scopes, bit ranges, $dumpvars, x values,
+    // zero-padded vectors and register updates in the clock edge's timestamp
+    {
+        std::ofstream rtl("npu_trace_rtl.vcd");
+        rtl << "$date today $end\n$timescale 1ps $end\n$scope module tb $end\n$var reg 1 ! clk $end\n"
+               "$scope module dut $end\n$var wire 1 \" clk $end\n$var wire 1 # start $end\n"
+               "$var reg 4 $ result_index [3:0] $end\n$var reg 1 % done $end\n$upscope $end\n$upscope $end\n"
+               "$enddefinitions $end\n#0\n$dumpvars\n0!\n0\"\n0#\nbx $\nx%\n$end\n"
+               "#5000\n1!\n1\"\nb0000 $\n0%\n#10000\n0!\n0\"\n1#\n#15000\n1!\n1\"\n#20000\n0!\n0\"\n0#\n"
+               "#25000\n1!\n1\"\nb0011 $\n1%\n#30000\n0!\n0\"\n#35000\n1!\n1\"\n0%\n";
+    }
+    {
+        npu::VcdWriter model("npu_trace_model.vcd");
+        const int clk = model.add_signal("clk", 1);
+        const int start = model.add_signal("start", 1);
+        const int index = model.add_signal("result_index", 4);
+        const int done = model.add_signal("done", 1);
+        model.begin("npu_core");
+        const int starts[] = {1, 0, 0, 0};
+        const int indices[] = {0, 0, 3, 3};
+        const int dones[] = {0, 0, 1, 0};
+        for (int c = 0; c < 4; ++c) {
+            model.timestamp(c * 10);
+            model.change(clk, 1);
+            model.change(start, starts[c]);
+            model.change(index, indices[c]);
+            model.change(done, dones[c]);
+            model.timestamp(c * 10 + 5);
+            model.change(clk, 0);
+        }
+    }
+    const npu::VcdDiff mixed = npu::diff_vcd("npu_trace_rtl.vcd", "tb.dut", "npu_trace_model.vcd", "npu_core");
+    std::remove("npu_trace_a.vcd");
+    std::remove("npu_trace_b.vcd");
+    std::remove("npu_trace_rtl.vcd");
+    std::remove("npu_trace_model.vcd");
+    if (!mixed.match || mixed.cycles != 3 || mixed.compared.size() != 3) {
+        return {"vcd_trace_diff", false, "Simulator-style dump should match the model over 3 cycles"};
+    }
+
+    std::cout << "VCD diff: first divergence at cycle " << diff.cycle << " (" << diff.signal << " "
+              << diff.value_a << " vs " << diff.value_b << "), control signals match for " << control.cycles
+              << " cycles\n";
+    return {"vcd_trace_diff", true, ""};
+}
+
+TestResult test_config_package() {
+    // The model defaults and the RTL package come from the same description
+    const npu::CoreConfig cfg;
+    if (npu::acc_width(cfg) != npu::kNpuParams.acc_width() || cfg.array_size != npu::kNpuParams.array_size ||
+        cfg.max_k != npu::kNpuParams.max_k) {
+        return {"config_package", false, "CoreConfig defaults differ from kNpuParams"};
+    }
+    // Located from this source file, so the test runs from any directory
+    // when built from an absolute path; the working directory is the fallback
+    const std::string source = __FILE__;
+    const std::size_t slash = source.find_last_of("/\\");
+    const std::string sw_dir = slash == std::string::npos ? "." : source.substr(0, slash);
+    std::ifstream pkg;
+    for (const std::string& path :
+         {sw_dir + "/../rtl/npu_config_pkg.sv", std::string("rtl/npu_config_pkg.sv"), std::string("../rtl/npu_config_pkg.sv")}) {
+        pkg.open(path);
+        if (pkg) {
+            break;
+        }
+        pkg.clear();
+    }
+    if (!pkg) {
+        return {"config_package", false, "rtl/npu_config_pkg.sv not found next to " + source};
+    }
+    const std::string text((std::istreambuf_iterator<char>(pkg)), std::istreambuf_iterator<char>());
+    if (text != npu::sv_config_package(npu::kNpuParams)) {
+        return {"config_package", false, "rtl/npu_config_pkg.sv is stale; rerun gen_config_pkg"};
+    }
+    return {"config_package", true, ""};
+}
+
+TestResult test_cosim_channel() {
+    // A thread plays tb/npu_cosim_tb.sv: it takes jobs beat by beat from the
+    // shared rings, runs them on a CoreModel and streams the words back
+    std::mt19937 rng(23);
+    npu::CoreConfig cfg;
+    cfg.sparse_stream = true;
+    cfg.relu = true;
+    const std::string name = "npu_cosim_test_" + std::to_string(rng());
+
+    std::string device_error;
+    std::thread device([&]() {
+        try {
+            npu::CoreConfig rtl_cfg = cfg;
+            rtl_cfg.relu = false; // npu_cosim_tb builds npu_core with ACT_FUNC = 0
+            npu::CosimParams params;
+            params.array_size = cfg.array_size;
+            params.data_width = cfg.data_width;
+            params.max_k = cfg.max_k;
+            params.acc_width = npu::acc_width(cfg);
+            params.sparse_stream = 1;
+            npu::CosimDevice channel(name, params, 10.0);
+            npu::CoreModel core(rtl_cfg);
+            std::vector<int32_t> a_lanes;
+            std::vector<int32_t> b_lanes;
+            for (int k_len; (k_len = channel.poll_job()) >= 0;) {
+                if (k_len == 0) {
+                    continue;
+                }
+                npu::IntMatrix a_tile(cfg.array_size, k_len);
+                npu::IntMatrix b_tile(k_len, cfg.array_size);
+                for (int k = 0; k < k_len; ++k) {
+                    channel.next_beat(a_lanes, b_lanes);
+                    for (int lane = 0; lane < cfg.array_size; ++lane) {
+                        a_tile.at(lane, k) = a_lanes[lane];
+                        b_tile.at(k, lane) = b_lanes[lane];
+                    }
+                }
+                for (const auto& word : npu::stream_tile(core.run_tile(a_tile, b_tile), true)) {
+                    channel.put_result(word.index, static_cast<uint32_t>(word.data), word.last);
+                }
+            }
+        } catch (const std::exception& error) {
+            device_error = error.what();
+        }
+    });
+
+    std::string error;
+    try {
+        npu::CosimHost host(cfg, name, 3, 10.0);
+        const npu::IntMatrix a = random_int8_matrix(11, 13, rng);
+        const npu::IntMatrix b = random_int8_matrix(13, 9, rng);
+        npu::TileStats model_stats;
+        npu::TileStats cosim_stats;
+        const npu::IntMatrix expected = npu::Tiler(cfg).run(a, b, &model_stats);
+        const npu::IntMatrix c = npu::Tiler(cfg, false, &host).run(a, b, &cosim_stats);
+        host.close();
+        if (!matrices_equal(c, expected)) {
+            error = "co-simulated GEMM differs from the model";
+        } else if (host.jobs() != model_stats.tiles || cosim_stats.core_cycles != model_stats.core_cycles) {
+            error = "job count or cycle stats differ";
+        }
+    } catch (const std::exception& exception) {
+        error = exception.what();
+    }
+    device.join();
+    if (error.empty() && !device_error.empty()) {
+        error = "device: " + device_error;
+    }
+    if (!error.empty()) {
+        return {"cosim_channel", false, error};
+    }
+    return {"cosim_channel", true, ""};
+}
+
+} // namespace
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "  NPU Model / Tiler Testbench\n";
+    std::cout << "========================================\n\n";
+
+    std::vector<TestResult> results;
+
+    results.push_back(test_single_tile_matches_reference());
+    results.push_back(test_systolic_latency());
+    results.push_back(test_tiler_ragged_shapes());
+    results.push_back(test_tiler_relu_after_k());
+    results.push_back(test_descriptor_chain());
+    results.push_back(test_int4_pairs());
+    results.push_back(test_zero_k_skip());
+    results.push_back(test_sparse_stream());
+    results.push_back(test_cluster_split());
+    results.push_back(test_back_to_back());
+    results.push_back(test_operand_reuse());
+    results.push_back(test_operand_gating());
+    results.push_back(test_vcd_trace_diff());
+    results.push_back(test_config_package());
+    results.push_back(test_cosim_channel());
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto& result : results) {
+        std::cout << "[" << (result.passed ? "PASS" : "FAIL") << "] "
+                  << result.name;
+        if (!result.passed) {
+            std::cout << " - " << result.message;
+        }
+        std::cout << "\n";
+
+        if (result.passed) {
+            ++passed;
+        } else {
+            ++failed;
+        }
+    }
+
+    std::cout << "\n========================================\n";
+    std::cout << "Results: " << passed << " passed, " << failed << " failed\n";
+    std::cout << "========================================\n";
+
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "npu_alloc.hpp"
+
+// Worker pool for the host GEMM kernels. Workers are spread over the NUMA
+// nodes in proportion to their CPUs and pinned to their node. Work items are
+// homed on nodes in contiguous ranges (home_node), and each worker drains its
+// own node's range before stealing from the others, so when a buffer was
+// first touched with the same split (first_touch), every item runs next to
+// its data unless the load is uneven.
+namespace npu {
+
+class ThreadPool {
+public:
+    // threads = 0 starts one worker per CPU
+    explicit ThreadPool(int threads = 0, bool pin = true) {
+        const NumaTopology& topo = numa_topology();
+        int cpus = 0;
+        for (const auto& node : topo.node_cpus) {
+            cpus += static_cast<int>(node.size());
+        }
+        const int count = threads > 0 ? threads : cpus;
+        nodes_ = std::min(topo.nodes(), count);
+        next_ = std::vector<std::atomic<int>>(static_cast<std::size_t>(nodes_));
+        end_.assign(static_cast<std::size_t>(nodes_), 0);
+        // One worker per node, the rest shared out in proportion to the
+        // nodes' CPUs, in node order
+        int node_cpus = 0;
+        for (int node = 0; node < nodes_; ++node) {
+            node_cpus += static_cast<int>(topo.node_cpus[node].size());
+        }
+        int seen_cpus = 0;
+        int extra = 0;
+        for (int node = 0; node < nodes_; ++node) {
+            seen_cpus += static_cast<int>(topo.node_cpus[node].size());
+            const int upto = static_cast<int>(static_cast<int64_t>(count - nodes_) * seen_cpus / std::max(node_cpus, 1));
+            worker_nodes_.insert(worker_nodes_.end(), static_cast<std::size_t>(1 + upto - extra), node);
+            extra = upto;
+        }
+        for (int w = 0; w < count; ++w) {
+            workers_.emplace_back([this, w] { work(w); });
+            if (pin) {
+                pin_to_node(workers_.back(), topo.node_cpus[worker_nodes_[w]]);
+            }
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()); }
+    int nodes() const { return nodes_; }
+    int worker_node(int worker) const { return worker_nodes_[worker]; }
+
+    // Node owning item index of count: node n owns a contiguous range, sized
+    // by its share of the workers
+    int home_node(int index, int count) const {
+        const int64_t workers = static_cast<int64_t>(worker_nodes_.size());
+        return worker_nodes_[static_cast<std::size_t>(index * workers / std::max(count, 1))];
+    }
+
+    // Runs fn(index, worker) for every index in [0, count) and waits. Not
+    // reentrant: fn must not call back into the pool. The first exception
+    // thrown by fn is rethrown here once all workers have stopped.
+    template <typename Fn>
+    void parallel_for(int count, Fn&& fn) {
+        if (count <= 0) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = std::function<void(int, int)>(std::forward<Fn>(fn));
+        int begin = 0;
+        for (int node = 0; node < nodes_; ++node) {
+            int end = begin;
+            while (end < count && home_node(end, count) == node) {
+                ++end;
+            }
+            next_[node].store(begin, std::memory_order_relaxed);
+            end_[node] = end;
+            begin = end;
+        }
+        error_ = nullptr;
+        active_ = size();
+        ++generation_;
+        start_.notify_all();
+        done_.wait(lock, [this] { return active_ == 0; });
+        job_ = nullptr;
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    // Zeroes [data, data + bytes) so chunk i of the buffer is first touched,
+    // and so placed, on home_node(i, chunks). Use the chunking of the later
+    // parallel_for, e.g. one GEMM row strip per chunk.
+    void first_touch(void* data, std::size_t bytes, std::size_t chunk_bytes) {
+        if (chunk_bytes == 0) {
+            throw std::invalid_argument("ThreadPool::first_touch: chunk_bytes must be positive");
+        }
+        const int chunks = static_cast<int>((bytes + chunk_bytes - 1) / chunk_bytes);
+        parallel_for(chunks, [&](int chunk, int) {
+            const std::size_t offset = static_cast<std::size_t>(chunk) * chunk_bytes;
+            std::memset(static_cast<char*>(data) + offset, 0, std::min(chunk_bytes, bytes - offset));
+        });
+    }
+
+private:
+    static void pin_to_node(std::thread& worker, const std::vector<int>& cpus) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            CPU_SET(cpu, &set);
+        }
+        pthread_setaffinity_np(worker.native_handle(), sizeof(set), &set);
+#else
+        (void)worker;
+        (void)cpus;
+#endif
+    }
+
+    void work(int worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+            }
+            // Own node first, then steal from the others in turn
+            for (int step = 0; step < nodes_; ++step) {
+                const int node = (worker_nodes_[worker] + step) % nodes_;
+                for (int index = next_[node].fetch_add(1); index < end_[node]; index = next_[node].fetch_add(1)) {
+                    try {
+                        job_(index, worker);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (!error_) {
+                            error_ = std::current_exception();
+                        }
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    int nodes_ = 1;
+    std::vector<int> worker_nodes_;
+    std::vector<std::thread> workers_;
+    std::vector<std::atomic<int>> next_;
+    std::vector<int> end_;
+    std::function<void(int, int)> job_;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    uint64_t generation_ = 0;
+    int active_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace npu
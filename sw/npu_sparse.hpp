@@ -0,0 +1,434 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(_WIN32)
+#include <immintrin.h>
+#endif
+
+#include "npu_host.hpp"
+
+// Sparse int8 weight formats for the host GEMM path. Weights are the B
+// operand (K x N) of C = A * B, as in the tiler and the host kernels.
+namespace npu {
+
+// ============================================================================
+// 2:4 Structured Sparsity
+// ============================================================================
+
+// K x N int8 weights where every group of four consecutive k (per output
+// column) holds at most two non-zeros. Each group is stored as its two
+// values plus their 2-bit positions in the group, so a column is K/2 values
+// and K/4 nibbles of metadata. Groups with fewer than two non-zeros are padded
+// with zero values at position 0.
+struct Sparse24Matrix {
+    int rows = 0;   // K
+    int cols = 0;   // N
+    int groups = 0; // ceil(K / 4)
+    std::vector<int8_t> values;   // [n][group][2]
+    std::vector<uint8_t> indices; // [n][group / 2]: low nibble even group, high nibble odd; i0 | i1 << 2
+
+    int meta_stride() const { return (groups + 1) / 2; }
+    const int8_t* column_values(int n) const { return &values[static_cast<std::size_t>(n) * groups * 2]; }
+    const uint8_t* column_indices(int n) const { return &indices[static_cast<std::size_t>(n) * meta_stride()]; }
+
+    // Positions of the two stored values of group g in column n
+    void positions(int n, int g, int& i0, int& i1) const {
+        const int nibble = (column_indices(n)[g / 2] >> ((g % 2) * 4)) & 0xf;
+        i0 = nibble & 3;
+        i1 = nibble >> 2;
+    }
+};
+
+// True if every 4-group of every column has at most two non-zeros
+template <typename T>
+bool is_2_4_sparse(MatrixView<T> w) {
+    for (int n = 0; n < w.cols(); ++n) {
+        for (int k0 = 0; k0 < w.rows(); k0 += 4) {
+            int nonzero = 0;
+            for (int k = k0; k < std::min(k0 + 4, w.rows()); ++k) {
+                nonzero += (w.at(k, n) != 0);
+            }
+            if (nonzero > 2) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Magnitude pruning in place: keeps the two largest |w| of each 4-group
+// (the earlier one on ties) and zeroes the rest
+template <typename T>
+void prune_2_4(MatrixView<T> w) {
+    for (int n = 0; n < w.cols(); ++n) {
+        for (int k0 = 0; k0 < w.rows(); k0 += 4) {
+            const int len = std::min(4, w.rows() - k0);
+            int first = -1;
+            int second = -1;
+            for (int i = 0; i < len; ++i) {
+                const int mag = std::abs(static_cast<int>(w.at(k0 + i, n)));
+                if (first < 0 || mag > std::abs(static_cast<int>(w.at(k0 + first, n)))) {
+                    second = first;
+                    first = i;
+                } else if (second < 0 || mag > std::abs(static_cast<int>(w.at(k0 + second, n)))) {
+                    second = i;
+                }
+            }
+            for (int i = 0; i < len; ++i) {
+                if (i != first && i != second) {
+                    w.at(k0 + i, n) = 0;
+                }
+            }
+        }
+    }
+}
+
+// Compresses a dense K x N matrix that already has the 2:4 pattern (see
+// prune_2_4). Throws if a group holds more than two non-zeros.
+template <typename T>
+Sparse24Matrix compress_2_4(MatrixView<T> w) {
+    Sparse24Matrix s;
+    s.rows = w.rows();
+    s.cols = w.cols();
+    s.groups = (w.rows() + 3) / 4;
+    s.values.assign(static_cast<std::size_t>(s.cols) * s.groups * 2, 0);
+    s.indices.assign(static_cast<std::size_t>(s.cols) * s.meta_stride(), 0);
+    for (int n = 0; n < s.cols; ++n) {
+        int8_t* values = &s.values[static_cast<std::size_t>(n) * s.groups * 2];
+        uint8_t* meta = &s.indices[static_cast<std::size_t>(n) * s.meta_stride()];
+        for (int g = 0; g < s.groups; ++g) {
+            int kept = 0;
+            int pos[2] = {0, 0};
+            for (int i = 0; i < 4 && 4 * g + i < s.rows; ++i) {
+                const int value = static_cast<int>(w.at(4 * g + i, n));
+                if (value == 0) {
+                    continue;
+                }
+                if (kept == 2) {
+                    throw std::invalid_argument("compress_2_4: more than two non-zeros in a group of four");
+                }
+                values[2 * g + kept] = static_cast<int8_t>(value);
+                pos[kept++] = i;
+            }
+            meta[g / 2] |= static_cast<uint8_t>((pos[0] | (pos[1] << 2)) << ((g % 2) * 4));
+        }
+    }
+    return s;
+}
+
+// Dense K x N copy of a compressed matrix
+inline HostMatrix<int8_t> decompress_2_4(const Sparse24Matrix& s) {
+    HostMatrix<int8_t> w(s.rows, s.cols);
+    for (int n = 0; n < s.cols; ++n) {
+        for (int g = 0; g < s.groups; ++g) {
+            int i0 = 0;
+            int i1 = 0;
+            s.positions(n, g, i0, i1);
+            w.at(4 * g + i0, n) += s.column_values(n)[2 * g];
+            w.at(4 * g + i1, n) += s.column_values(n)[2 * g + 1];
+        }
+    }
+    return w;
+}
+
+namespace detail {
+
+// Output columns per panel of the AVX2 2:4 kernel
+constexpr int kSparse24Cols = 16;
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(_WIN32)
+#define NPU_SPARSE24_AVX2 1
+
+// Four A rows against one panel, vectorized over columns. Per group, a row's
+// four int16 A values are broadcast, one vpshufb per eight columns gathers
+// the two each column keeps, and vpmaddwd multiplies them by the columns'
+// two weights. ctrl holds 64 shuffle bytes and vals 32 int16 weights per
+// group; out receives 4 x kSparse24Cols sums.
+__attribute__((target("avx2"))) inline __m256i broadcast_quad(const int16_t* p) {
+    long long quad;
+    std::memcpy(&quad, p, sizeof(quad));
+    return _mm256_set1_epi64x(quad);
+}
+
+__attribute__((target("avx2"))) inline __m256i madd_gathered(__m256i acc, __m256i a4, __m256i control, __m256i pairs) {
+    return _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_shuffle_epi8(a4, control), pairs));
+}
+
+__attribute__((target("avx2"))) inline void gemm_2_4_panel_avx2(const int16_t* const* rows, const uint8_t* ctrl,
+                                                                 const int16_t* vals, int groups, int32_t* out) {
+    // Accumulators named rather than in an array so they stay in registers
+    __m256i acc00 = _mm256_setzero_si256();
+    __m256i acc01 = _mm256_setzero_si256();
+    __m256i acc10 = _mm256_setzero_si256();
+    __m256i acc11 = _mm256_setzero_si256();
+    __m256i acc20 = _mm256_setzero_si256();
+    __m256i acc21 = _mm256_setzero_si256();
+    __m256i acc30 = _mm256_setzero_si256();
+    __m256i acc31 = _mm256_setzero_si256();
+    for (int g = 0; g < groups; ++g) {
+        const __m256i c0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ctrl + 64 * g));
+        const __m256i c1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ctrl + 64 * g + 32));
+        const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals + 32 * g));
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals + 32 * g + 16));
+        const __m256i a0 = broadcast_quad(rows[0] + 4 * g);
+        const __m256i a1 = broadcast_quad(rows[1] + 4 * g);
+        const __m256i a2 = broadcast_quad(rows[2] + 4 * g);
+        const __m256i a3 = broadcast_quad(rows[3] + 4 * g);
+        acc00 = madd_gathered(acc00, a0, c0, v0);
+        acc01 = madd_gathered(acc01, a0, c1, v1);
+        acc10 = madd_gathered(acc10, a1, c0, v0);
+        acc11 = madd_gathered(acc11, a1, c1, v1);
+        acc20 = madd_gathered(acc20, a2, c0, v0);
+        acc21 = madd_gathered(acc21, a2, c1, v1);
+        acc30 = madd_gathered(acc30, a3, c0, v0);
+        acc31 = madd_gathered(acc31, a3, c1, v1);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), acc00);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8), acc01);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16), acc10);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 24), acc11);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), acc20);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 40), acc21);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 48), acc30);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 56), acc31);
+}
+#endif
+
+inline bool sparse24_avx2() {
+#ifdef NPU_SPARSE24_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+// gemm_2_4 through gemm_2_4_panel_avx2. A is widened to int16 once, padded
+// to whole groups; each panel's columns are laid out per group once and
+// reused for every block of four rows.
+template <typename TA, typename TC>
+void gemm_2_4_simd(MatrixView<TA> a, const Sparse24Matrix& w, MatrixView<TC> c) {
+#ifdef NPU_SPARSE24_AVX2
+    const std::size_t stride = static_cast<std::size_t>(w.groups) * 4;
+    std::vector<int16_t> a16(static_cast<std::size_t>(a.rows()) * stride, 0);
+    for (int i = 0; i < a.rows(); ++i) {
+        for (int k = 0; k < a.cols(); ++k) {
+            a16[i * stride + k] = static_cast<int16_t>(a.at(i, k));
+        }
+    }
+    std::vector<uint8_t> ctrl(static_cast<std::size_t>(w.groups) * 64);
+    std::vector<int16_t> vals(static_cast<std::size_t>(w.groups) * 32);
+    int32_t out[4 * kSparse24Cols];
+    for (int n0 = 0; n0 < w.cols; n0 += kSparse24Cols) {
+        const int cols = std::min(kSparse24Cols, w.cols - n0);
+        std::fill(ctrl.begin(), ctrl.end(), 0);
+        std::fill(vals.begin(), vals.end(), 0);
+        for (int j = 0; j < cols; ++j) {
+            // Column j is int32 lane j % 8 of half j / 8, so its four
+            // control bytes sit at 4 * j and its weight pair at 2 * j
+            uint8_t* control = &ctrl[4 * static_cast<std::size_t>(j)];
+            int16_t* pair = &vals[2 * static_cast<std::size_t>(j)];
+            for (int g = 0; g < w.groups; ++g) {
+                int i0 = 0;
+                int i1 = 0;
+                w.positions(n0 + j, g, i0, i1);
+                uint8_t* bytes = control + 64 * static_cast<std::size_t>(g);
+                bytes[0] = static_cast<uint8_t>(2 * i0);
+                bytes[1] = static_cast<uint8_t>(2 * i0 + 1);
+                bytes[2] = static_cast<uint8_t>(2 * i1);
+                bytes[3] = static_cast<uint8_t>(2 * i1 + 1);
+                pair[32 * static_cast<std::size_t>(g)] = w.column_values(n0 + j)[2 * g];
+                pair[32 * static_cast<std::size_t>(g) + 1] = w.column_values(n0 + j)[2 * g + 1];
+            }
+        }
+        for (int i0 = 0; i0 < a.rows(); i0 += 4) {
+            const int rows = std::min(4, a.rows() - i0);
+            const int16_t* row[4];
+            for (int r = 0; r < 4; ++r) {
+                row[r] = a16.data() + (i0 + std::min(r, rows - 1)) * stride;
+            }
+            gemm_2_4_panel_avx2(row, ctrl.data(), vals.data(), w.groups, out);
+            for (int r = 0; r < rows; ++r) {
+                for (int j = 0; j < cols; ++j) {
+                    c.at(i0 + r, n0 + j) = static_cast<TC>(out[kSparse24Cols * r + j]);
+                }
+            }
+        }
+    }
+#else
+    (void)a;
+    (void)w;
+    (void)c;
+#endif
+}
+
+} // namespace detail
+
+// C = A * W for 2:4 W: two MACs per group of four k instead of four. int8
+// and int16 A take the AVX2 kernel when the CPU has it. Otherwise each
+// column's metadata is decoded once per block of four A rows and the two
+// gathered A values per row feed four independent accumulators.
+template <typename TA, typename TC>
+void gemm_2_4(MatrixView<TA> a, const Sparse24Matrix& w, MatrixView<TC> c) {
+    if (a.cols() != w.rows || c.rows() != a.rows() || c.cols() != w.cols) {
+        throw std::invalid_argument("gemm_2_4: shapes do not match C = A * W");
+    }
+    if ((std::is_same<TA, int8_t>::value || std::is_same<TA, int16_t>::value) && detail::sparse24_avx2()) {
+        detail::gemm_2_4_simd(a, w, c);
+        return;
+    }
+    constexpr int kRows = 4;
+    for (int i0 = 0; i0 < a.rows(); i0 += kRows) {
+        const int rows = std::min(kRows, a.rows() - i0);
+        const TA* row[kRows];
+        for (int r = 0; r < kRows; ++r) {
+            row[r] = &a.at(i0 + std::min(r, rows - 1), 0);
+        }
+        const std::ptrdiff_t step = a.col_stride();
+        for (int n = 0; n < w.cols; ++n) {
+            const int8_t* values = w.column_values(n);
+            const uint8_t* meta = w.column_indices(n);
+            int32_t acc[kRows] = {0, 0, 0, 0};
+            for (int g = 0; g < w.groups; ++g) {
+                const int nibble = (meta[g >> 1] >> ((g & 1) * 4)) & 0xf;
+                const std::ptrdiff_t k0 = (4 * g + (nibble & 3)) * step;
+                const std::ptrdiff_t k1 = (4 * g + (nibble >> 2)) * step;
+                const int32_t v0 = values[2 * g];
+                const int32_t v1 = values[2 * g + 1];
+                for (int r = 0; r < kRows; ++r) {
+                    acc[r] += static_cast<int32_t>(row[r][k0]) * v0 + static_cast<int32_t>(row[r][k1]) * v1;
+                }
+            }
+            for (int r = 0; r < rows; ++r) {
+                c.at(i0 + r, n) = static_cast<TC>(acc[r]);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Block-Sparse (BSR)
+// ============================================================================
+
+// K x N int8 weights in block compressed sparse row form: the matrix is cut
+// into block x block tiles (use ARRAY_SIZE so one block is one NPU operand
+// tile), and only tiles with a non-zero are stored. Block row kb's tiles are
+// entries row_ptr[kb] .. row_ptr[kb + 1] - 1. Each has its block column in
+// col_idx and block * block values, row-major, zero-padded past K or N.
+struct BsrMatrix {
+    int rows = 0;  // K
+    int cols = 0;  // N
+    int block = 0;
+    std::vector<int> row_ptr; // block_rows() + 1 entries
+    std::vector<int> col_idx;
+    std::vector<int8_t> values;
+
+    int block_rows() const { return (rows + block - 1) / block; }
+    int block_cols() const { return (cols + block - 1) / block; }
+    int nonzero_blocks() const { return static_cast<int>(col_idx.size()); }
+    double block_density() const {
+        const double total = static_cast<double>(block_rows()) * block_cols();
+        return total == 0.0 ? 0.0 : nonzero_blocks() / total;
+    }
+    const int8_t* block_values(int entry) const {
+        return &values[static_cast<std::size_t>(entry) * block * block];
+    }
+};
+
+// Compresses a dense K x N matrix, dropping every all-zero block
+template <typename T>
+BsrMatrix to_bsr(MatrixView<T> w, int block) {
+    if (block < 1) {
+        throw std::invalid_argument("to_bsr: block size must be at least 1");
+    }
+    BsrMatrix s;
+    s.rows = w.rows();
+    s.cols = w.cols();
+    s.block = block;
+    s.row_ptr.push_back(0);
+    for (int kb = 0; kb < s.block_rows(); ++kb) {
+        const int k0 = kb * block;
+        const int k_len = std::min(block, s.rows - k0);
+        for (int nb = 0; nb < s.block_cols(); ++nb) {
+            const int n0 = nb * block;
+            const int n_len = std::min(block, s.cols - n0);
+            bool nonzero = false;
+            for (int k = 0; k < k_len && !nonzero; ++k) {
+                for (int n = 0; n < n_len && !nonzero; ++n) {
+                    nonzero = w.at(k0 + k, n0 + n) != 0;
+                }
+            }
+            if (!nonzero) {
+                continue;
+            }
+            s.col_idx.push_back(nb);
+            const std::size_t base = s.values.size();
+            s.values.resize(base + static_cast<std::size_t>(block) * block, 0);
+            for (int k = 0; k < k_len; ++k) {
+                for (int n = 0; n < n_len; ++n) {
+                    s.values[base + static_cast<std::size_t>(k) * block + n] = static_cast<int8_t>(w.at(k0 + k, n0 + n));
+                }
+            }
+        }
+        s.row_ptr.push_back(s.nonzero_blocks());
+    }
+    return s;
+}
+
+// Dense K x N copy, e.g. as the B operand of the NPU tiler
+template <typename T = int8_t>
+HostMatrix<T> from_bsr(const BsrMatrix& s) {
+    HostMatrix<T> w(s.rows, s.cols);
+    for (int kb = 0; kb < s.block_rows(); ++kb) {
+        for (int entry = s.row_ptr[kb]; entry < s.row_ptr[kb + 1]; ++entry) {
+            const int8_t* values = s.block_values(entry);
+            for (int k = 0; k < s.block && kb * s.block + k < s.rows; ++k) {
+                for (int n = 0; n < s.block && s.col_idx[entry] * s.block + n < s.cols; ++n) {
+                    w.at(kb * s.block + k, s.col_idx[entry] * s.block + n) = static_cast<T>(values[k * s.block + n]);
+                }
+            }
+        }
+    }
+    return w;
+}
+
+// C = A * W touching only stored blocks: per A row, each non-zero block adds
+// a block-wide strip of C from block A values. Work scales with the block
+// density; the edge of C past N is never written.
+template <typename TA, typename TC>
+void gemm_bsr(MatrixView<TA> a, const BsrMatrix& w, MatrixView<TC> c) {
+    if (a.cols() != w.rows || c.rows() != a.rows() || c.cols() != w.cols) {
+        throw std::invalid_argument("gemm_bsr: shapes do not match C = A * W");
+    }
+    const int bs = w.block;
+    std::vector<int32_t> acc(static_cast<std::size_t>(w.block_cols()) * bs);
+    for (int i = 0; i < a.rows(); ++i) {
+        std::fill(acc.begin(), acc.end(), 0);
+        for (int kb = 0; kb < w.block_rows(); ++kb) {
+            const int k_len = std::min(bs, w.rows - kb * bs);
+            for (int entry = w.row_ptr[kb]; entry < w.row_ptr[kb + 1]; ++entry) {
+                const int8_t* values = w.block_values(entry);
+                int32_t* out = &acc[static_cast<std::size_t>(w.col_idx[entry]) * bs];
+                for (int k = 0; k < k_len; ++k) {
+                    const int32_t av = static_cast<int32_t>(a.at(i, kb * bs + k));
+                    const int8_t* w_row = values + k * bs;
+                    for (int n = 0; n < bs; ++n) {
+                        out[n] += av * w_row[n];
+                    }
+                }
+            }
+        }
+        for (int n = 0; n < w.cols; ++n) {
+            c.at(i, n) = static_cast<TC>(acc[n]);
+        }
+    }
+}
+
+} // namespace npu
@@ -0,0 +1,631 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX // keep std::min / std::max usable
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "npu_model.hpp"
+
+// VCD tracing for the C++ model and a streaming RTL-vs-model trace diff.
+// The writer buffers output in a fixed-size block and the reader walks a
+// memory-mapped dump front to back, keeping only the current value of the
+// signals it compares, so both run in bounded memory on multi-GB dumps.
+namespace npu {
+
+// ============================================================================
+// VCD Writer
+// ============================================================================
+
+class VcdWriter {
+public:
+    explicit VcdWriter(const std::string& path, size_t buffer_bytes = 1 << 20)
+        : file_(std::fopen(path.c_str(), "wb")), capacity_(buffer_bytes) {
+        if (!file_) {
+            throw std::runtime_error("VcdWriter: cannot open " + path);
+        }
+        buffer_.reserve(capacity_);
+    }
+
+    ~VcdWriter() { close(); }
+
+    VcdWriter(const VcdWriter&) = delete;
+    VcdWriter& operator=(const VcdWriter&) = delete;
+
+    // Declares a signal; all signals must be added before begin()
+    int add_signal(const std::string& name, int width) {
+        if (started_) {
+            throw std::logic_error("VcdWriter: signals must be added before begin()");
+        }
+        if (width < 1 || width > 64) {
+            throw std::invalid_argument("VcdWriter: signal width must be 1..64");
+        }
+        signals_.push_back({name, identifier(static_cast<int>(signals_.size())), width, 0, false});
+        return static_cast<int>(signals_.size()) - 1;
+    }
+
+    // Writes the header: every signal in one module scope
+    void begin(const std::string& scope, const std::string& timescale = "1ns") {
+        put("$version npu_model $end\n$timescale " + timescale + " $end\n$scope module " + scope + " $end\n");
+        for (const auto& signal : signals_) {
+            put("$var wire " + std::to_string(signal.width) + " " + signal.id + " " + signal.name);
+            if (signal.width > 1) {
+                put(" [" + std::to_string(signal.width - 1) + ":0]");
+            }
+            put(" $end\n");
+        }
+        put("$upscope $end\n$enddefinitions $end\n");
+        started_ = true;
+    }
+
+    void timestamp(uint64_t time) {
+        if (time_written_ && time <= time_) {
+            return;
+        }
+        time_ = time;
+        time_written_ = true;
+        put("#" + std::to_string(time) + "\n");
+    }
+
+    // Records value (low width bits) at the current timestamp, if it changed
+    void change(int signal, uint64_t value) {
+        Signal& s = signals_.at(static_cast<size_t>(signal));
+        if (s.width < 64) {
+            value &= (uint64_t{1} << s.width) - 1u;
+        }
+        if (s.known && s.value == value) {
+            return;
+        }
+        s.value = value;
+        s.known = true;
+        if (s.width == 1) {
+            buffer_.push_back(value ? '1' : '0');
+        } else {
+            buffer_.push_back('b');
+            int top = s.width - 1;
+            while (top > 0 && ((value >> top) & 1u) == 0) {
+                --top;
+            }
+            for (int bit = top; bit >= 0; --bit) {
+                buffer_.push_back(((value >> bit) & 1u) ? '1' : '0');
+            }
+            buffer_.push_back(' ');
+        }
+        put(s.id);
+        buffer_.push_back('\n');
+        if (buffer_.size() >= capacity_) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (file_ && !buffer_.empty()) {
+            if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+                throw std::runtime_error("VcdWriter: write failed");
+            }
+            buffer_.clear();
+        }
+    }
+
+    void close() {
+        if (file_) {
+            flush();
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+private:
+    struct Signal {
+        std::string name;
+        std::string id;
+        int width;
+        uint64_t value;
+        bool known;
+    };
+
+    // Printable identifier codes '!'..'~', base 94
+    static std::string identifier(int index) {
+        std::string id;
+        do {
+            id.push_back(static_cast<char>('!' + index % 94));
+            index /= 94;
+        } while (index > 0);
+        return id;
+    }
+
+    void put(const std::string& text) {
+        buffer_.insert(buffer_.end(), text.begin(), text.end());
+        if (buffer_.size() >= capacity_) {
+            flush();
+        }
+    }
+
+    std::FILE* file_;
+    size_t capacity_;
+    std::vector<char> buffer_;
+    std::vector<Signal> signals_;
+    uint64_t time_ = 0;
+    bool time_written_ = false;
+    bool started_ = false;
+};
+
+// ============================================================================
+// Model Trace
+// ============================================================================
+
+// Cycle trace of npu_core's control and result signals, under the same names
+// as the RTL. The host is ideal: operand beats are already in the FIFO,
+// result_ready is held high, and start is raised on the first cycle the core
+// is idle (!busy && !done), so each tile spans tile_cycles(). Cycle c is
+// written at time c*period with a rising clk edge, clk falls half a period
+// later. Only the default npu_core timing is traced (no BACK_TO_BACK).
+class CoreTracer {
+public:
+    CoreTracer(const CoreConfig& cfg, VcdWriter& vcd, const std::string& scope = "npu_core", uint64_t period = 10)
+        : cfg_(cfg), core_(cfg), vcd_(vcd), period_(period) {
+        if (cfg.variant != CoreVariant::Broadcast || cfg.back_to_back) {
+            throw std::invalid_argument("CoreTracer: traces the default npu_core timing");
+        }
+        const int index_width = std::max(1, ceil_log2(output_count(cfg)));
+        clk_            = vcd_.add_signal("clk", 1);
+        start_          = vcd_.add_signal("start", 1);
+        active_         = vcd_.add_signal("active", 1);
+        valid_stage0_   = vcd_.add_signal("valid_stage0", 1);
+        valid_stage1_   = vcd_.add_signal("valid_stage1", 1);
+        done_           = vcd_.add_signal("done", 1);
+        c_valid_        = vcd_.add_signal("c_valid", 1);
+        streaming_      = vcd_.add_signal("streaming", 1);
+        busy_           = vcd_.add_signal("busy", 1);
+        result_valid_   = vcd_.add_signal("result_valid", 1);
+        result_data_    = vcd_.add_signal("result_data", acc_width(cfg));
+        result_index_   = vcd_.add_signal("result_index", index_width);
+        result_last_    = vcd_.add_signal("result_last", 1);
+        vcd_.begin(scope);
+    }
+
+    uint64_t cycle() const { return cycle_; }
+
+    // Cycles with the core idle and start low
+    void idle(int cycles) {
+        for (int t = 0; t < cycles; ++t) {
+            emit_cycle(false, false, false, false, false, false, false);
+        }
+    }
+
+    // One start/feed/stream job, from the start cycle to the last cycle
+    // before the next start
+    IntMatrix run_tile(const IntMatrix& a_tile, const IntMatrix& b_tile) {
+        const IntMatrix result = core_.run_tile(a_tile, b_tile);
+        const std::vector<StreamWord> words = stream_tile(result, cfg_.sparse_stream);
+        const int k = a_tile.cols;
+        const int latency = compute_latency(cfg_, k);
+        const int w = static_cast<int>(words.size());
+        for (int t = 0; t < tile_cycles(cfg_, k, w); ++t) {
+            const bool streaming = t >= latency + 1 && t <= latency + w + 1;
+            const bool result_valid = t >= latency + 2 && t <= latency + w + 1;
+            if (result_valid) {
+                const StreamWord& word = words[static_cast<size_t>(t - latency - 2)];
+                last_index_ = static_cast<uint64_t>(word.index);
+                last_data_ = static_cast<uint64_t>(static_cast<int64_t>(word.data));
+            }
+            emit_cycle(t == 0, t >= 1 && t <= latency - 1, t >= 2 && t <= k + 1, t >= 3 && t <= k + 2,
+                       t == latency, streaming, result_valid, t == latency + w + 1);
+        }
+        return result;
+    }
+
+private:
+    void emit_cycle(bool start, bool active, bool valid_stage0, bool valid_stage1, bool done, bool streaming,
+                    bool result_valid, bool result_last = false) {
+        vcd_.timestamp(cycle_ * period_);
+        vcd_.change(clk_, 1);
+        vcd_.change(start_, start);
+        vcd_.change(active_, active);
+        vcd_.change(valid_stage0_, valid_stage0);
+        vcd_.change(valid_stage1_, valid_stage1);
+        vcd_.change(done_, done);
+        vcd_.change(c_valid_, done);
+        vcd_.change(streaming_, streaming);
+        vcd_.change(busy_, active || streaming);
+        vcd_.change(result_valid_, result_valid);
+        vcd_.change(result_data_, last_data_);
+        vcd_.change(result_index_, last_index_);
+        vcd_.change(result_last_, result_last);
+        vcd_.timestamp(cycle_ * period_ + period_ / 2);
+        vcd_.change(clk_, 0);
+        ++cycle_;
+    }
+
+    CoreConfig cfg_;
+    CoreModel core_;
+    VcdWriter& vcd_;
+    uint64_t period_;
+    uint64_t cycle_ = 0;
+    uint64_t last_index_ = 0;
+    uint64_t last_data_ = 0;
+    int clk_, start_, active_, valid_stage0_, valid_stage1_, done_, c_valid_;
+    int streaming_, busy_, result_valid_, result_data_, result_index_, result_last_;
+};
+
+// ============================================================================
+// VCD Reader
+// ============================================================================
+
+// Read-only memory map of a whole file. Pages are faulted in on demand and
+// can be dropped again by the OS, so resident memory stays bounded.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("MappedFile: cannot open " + path);
+        }
+        LARGE_INTEGER size;
+        GetFileSizeEx(file_, &size);
+        size_ = static_cast<size_t>(size.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_ || !(data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)))) {
+                throw std::runtime_error("MappedFile: cannot map " + path);
+            }
+        }
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw std::runtime_error("MappedFile: cannot open " + path);
+        }
+        struct stat info;
+        if (::fstat(fd_, &info) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("MappedFile: cannot stat " + path);
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0) {
+            void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (map == MAP_FAILED) {
+                ::close(fd_);
+                throw std::runtime_error("MappedFile: cannot map " + path);
+            }
+            ::madvise(map, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(map);
+        }
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+struct VcdVar {
+    std::string name; // full hierarchical name, e.g. npu_core_tb.dut.valid_stage1
+    std::string id;
+    int width = 1;
+};
+
+// Streams a VCD one clock cycle at a time. A cycle's sample holds each
+// tracked signal's value just before a rising edge of the clock, which is
+// the value a flop clocked by that edge sees.
+class VcdReader {
+public:
+    explicit VcdReader(const std::string& path) : file_(path), text_(file_.view()) { parse_header(); }
+
+    const std::vector<VcdVar>& vars() const { return vars_; }
+
+    // Leaf names of the signals directly inside scope
+    std::vector<std::string> signals_in_scope(const std::string& scope) const {
+        std::vector<std::string> leaves;
+        const std::string prefix = scope + ".";
+        for (const auto& var : vars_) {
+            if (var.name.compare(0, prefix.size(), prefix) == 0 && var.name.find('.', prefix.size()) == std::string::npos) {
+                leaves.push_back(var.name.substr(prefix.size()));
+            }
+        }
+        return leaves;
+    }
+
+    // Selects the clock and the signals sampled by next_cycle(), by full name
+    void track(const std::string& clock, const std::vector<std::string>& signals) {
+        tracked_.clear();
+        values_.assign(signals.size(), "x");
+        clock_id_ = find(clock).id;
+        for (size_t slot = 0; slot < signals.size(); ++slot) {
+            tracked_[find(signals[slot]).id].push_back(slot);
+        }
+    }
+
+    // Advances to the next rising clock edge. Returns false at end of file.
+    bool next_cycle() {
+        while (true) {
+            const std::string_view token = next_token();
+            if (token.empty() || token[0] == '#') {
+                // End of a timestamp block: sample before applying it if the clock rose
+                const bool rose = clock_ == '0' && pending_clock_ == '1';
+                const std::vector<std::string> sample = rose ? values_ : std::vector<std::string>();
+                for (auto& change : pending_) {
+                    values_[change.first] = std::move(change.second);
+                }
+                pending_.clear();
+                if (pending_clock_ != 0) {
+                    clock_ = pending_clock_;
+                    pending_clock_ = 0;
+                }
+                const uint64_t block_time = time_;
+                if (!token.empty()) {
+                    time_ = std::stoull(std::string(token.substr(1)));
+                }
+                if (rose) {
+                    sample_ = sample;
+                    sample_time_ = block_time;
+                    return true;
+                }
+                if (token.empty()) {
+                    return false;
+                }
+                continue;
+            }
+            if (token[0] == '$') {
+                if (token == "$comment") {
+                    skip_to_end();
+                }
+                continue; // $dumpvars, $dumpall, $end, ...
+            }
+            std::string value;
+            std::string_view id;
+            if (token[0] == 'b' || token[0] == 'B' || token[0] == 'r' || token[0] == 'R') {
+                value = normalize(token.substr(1));
+                id = next_token();
+            } else {
+                value = normalize(token.substr(0, 1));
+                id = token.substr(1);
+            }
+            const std::string key(id);
+            if (key == clock_id_) {
+                pending_clock_ = value[0];
+            }
+            const auto it = tracked_.find(key);
+            if (it != tracked_.end()) {
+                for (const size_t slot : it->second) {
+                    pending_.emplace_back(slot, value);
+                }
+            }
+        }
+    }
+
+    // Values of the tracked signals for the cycle ending at sample_time()
+    const std::vector<std::string>& sample() const { return sample_; }
+    uint64_t sample_time() const { return sample_time_; }
+
+private:
+    // Drops redundant leading bits: b0011 == b11, bxx10 == bx10
+    static std::string normalize(std::string_view value) {
+        size_t first = 0;
+        while (first + 1 < value.size() && value[first] == value[first + 1] &&
+               (value[first] == '0' || value[first] == 'x' || value[first] == 'X' || value[first] == 'z' ||
+                value[first] == 'Z')) {
+            ++first;
+        }
+        if (value[first] == '0' && first + 1 < value.size()) {
+            ++first;
+        }
+        std::string out(value.substr(first));
+        for (auto& ch : out) {
+            ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        }
+        return out;
+    }
+
+    std::string_view next_token() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+        const size_t begin = pos_;
+        while (pos_ < text_.size() && !std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+        return text_.substr(begin, pos_ - begin);
+    }
+
+    void skip_to_end() {
+        for (std::string_view token = next_token(); !token.empty() && token != "$end"; token = next_token()) {
+        }
+    }
+
+    void parse_header() {
+        std::vector<std::string> scopes;
+        for (std::string_view token = next_token(); !token.empty(); token = next_token()) {
+            if (token == "$scope") {
+                next_token(); // module, begin, task, ...
+                scopes.emplace_back(next_token());
+                skip_to_end();
+            } else if (token == "$upscope") {
+                if (!scopes.empty()) {
+                    scopes.pop_back();
+                }
+                skip_to_end();
+            } else if (token == "$var") {
+                next_token(); // wire, reg, integer, ...
+                VcdVar var;
+                var.width = std::stoi(std::string(next_token()));
+                var.id = std::string(next_token());
+                std::string prefix;
+                for (const auto& scope : scopes) {
+                    prefix += scope + ".";
+                }
+                var.name = prefix + std::string(next_token());
+                skip_to_end(); // optional bit range
+                vars_.push_back(var);
+            } else if (token == "$enddefinitions") {
+                skip_to_end();
+                return;
+            } else if (token[0] == '$') {
+                skip_to_end();
+            }
+        }
+        throw std::runtime_error("VcdReader: no $enddefinitions in header");
+    }
+
+    const VcdVar& find(const std::string& name) const {
+        for (const auto& var : vars_) {
+            if (var.name == name) {
+                return var;
+            }
+        }
+        throw std::invalid_argument("VcdReader: no signal " + name);
+    }
+
+    MappedFile file_;
+    std::string_view text_;
+    size_t pos_ = 0;
+    std::vector<VcdVar> vars_;
+    std::unordered_map<std::string, std::vector<size_t>> tracked_;
+    std::string clock_id_;
+    char clock_ = 'x';
+    char pending_clock_ = 0;
+    std::vector<std::string> values_;
+    std::vector<std::pair<size_t, std::string>> pending_;
+    std::vector<std::string> sample_;
+    uint64_t time_ = 0;
+    uint64_t sample_time_ = 0;
+};
+
+// ============================================================================
+// Trace Diff
+// ============================================================================
+
+struct VcdDiffOptions {
+    std::string clock = "clk";
+    std::string align = "start";      // cycle 0 is the first cycle this is 1; empty: first edge
+    std::vector<std::string> signals; // leaf names; empty: every common leaf except the clock
+    uint64_t max_cycles = 0;          // 0: until either trace ends
+};
+
+struct VcdDiff {
+    bool match = true;
+    uint64_t cycles = 0;     // aligned cycles compared
+    uint64_t cycle = 0;      // first divergent cycle, counted from alignment
+    uint64_t time_a = 0;     // clock edge ending that cycle, in each trace's time units
+    uint64_t time_b = 0;
+    std::string signal;
+    std::string value_a;
+    std::string value_b;
+    std::vector<std::string> compared;
+};
+
+// Compares the signals two scopes have in common, one clock cycle at a time,
+// and stops at the first cycle where any of them differs.
+inline VcdDiff diff_vcd(const std::string& path_a, const std::string& scope_a, const std::string& path_b,
+                        const std::string& scope_b, const VcdDiffOptions& options = VcdDiffOptions()) {
+    VcdReader a(path_a);
+    VcdReader b(path_b);
+    VcdDiff diff;
+
+    diff.compared = options.signals;
+    if (diff.compared.empty()) {
+        const std::vector<std::string> leaves_b = b.signals_in_scope(scope_b);
+        for (const auto& leaf : a.signals_in_scope(scope_a)) {
+            if (leaf != options.clock && std::find(leaves_b.begin(), leaves_b.end(), leaf) != leaves_b.end()) {
+                diff.compared.push_back(leaf);
+            }
+        }
+    }
+    if (!options.align.empty() &&
+        std::find(diff.compared.begin(), diff.compared.end(), options.align) == diff.compared.end()) {
+        diff.compared.push_back(options.align);
+    }
+    if (diff.compared.empty()) {
+        throw std::invalid_argument("diff_vcd: the scopes have no signals in common");
+    }
+
+    std::vector<std::string> names_a;
+    std::vector<std::string> names_b;
+    for (const auto& leaf : diff.compared) {
+        names_a.push_back(scope_a + "." + leaf);
+        names_b.push_back(scope_b + "." + leaf);
+    }
+    a.track(scope_a + "." + options.clock, names_a);
+    b.track(scope_b + "." + options.clock, names_b);
+
+    const size_t align_slot = options.align.empty()
+        ? diff.compared.size()
+        : static_cast<size_t>(std::find(diff.compared.begin(), diff.compared.end(), options.align) -
+                              diff.compared.begin());
+    auto seek = [align_slot](VcdReader& reader) {
+        while (reader.next_cycle()) {
+            if (align_slot >= reader.sample().size() || reader.sample()[align_slot] == "1") {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (!seek(a) || !seek(b)) {
+        return diff; // nothing to compare
+    }
+    while (options.max_cycles == 0 || diff.cycles < options.max_cycles) {
+        for (size_t slot = 0; slot < diff.compared.size(); ++slot) {
+            if (a.sample()[slot] != b.sample()[slot]) {
+                diff.match = false;
+                diff.cycle = diff.cycles;
+                diff.time_a = a.sample_time();
+                diff.time_b = b.sample_time();
+                diff.signal = diff.compared[slot];
+                diff.value_a = a.sample()[slot];
+                diff.value_b = b.sample()[slot];
+                return diff;
+            }
+        }
+        ++diff.cycles;
+        if (!a.next_cycle() || !b.next_cycle()) {
+            break;
+        }
+    }
+    return diff;
+}
+
+} // namespace npu
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+// Non-owning strided 2-D views, in the spirit of std::mdspan with a strided
+// layout. A view is a pointer to element (0, 0) plus the shape and the
+// distance, in elements, between neighbouring rows and columns. Slicing or
+// transposing a view only changes those numbers, so host kernels, the tiler
+// and layer code can work on parts of one buffer without copying it.
+namespace npu {
+
+// Operand flag of the BLAS-style entry points: Yes means the stored matrix
+// is the transpose of the operand, e.g. B held as N x K
+enum class Transpose { No, Yes };
+
+template <typename T>
+class MatrixView {
+public:
+    using element_type = T;
+
+    MatrixView() = default;
+
+    // Row-major rows x cols block starting at data
+    MatrixView(T* data, int rows, int cols) : MatrixView(data, rows, cols, cols, 1) {}
+
+    MatrixView(T* data, int rows, int cols, std::ptrdiff_t row_stride, std::ptrdiff_t col_stride)
+        : data_(data), rows_(rows), cols_(cols), row_stride_(row_stride), col_stride_(col_stride) {
+        if (rows < 0 || cols < 0) {
+            throw std::invalid_argument("MatrixView: negative shape");
+        }
+    }
+
+    // A view of T converts to a view of const T
+    template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value && !std::is_same<U, T>::value>>
+    MatrixView(const MatrixView<U>& other)
+        : data_(other.data()), rows_(other.rows()), cols_(other.cols()), row_stride_(other.row_stride()),
+          col_stride_(other.col_stride()) {}
+
+    T* data() const { return data_; }
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    std::ptrdiff_t row_stride() const { return row_stride_; }
+    std::ptrdiff_t col_stride() const { return col_stride_; }
+    bool empty() const { return rows_ == 0 || cols_ == 0; }
+    // Rows are dense and back to back, as in a plain row-major buffer
+    bool contiguous() const { return col_stride_ == 1 && (row_stride_ == cols_ || rows_ <= 1); }
+    // Columns are dense, as in the transpose of a row-major buffer. Copy
+    // loops walk such a view down its columns.
+    bool column_major() const { return row_stride_ == 1 && col_stride_ != 1; }
+
+    T& at(int r, int c) const { return data_[r * row_stride_ + c * col_stride_]; }
+    T& operator()(int r, int c) const { return at(r, c); }
+    T* row_data(int r) const { return data_ + r * row_stride_; }
+
+    // rows x cols block at (r0, c0), sharing this view's storage
+    MatrixView submatrix(int r0, int c0, int rows, int cols) const {
+        if (r0 < 0 || c0 < 0 || rows < 0 || cols < 0 || r0 + rows > rows_ || c0 + cols > cols_) {
+            throw std::out_of_range("MatrixView::submatrix: block outside the view");
+        }
+        return MatrixView((rows == 0 || cols == 0) ? data_ : &at(r0, c0), rows, cols, row_stride_, col_stride_);
+    }
+
+    MatrixView rows_slice(int r0, int rows) const { return submatrix(r0, 0, rows, cols_); }
+    MatrixView cols_slice(int c0, int cols) const { return submatrix(0, c0, rows_, cols); }
+
+    // Same elements with rows and columns swapped
+    MatrixView transposed() const { return MatrixView(data_, cols_, rows_, col_stride_, row_stride_); }
+
+private:
+    T* data_ = nullptr;
+    int rows_ = 0;
+    int cols_ = 0;
+    std::ptrdiff_t row_stride_ = 0;
+    std::ptrdiff_t col_stride_ = 1;
+};
+
+// The operand a stored matrix stands for: m itself, or its transpose
+template <typename T>
+MatrixView<T> transpose_if(MatrixView<T> m, Transpose t) {
+    return t == Transpose::Yes ? m.transposed() : m;
+}
+
+} // namespace npu
@@ -7,39 +7,19 @@
 #include <random>
 #include <vector>
 
-namespace {
-
-constexpr int kDataWidth  = 8;
-constexpr int kInt8Max    = (1 << (kDataWidth - 1)) - 1;
-constexpr int kInt8Min    = -(1 << (kDataWidth - 1));
-constexpr float kTolerance = 1e-5f;
+#include "npu_host.hpp"
 
-struct QuantParams {
-    float scale;
-    int zero_point;
-    
-    QuantParams(float s, int zp) : scale(s), zero_point(zp) {}
-};
-
-int8_t quantize(float value, const QuantParams& params) {
-    int32_t quantized = static_cast<int32_t>(std::round(value / params.scale)) + params.zero_point;
-    if (quantized < kInt8Min) return kInt8Min;
-    if (quantized > kInt8Max) return kInt8Max;
-    return static_cast<int8_t>(quantized);
-}
+namespace {
 
-float dequantize(int8_t value, const QuantParams& params) {
-    return (static_cast<float>(value) - params.zero_point) * params.scale;
-}
+// The library's quantization, so these tests check what the host code runs
+using npu::QuantParams;
+using npu::compute_quant_params;
+using npu::dequantize;
+using npu::kInt8Max;
+using npu::kInt8Min;
+using npu::quantize;
 
-QuantParams compute_quant_params(float min_val, float max_val) {
-    float abs_max = std::max(std::abs(min_val), std::abs(max_val));
-    if (abs_max < 1e-8f) {
-        return QuantParams(1.0f, 0);
-    }
-    float scale = abs_max / kInt8Max;
-    return QuantParams(scale, 0);
-}
+constexpr float kTolerance = 1e-5f;
 
 // ============================================================================
 // Test Cases
@@ -210,6 +190,11 @@ TestResult test_consistency() {
     if (std::abs(dq1 - dq2) > kTolerance) {
         return {"consistency", false, "Dequantization is non-deterministic"};
     }
+
+    // dequantize takes int32 accumulators, well outside the int8 range
+    if (std::abs(dequantize(int32_t{-100000}, params) + 50000.0f) > kTolerance) {
+        return {"consistency", false, "int32 accumulator dequantized wrongly"};
+    }
     
     return {"consistency", true, ""};
 }
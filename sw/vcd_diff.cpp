@@ -0,0 +1,68 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "npu_vcd.hpp"
+
+// Diffs two VCD traces cycle by cycle and reports the first divergent cycle.
+//
+//   vcd_diff <a.vcd> <scope_a> <b.vcd> <scope_b> [--clock=clk] [--align=start]
+//            [--signals=valid_stage1,result_index,...] [--max-cycles=N]
+//
+// Scopes are dot-separated, e.g. npu_core_tb.dut for the RTL and npu_core for
+// a CoreTracer dump. Only signals directly in each scope are compared, by leaf
+// name. Cycle 0 is the first cycle with --align high (empty: the first edge).
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "usage: vcd_diff <a.vcd> <scope_a> <b.vcd> <scope_b> [--clock=clk] [--align=start]"
+                     " [--signals=a,b,...] [--max-cycles=N]\n";
+        return 2;
+    }
+
+    npu::VcdDiffOptions options;
+    for (int i = 5; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg.substr(0, 8) == "--clock=") {
+            options.clock = arg.substr(8);
+        } else if (arg.substr(0, 8) == "--align=") {
+            options.align = arg.substr(8);
+        } else if (arg.substr(0, 10) == "--signals=") {
+            std::string list = arg.substr(10);
+            size_t begin = 0;
+            while (begin <= list.size()) {
+                const size_t comma = list.find(',', begin);
+                const size_t end = (comma == std::string::npos) ? list.size() : comma;
+                if (end > begin) {
+                    options.signals.push_back(list.substr(begin, end - begin));
+                }
+                begin = end + 1;
+            }
+        } else if (arg.substr(0, 13) == "--max-cycles=") {
+            options.max_cycles = std::stoull(arg.substr(13));
+        } else {
+            std::cerr << "vcd_diff: unknown option " << arg << "\n";
+            return 2;
+        }
+    }
+
+    try {
+        const npu::VcdDiff diff = npu::diff_vcd(argv[1], argv[2], argv[3], argv[4], options);
+        std::cout << "Compared " << diff.compared.size() << " signals:";
+        for (const auto& name : diff.compared) {
+            std::cout << " " << name;
+        }
+        std::cout << "\n";
+        if (diff.match) {
+            std::cout << "Traces match for " << diff.cycles << " cycles\n";
+            return 0;
+        }
+        std::cout << "First divergence at cycle " << diff.cycle << " (a: edge at " << diff.time_a
+                  << ", b: edge at " << diff.time_b << "): " << diff.signal << " = " << diff.value_a
+                  << " vs " << diff.value_b << "\n";
+        return 1;
+    } catch (const std::exception& error) {
+        std::cerr << "vcd_diff: " << error.what() << "\n";
+        return 2;
+    }
+}
@@ -0,0 +1,253 @@
+`timescale 1ns/1ps
+
+// AXI4-Stream wrapper testbench: streams several tiles back to back through
+// npu_axis with random TREADY on the result link. Checks every tile against a
+// golden model along with its TLAST/TKEEP framing, and checks that neither skid
+// buffer ever leaves the downstream side idle while it holds data.
+module npu_axis_tb;
+
+    localparam integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE;
+    localparam integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH;
+    localparam integer MAX_K           = 8;
+    localparam integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS;
+    localparam integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS;
+    localparam integer ELEMS_PER_BEAT  = 3; // 16 results -> 6 beats, last one partial
+    localparam integer LANE_WIDTH      = 8 * ((ACC_WIDTH + 7) / 8);
+    localparam integer LANE_BYTES      = LANE_WIDTH / 8;
+    localparam integer IN_WIDTH        = 2 * ARRAY_SIZE * DATA_WIDTH;
+    localparam integer OUT_WIDTH       = ELEMS_PER_BEAT * LANE_WIDTH;
+    localparam integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE;
+    localparam integer OUT_BEATS       = (OUTPUT_COUNT + ELEMS_PER_BEAT - 1) / ELEMS_PER_BEAT;
+    localparam integer NUM_TILES       = 8;
+
+    reg clk;
+    reg rst;
+
+    reg                  s_axis_tvalid;
+    wire                 s_axis_tready;
+    reg  [IN_WIDTH-1:0]  s_axis_tdata;
+    reg                  s_axis_tlast;
+    wire                 m_axis_tvalid;
+    reg                  m_axis_tready;
+    wire [OUT_WIDTH-1:0] m_axis_tdata;
+    wire [OUT_WIDTH/8-1:0] m_axis_tkeep;
+    wire                 m_axis_tlast;
+
+    reg signed [DATA_WIDTH-1:0] matrix_a [0:NUM_TILES-1][0:ARRAY_SIZE-1][0:MAX_K-1];
+    reg signed [DATA_WIDTH-1:0] matrix_b [0:NUM_TILES-1][0:MAX_K-1][0:ARRAY_SIZE-1];
+    integer tile_k [0:NUM_TILES-1];
+
+    // Source state
+    integer src_tile;
+    integer src_beat;
+
+    // Sink state
+    integer sink_tile;
+    integer sink_beat;
+    reg     in_frame;
+    reg signed [ACC_WIDTH-1:0] observed [0:OUTPUT_COUNT-1];
+
+    // Link utilization counters
+    integer in_ready_cycles;
+    integer in_bubbles;
+    integer out_ready_cycles;
+    integer out_bubbles;
+
+    npu_axis #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (MAX_K),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (0),
+        .ELEMS_PER_BEAT (ELEMS_PER_BEAT)
+    ) dut (
+        .clk           (clk),
+        .rst           (rst),
+        .s_axis_tvalid (s_axis_tvalid),
+        .s_axis_tready (s_axis_tready),
+        .s_axis_tdata  (s_axis_tdata),
+        .s_axis_tlast  (s_axis_tlast),
+        .m_axis_tvalid (m_axis_tvalid),
+        .m_axis_tready (m_axis_tready),
+        .m_axis_tdata  (m_axis_tdata),
+        .m_axis_tkeep  (m_axis_tkeep),
+        .m_axis_tlast  (m_axis_tlast)
+    );
+
+    // 100 MHz clock
+    initial begin
+        clk = 1'b0;
+        forever #5 clk = ~clk;
+    end
+
+    task drive_source;
+        integer lane;
+        begin
+            s_axis_tvalid = (src_tile < NUM_TILES);
+            s_axis_tdata  = '0;
+            s_axis_tlast  = 1'b0;
+            if (src_tile < NUM_TILES) begin
+                for (lane = 0; lane < ARRAY_SIZE; lane += 1) begin
+                    s_axis_tdata[lane*DATA_WIDTH +: DATA_WIDTH] = matrix_a[src_tile][lane][src_beat];
+                    s_axis_tdata[(ARRAY_SIZE+lane)*DATA_WIDTH +: DATA_WIDTH] = matrix_b[src_tile][src_beat][lane];
+                end
+                s_axis_tlast = (src_beat == tile_k[src_tile]-1);
+            end
+        end
+    endtask
+
+    task check_tile(input integer tile);
+        integer row, col, k;
+        integer signed sum;
+        begin
+            for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    sum = 0;
+                    for (k = 0; k < tile_k[tile]; k += 1) begin
+                        sum += matrix_a[tile][row][k] * matrix_b[tile][k][col];
+                    end
+                    if (observed[row*ARRAY_SIZE + col] !== sum) begin
+                        $fatal(1, "[TB] tile %0d mismatch at C[%0d][%0d]: observed=%0d expected=%0d",
+                               tile, row, col, observed[row*ARRAY_SIZE + col], sum);
+                    end
+                end
+            end
+            $display("[TB] tile %0d (K=%0d) passed", tile, tile_k[tile]);
+        end
+    endtask
+
+    // Source: TVALID stays high until every beat of every tile has been sent.
+    // Once the first beat is in, the input skid must feed the core on every
+    // cycle its operand FIFO has room.
+    always @(posedge clk) begin
+        if (!rst && src_tile < NUM_TILES && dut.core_in_ready) begin
+            in_ready_cycles += 1;
+            if (!dut.core_in_valid && (src_tile > 0 || src_beat > 0)) begin
+                in_bubbles += 1;
+            end
+        end
+
+        if (!rst && s_axis_tvalid && s_axis_tready) begin
+            if (src_beat == tile_k[src_tile]-1) begin
+                src_beat = 0;
+                src_tile = src_tile + 1;
+            end else begin
+                src_beat = src_beat + 1;
+            end
+        end
+    end
+
+    // Sink: unpack lanes, check framing, compare each tile at TLAST. Between
+    // the first beat of a frame and its TLAST, every cycle with TREADY high
+    // must carry a beat.
+    always @(posedge clk) begin
+        integer lane, elem;
+        if (!rst && in_frame && m_axis_tready) begin
+            out_ready_cycles += 1;
+            if (!m_axis_tvalid) begin
+                out_bubbles += 1;
+            end
+        end
+
+        if (!rst && m_axis_tvalid && m_axis_tready) begin
+            for (lane = 0; lane < ELEMS_PER_BEAT; lane += 1) begin
+                elem = sink_beat*ELEMS_PER_BEAT + lane;
+                if (elem < OUTPUT_COUNT) begin
+                    if (m_axis_tkeep[lane*LANE_BYTES +: LANE_BYTES] !== {LANE_BYTES{1'b1}}) begin
+                        $fatal(1, "[TB] tile %0d beat %0d: TKEEP=%b drops valid lane %0d",
+                               sink_tile, sink_beat, m_axis_tkeep, lane);
+                    end
+                    if (m_axis_tdata[lane*LANE_WIDTH +: LANE_WIDTH] !==
+                        {{(LANE_WIDTH-ACC_WIDTH){m_axis_tdata[lane*LANE_WIDTH+ACC_WIDTH-1]}},
+                         m_axis_tdata[lane*LANE_WIDTH +: ACC_WIDTH]}) begin
+                        $fatal(1, "[TB] tile %0d beat %0d: lane %0d not sign-extended", sink_tile, sink_beat, lane);
+                    end
+                    observed[elem] = m_axis_tdata[lane*LANE_WIDTH +: ACC_WIDTH];
+                end else if (m_axis_tkeep[lane*LANE_BYTES +: LANE_BYTES] !== {LANE_BYTES{1'b0}}) begin
+                    $fatal(1, "[TB] tile %0d beat %0d: TKEEP=%b keeps padding lane %0d",
+                           sink_tile, sink_beat, m_axis_tkeep, lane);
+                end
+            end
+
+            if (m_axis_tlast !== (sink_beat == OUT_BEATS-1)) begin
+                $fatal(1, "[TB] tile %0d: TLAST=%0d on beat %0d of %0d",
+                       sink_tile, m_axis_tlast, sink_beat, OUT_BEATS);
+            end
+
+            if (m_axis_tlast) begin
+                check_tile(sink_tile);
+                sink_tile = sink_tile + 1;
+                sink_beat = 0;
+                in_frame  = 1'b0;
+            end else begin
+                sink_beat = sink_beat + 1;
+                in_frame  = 1'b1;
+            end
+        end
+    end
+
+    always @(negedge clk) begin
+        if (rst) begin
+            m_axis_tready <= 1'b0;
+        end else begin
+            m_axis_tready <= ($urandom_range(0, 3) != 0);
+        end
+        drive_source();
+    end
+
+    task apply_reset;
+        begin
+            rst       <= 1'b1;
+            src_tile  = 0;
+            src_beat  = 0;
+            sink_tile = 0;
+            sink_beat = 0;
+            in_frame  = 1'b0;
+            in_ready_cycles  = 0;
+            in_bubbles       = 0;
+            out_ready_cycles = 0;
+            out_bubbles      = 0;
+            repeat (4) @(negedge clk);
+            rst       <= 1'b0;
+            @(negedge clk);
+        end
+    endtask
+
+    initial begin
+        integer t, i, k, cycles;
+
+        for (t = 0; t < NUM_TILES; t += 1) begin
+            tile_k[t] = (t == 0) ? MAX_K : $urandom_range(1, MAX_K);
+            for (i = 0; i < ARRAY_SIZE; i += 1) begin
+                for (k = 0; k < MAX_K; k += 1) begin
+                    matrix_a[t][i][k] = $urandom;
+                    matrix_b[t][k][i] = $urandom;
+                end
+            end
+        end
+
+        src_tile = 0;
+        src_beat = 0;
+        apply_reset();
+
+        cycles = 0;
+        while (sink_tile < NUM_TILES) begin
+            @(negedge clk);
+            cycles += 1;
+            if (cycles > NUM_TILES * (MAX_K + 4*OUTPUT_COUNT + 64)) begin
+                $fatal(1, "[TB] Timeout: %0d of %0d tiles received", sink_tile, NUM_TILES);
+            end
+        end
+
+        if (in_bubbles != 0 || out_bubbles != 0) begin
+            $fatal(1, "[TB] link bubbles: input %0d of %0d ready cycles, output %0d of %0d ready cycles",
+                   in_bubbles, in_ready_cycles, out_bubbles, out_ready_cycles);
+        end
+        $display("[TB] input link: %0d/%0d ready cycles used, output link: %0d/%0d ready cycles used in frame",
+                 in_ready_cycles - in_bubbles, in_ready_cycles, out_ready_cycles - out_bubbles, out_ready_cycles);
+        $display("[TB] %0d tiles in %0d cycles", NUM_TILES, cycles);
+        $display("[TB] All testcases passed");
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,242 @@
+`timescale 1ns/1ps
+
+// Cluster testbench: NUM_CORES cores share one b_stream broadcast. Checks the
+// (NUM_CORES*ARRAY_SIZE) x ARRAY_SIZE block on c_out_flat and through the
+// round-robin result arbiter under random result_ready, including that no
+// core is granted twice in a row while another core is waiting.
+module npu_cluster_tb;
+
+    localparam integer NUM_CORES       = 3;
+    localparam integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE;
+    localparam integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH;
+    localparam integer MAX_K           = 8;
+    localparam integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS;
+    localparam integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS;
+    localparam integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE;
+    localparam integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1;
+    localparam integer CORE_WIDTH      = (NUM_CORES > 1) ? $clog2(NUM_CORES) : 1;
+    localparam integer ROWS            = NUM_CORES * ARRAY_SIZE;
+
+    reg clk;
+    reg rst;
+    reg start;
+    reg in_valid;
+    reg in_last;
+    reg [NUM_CORES*ARRAY_SIZE*DATA_WIDTH-1:0] a_stream;
+    reg [ARRAY_SIZE*DATA_WIDTH-1:0] b_stream;
+    reg result_ready;
+
+    wire in_ready;
+    wire busy;
+    wire done;
+    wire c_valid;
+    wire [NUM_CORES*OUTPUT_COUNT*ACC_WIDTH-1:0] c_out_flat;
+    wire result_valid;
+    wire [ACC_WIDTH-1:0] result_data;
+    wire [INDEX_WIDTH-1:0] result_index;
+    wire [CORE_WIDTH-1:0] result_core;
+    wire result_last;
+
+    reg signed [DATA_WIDTH-1:0] matrix_a [0:ROWS-1][0:MAX_K-1];
+    reg signed [DATA_WIDTH-1:0] matrix_b [0:MAX_K-1][0:ARRAY_SIZE-1];
+    reg signed [ACC_WIDTH-1:0]  golden   [0:ROWS-1][0:ARRAY_SIZE-1];
+    reg signed [ACC_WIDTH-1:0]  streamed [0:ROWS-1][0:ARRAY_SIZE-1];
+    integer core_words [0:NUM_CORES-1];
+    integer core_lasts [0:NUM_CORES-1];
+
+    npu_cluster #(
+        .NUM_CORES      (NUM_CORES),
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (MAX_K),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (0)
+    ) dut (
+        .clk          (clk),
+        .rst          (rst),
+        .start        (start),
+        .in_valid     (in_valid),
+        .in_ready     (in_ready),
+        .in_last      (in_last),
+        .a_stream     (a_stream),
+        .b_stream     (b_stream),
+        .busy         (busy),
+        .done         (done),
+        .c_valid      (c_valid),
+        .c_out_flat   (c_out_flat),
+        .result_valid (result_valid),
+        .result_data  (result_data),
+        .result_index (result_index),
+        .result_core  (result_core),
+        .result_last  (result_last),
+        .result_ready (result_ready)
+    );
+
+    // 100 MHz clock
+    initial begin
+        clk = 1'b0;
+        forever #5 clk = ~clk;
+    end
+
+    task apply_reset;
+        begin
+            rst          <= 1'b1;
+            start        <= 1'b0;
+            in_valid     <= 1'b0;
+            in_last      <= 1'b0;
+            a_stream     <= '0;
+            b_stream     <= '0;
+            result_ready <= 1'b0;
+            repeat (4) @(negedge clk);
+            rst          <= 1'b0;
+            @(negedge clk);
+        end
+    endtask
+
+    task randomize_operands(input integer k_len);
+        integer row, col, k;
+        integer signed sum;
+        begin
+            for (k = 0; k < MAX_K; k += 1) begin
+                for (row = 0; row < ROWS; row += 1) begin
+                    matrix_a[row][k] = $urandom;
+                end
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    matrix_b[k][col] = $urandom;
+                end
+            end
+            for (row = 0; row < ROWS; row += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    sum = 0;
+                    for (k = 0; k < k_len; k += 1) begin
+                        sum += matrix_a[row][k] * matrix_b[k][col];
+                    end
+                    golden[row][col]   = sum;
+                    streamed[row][col] = 'x;
+                end
+            end
+        end
+    endtask
+
+    // One beat feeds every core: each core's A lanes plus the shared B row
+    task stream_operands(input integer k_len);
+        integer k, row;
+        begin
+            start <= 1'b1;
+            @(negedge clk);
+            start <= 1'b0;
+            for (k = 0; k < k_len; k += 1) begin
+                if (!in_ready) begin
+                    $fatal(1, "[TB] cluster not ready for beat %0d", k);
+                end
+                in_valid <= 1'b1;
+                in_last  <= (k == k_len-1);
+                for (row = 0; row < ROWS; row += 1) begin
+                    a_stream[row*DATA_WIDTH +: DATA_WIDTH] <= matrix_a[row][k];
+                end
+                for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                    b_stream[row*DATA_WIDTH +: DATA_WIDTH] <= matrix_b[k][row];
+                end
+                @(negedge clk);
+            end
+            in_valid <= 1'b0;
+            in_last  <= 1'b0;
+        end
+    endtask
+
+    task collect_stream;
+        integer core, row, col, words, prev_core;
+        reg [NUM_CORES-1:0] others;
+        begin
+            for (core = 0; core < NUM_CORES; core += 1) begin
+                core_words[core] = 0;
+                core_lasts[core] = 0;
+            end
+            words     = 0;
+            prev_core = -1;
+            while (words < NUM_CORES*OUTPUT_COUNT) begin
+                result_ready <= ($urandom_range(0, 2) != 0);
+                @(posedge clk);
+                if (result_valid && result_ready) begin
+                    core = result_core;
+                    if (core >= NUM_CORES || result_index !== core_words[core]) begin
+                        $fatal(1, "[TB] core %0d sent index %0d, expected %0d",
+                               core, result_index, core_words[core]);
+                    end
+                    // Round robin: a core is not granted twice in a row while
+                    // another core has a word waiting
+                    others = dut.core_result_valid & ~({{(NUM_CORES-1){1'b0}}, 1'b1} << core);
+                    if (core == prev_core && others != 0) begin
+                        $fatal(1, "[TB] core %0d granted twice while cores %b were waiting", core, others);
+                    end
+                    row = core*ARRAY_SIZE + result_index / ARRAY_SIZE;
+                    col = result_index % ARRAY_SIZE;
+                    streamed[row][col] = result_data;
+                    core_lasts[core] += result_last;
+                    core_words[core] += 1;
+                    prev_core = core;
+                    words += 1;
+                end
+                @(negedge clk);
+            end
+            result_ready <= 1'b0;
+            for (core = 0; core < NUM_CORES; core += 1) begin
+                if (core_lasts[core] !== 1) begin
+                    $fatal(1, "[TB] core %0d marked %0d words result_last", core, core_lasts[core]);
+                end
+            end
+            wait (!busy);
+            @(negedge clk);
+        end
+    endtask
+
+    task run_job(input integer k_len);
+        integer row, col, cycles;
+        reg signed [ACC_WIDTH-1:0] observed;
+        begin
+            randomize_operands(k_len);
+            stream_operands(k_len);
+
+            cycles = 0;
+            while (!c_valid) begin
+                @(negedge clk);
+                cycles += 1;
+                if (cycles > MAX_K + 16) begin
+                    $fatal(1, "[TB] Timeout waiting for c_valid");
+                end
+            end
+
+            for (row = 0; row < ROWS; row += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    observed = c_out_flat[((row*ARRAY_SIZE)+col)*ACC_WIDTH +: ACC_WIDTH];
+                    if (observed !== golden[row][col]) begin
+                        $fatal(1, "[TB] K=%0d c_out_flat mismatch at C[%0d][%0d]: observed=%0d expected=%0d",
+                               k_len, row, col, observed, golden[row][col]);
+                    end
+                end
+            end
+
+            collect_stream();
+
+            for (row = 0; row < ROWS; row += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    if (streamed[row][col] !== golden[row][col]) begin
+                        $fatal(1, "[TB] K=%0d stream mismatch at C[%0d][%0d]: observed=%0d expected=%0d",
+                               k_len, row, col, streamed[row][col], golden[row][col]);
+                    end
+                end
+            end
+            $display("[TB] %0d-core job (K=%0d) passed", NUM_CORES, k_len);
+        end
+    endtask
+
+    initial begin
+        apply_reset();
+        run_job(MAX_K);
+        run_job(3);
+        run_job(1);
+        $display("[TB] All testcases passed");
+        $finish;
+    end
+
+endmodule
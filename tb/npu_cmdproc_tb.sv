@@ -0,0 +1,243 @@
+`timescale 1ns/1ps
+
+// Command processor testbench: loads operands and a descriptor chain into local
+// memory, rings the doorbell once and checks the written-back results. The
+// last descriptor uses a compressed (zero k-beat skipping) A panel.
+module npu_cmdproc_tb;
+
+    localparam integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE;
+    localparam integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH;
+    localparam integer MAX_K           = 8;
+    localparam integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS;
+    localparam integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS;
+    localparam integer WORD_WIDTH      = 32;
+    localparam integer MEM_WORDS       = 256;
+    localparam integer ADDR_WIDTH      = $clog2(MEM_WORDS);
+    localparam integer RING_ENTRIES    = 8;
+    localparam integer RING_PTR_WIDTH  = $clog2(RING_ENTRIES);
+    localparam integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE;
+    localparam integer NUM_DESC        = 4;
+
+    // Original k indices kept in the sparse A panel (columns 1, 4 and 6 are zero)
+    localparam [MAX_K-1:0] SPARSE_KEEP = 8'b1010_1101;
+
+    localparam integer RING_BASE     = 0;
+    localparam integer A_BASE        = 32;
+    localparam integer SPARSE_A_BASE = 40;  // compressed columns, then the k-index map
+    localparam integer B_BASE        = 64;  // NUM_DESC panels of MAX_K words
+    localparam integer C_BASE        = 128; // NUM_DESC tiles of OUTPUT_COUNT words
+
+    reg clk;
+    reg rst;
+    reg host_we;
+    reg [ADDR_WIDTH-1:0] host_addr;
+    reg [WORD_WIDTH-1:0] host_wdata;
+    wire [WORD_WIDTH-1:0] host_rdata;
+    reg doorbell;
+    reg [RING_PTR_WIDTH-1:0] doorbell_tail;
+    wire [RING_PTR_WIDTH-1:0] ring_head;
+    wire idle;
+    wire irq;
+    wire [31:0] completed_count;
+
+    reg signed [DATA_WIDTH-1:0] matrix_a [0:ARRAY_SIZE-1][0:MAX_K-1];
+    reg signed [DATA_WIDTH-1:0] matrix_b [0:NUM_DESC-1][0:MAX_K-1][0:ARRAY_SIZE-1];
+    integer desc_k    [0:NUM_DESC-1];
+    integer desc_relu [0:NUM_DESC-1];
+    integer desc_sparse [0:NUM_DESC-1];
+    integer irq_count;
+
+    npu_cmdproc #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (MAX_K),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .WORD_WIDTH     (WORD_WIDTH),
+        .MEM_WORDS      (MEM_WORDS),
+        .RING_ENTRIES   (RING_ENTRIES)
+    ) dut (
+        .clk             (clk),
+        .rst             (rst),
+        .host_we         (host_we),
+        .host_addr       (host_addr),
+        .host_wdata      (host_wdata),
+        .host_rdata      (host_rdata),
+        .ring_base       (RING_BASE),
+        .doorbell        (doorbell),
+        .doorbell_tail   (doorbell_tail),
+        .ring_head       (ring_head),
+        .idle            (idle),
+        .irq             (irq),
+        .completed_count (completed_count)
+    );
+
+    // 100 MHz clock
+    initial begin
+        clk = 1'b0;
+        forever #5 clk = ~clk;
+    end
+
+    always @(posedge clk) begin
+        if (rst) begin
+            irq_count <= 0;
+        end else if (irq) begin
+            irq_count <= irq_count + 1;
+        end
+    end
+
+    task apply_reset;
+        begin
+            rst           <= 1'b1;
+            host_we       <= 1'b0;
+            host_addr     <= '0;
+            host_wdata    <= '0;
+            doorbell      <= 1'b0;
+            doorbell_tail <= '0;
+            repeat (4) @(negedge clk);
+            rst           <= 1'b0;
+            @(negedge clk);
+        end
+    endtask
+
+    task host_write(input integer addr, input [WORD_WIDTH-1:0] data);
+        begin
+            host_we    <= 1'b1;
+            host_addr  <= addr;
+            host_wdata <= data;
+            @(negedge clk);
+            host_we    <= 1'b0;
+        end
+    endtask
+
+    task host_read(input integer addr, output [WORD_WIDTH-1:0] data);
+        begin
+            host_addr <= addr;
+            @(negedge clk);
+            data = host_rdata;
+        end
+    endtask
+
+    task load_memory;
+        integer d, k, lane, kept;
+        reg [WORD_WIDTH-1:0] word;
+        begin
+            for (k = 0; k < MAX_K; k += 1) begin
+                word = '0;
+                for (lane = 0; lane < ARRAY_SIZE; lane += 1) begin
+                    word[lane*DATA_WIDTH +: DATA_WIDTH] = matrix_a[lane][k];
+                end
+                host_write(A_BASE + k, word);
+            end
+
+            kept = 0;
+            for (k = 0; k < MAX_K; k += 1) begin
+                if (SPARSE_KEEP[k]) begin
+                    word = '0;
+                    for (lane = 0; lane < ARRAY_SIZE; lane += 1) begin
+                        word[lane*DATA_WIDTH +: DATA_WIDTH] = matrix_a[lane][k];
+                    end
+                    host_write(SPARSE_A_BASE + kept, word);
+                    kept += 1;
+                end
+            end
+            host_write(SPARSE_A_BASE + kept, SPARSE_KEEP);
+
+            for (d = 0; d < NUM_DESC; d += 1) begin
+                for (k = 0; k < MAX_K; k += 1) begin
+                    word = '0;
+                    for (lane = 0; lane < ARRAY_SIZE; lane += 1) begin
+                        word[lane*DATA_WIDTH +: DATA_WIDTH] = matrix_b[d][k][lane];
+                    end
+                    host_write(B_BASE + d*MAX_K + k, word);
+                end
+
+                host_write(RING_BASE + d*4 + 0, desc_sparse[d] ? SPARSE_A_BASE : A_BASE);
+                host_write(RING_BASE + d*4 + 1, B_BASE + d*MAX_K);
+                host_write(RING_BASE + d*4 + 2, C_BASE + d*OUTPUT_COUNT);
+                host_write(RING_BASE + d*4 + 3, (32'd1 << 31) | (desc_sparse[d] << 18) |
+                                                ((d == NUM_DESC-1) << 17) | (desc_relu[d] << 16) | desc_k[d]);
+            end
+        end
+    endtask
+
+    task check_results;
+        integer d, row, col, k;
+        integer signed sum;
+        reg [WORD_WIDTH-1:0] word;
+        begin
+            for (d = 0; d < NUM_DESC; d += 1) begin
+                for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                    for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                        sum = 0;
+                        for (k = 0; k < MAX_K; k += 1) begin
+                            if (desc_sparse[d] ? SPARSE_KEEP[k] : (k < desc_k[d])) begin
+                                sum += matrix_a[row][k] * matrix_b[d][k][col];
+                            end
+                        end
+                        if (desc_relu[d] && sum < 0) begin
+                            sum = 0;
+                        end
+                        host_read(C_BASE + d*OUTPUT_COUNT + row*ARRAY_SIZE + col, word);
+                        if ($signed(word) !== sum) begin
+                            $fatal(1, "[TB] desc %0d mismatch at C[%0d][%0d]: observed=%0d expected=%0d",
+                                   d, row, col, $signed(word), sum);
+                        end
+                    end
+                end
+
+                host_read(RING_BASE + d*4 + 3, word);
+                if (word[31]) begin
+                    $fatal(1, "[TB] desc %0d valid bit not cleared", d);
+                end
+                $display("[TB] descriptor %0d (K=%0d, relu=%0d, sparse=%0d) passed",
+                         d, desc_k[d], desc_relu[d], desc_sparse[d]);
+            end
+        end
+    endtask
+
+    initial begin
+        integer d, k, lane, cycles;
+
+        for (lane = 0; lane < ARRAY_SIZE; lane += 1) begin
+            for (k = 0; k < MAX_K; k += 1) begin
+                matrix_a[lane][k] = $urandom;
+                for (d = 0; d < NUM_DESC; d += 1) begin
+                    matrix_b[d][k][lane] = $urandom;
+                end
+            end
+        end
+        desc_k[0] = MAX_K; desc_relu[0] = 0; desc_sparse[0] = 0;
+        desc_k[1] = 5;     desc_relu[1] = 1; desc_sparse[1] = 0;
+        desc_k[2] = 1;     desc_relu[2] = 0; desc_sparse[2] = 0;
+        desc_k[3] = 5;     desc_relu[3] = 0; desc_sparse[3] = 1; // popcount(SPARSE_KEEP)
+
+        apply_reset();
+        load_memory();
+
+        // One doorbell for the whole chain
+        doorbell      <= 1'b1;
+        doorbell_tail <= NUM_DESC;
+        @(negedge clk);
+        doorbell      <= 1'b0;
+        @(negedge clk);
+
+        cycles = 0;
+        while (!idle) begin
+            @(negedge clk);
+            cycles += 1;
+            if (cycles > NUM_DESC * (MAX_K + 64)) begin
+                $fatal(1, "[TB] Timeout waiting for command processor");
+            end
+        end
+
+        if (completed_count !== NUM_DESC || irq_count !== 1 || ring_head !== NUM_DESC) begin
+            $fatal(1, "[TB] completed=%0d irq=%0d head=%0d", completed_count, irq_count, ring_head);
+        end
+
+        check_results();
+        $display("[TB] %0d descriptors in %0d cycles", NUM_DESC, cycles);
+        $display("[TB] All testcases passed");
+        $finish;
+    end
+
+endmodule
@@ -2,22 +2,28 @@
 
 module npu_core_tb;
 
-    localparam integer ARRAY_SIZE      = 4;
-    localparam integer DATA_WIDTH      = 8;
-    localparam integer EXTRA_ACC_BITS  = 4;
+    localparam integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE;
+    localparam integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH;
+    localparam integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS;
     localparam integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(ARRAY_SIZE) + EXTRA_ACC_BITS;
     localparam integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE;
     localparam integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1;
     localparam integer TOTAL_LATENCY   = (ARRAY_SIZE * 3) - 2;
+    localparam integer HALF_WIDTH      = DATA_WIDTH / 2;
+    localparam integer PAIR_COLS       = 2 * ARRAY_SIZE;
+    localparam integer PAIR_COUNT      = ARRAY_SIZE * PAIR_COLS;
+    localparam integer PAIR_INDEX_WIDTH = $clog2(PAIR_COUNT);
 
     reg clk;
     reg rst;
     reg start;
     reg in_valid;
+    reg in_last;
     reg [ARRAY_SIZE*DATA_WIDTH-1:0] a_stream;
     reg [ARRAY_SIZE*DATA_WIDTH-1:0] b_stream;
     reg result_ready;
 
+    wire in_ready;
     wire busy;
     wire done;
     wire c_valid;
@@ -35,56 +41,229 @@ module npu_core_tb;
     wire [INDEX_WIDTH-1:0] relu_result_index;
     wire relu_result_ready = 1'b1;
 
+    wire pipe_done;
+    wire [OUTPUT_COUNT*ACC_WIDTH-1:0] pipe_c_out_flat;
+    reg  done_q;
+
+    reg signed [DATA_WIDTH-1:0] stage1_a_q [0:ARRAY_SIZE-1];
+    reg signed [DATA_WIDTH-1:0] stage1_b_q [0:ARRAY_SIZE-1];
+    reg                         stage1_hold;
+
+    wire sparse_busy;
+    wire sparse_result_valid;
+    wire [ACC_WIDTH-1:0] sparse_result_data;
+    wire [INDEX_WIDTH-1:0] sparse_result_index;
+    wire sparse_result_last;
+
+    reg  int4_mode;
+    wire int4_busy;
+    wire [OUTPUT_COUNT*ACC_WIDTH-1:0] int4_c_out_flat;
+    wire [OUTPUT_COUNT*ACC_WIDTH-1:0] int4_c_out_hi_flat;
+    wire int4_result_valid;
+    wire [ACC_WIDTH-1:0] int4_result_data;
+    wire [PAIR_INDEX_WIDTH-1:0] int4_result_index;
+
     reg signed [DATA_WIDTH-1:0] matrix_a [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
     reg signed [DATA_WIDTH-1:0] matrix_b [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
     reg signed [ACC_WIDTH-1:0]  golden_raw [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
     reg signed [ACC_WIDTH-1:0]  golden_relu [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
     reg signed [ACC_WIDTH-1:0]  stream_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg signed [HALF_WIDTH-1:0] matrix_w [0:ARRAY_SIZE-1][0:PAIR_COLS-1];
+    reg signed [ACC_WIDTH-1:0]  golden_pair [0:ARRAY_SIZE-1][0:PAIR_COLS-1];
+    reg signed [ACC_WIDTH-1:0]  pair_stream [0:ARRAY_SIZE-1][0:PAIR_COLS-1];
+    integer pair_captured;
+    reg signed [ACC_WIDTH-1:0]  sparse_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    integer sparse_words;
+    integer sparse_lasts;
 
     npu_core #(
         .ARRAY_SIZE     (ARRAY_SIZE),
         .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
         .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
         .ACT_FUNC       (0)
     ) dut (
-        .clk          (clk),
-        .rst          (rst),
-        .start        (start),
-        .in_valid     (in_valid),
-        .a_stream     (a_stream),
-        .b_stream     (b_stream),
-        .busy         (busy),
-        .done         (done),
-        .c_valid      (c_valid),
-        .c_out_flat   (c_out_flat),
-        .result_valid (result_valid),
-        .result_data  (result_data),
-        .result_index (result_index),
-        .result_ready (result_ready)
+        .clk           (clk),
+        .rst           (rst),
+        .start         (start),
+        .int4_mode     (1'b0),
+        .in_valid      (in_valid),
+        .in_ready      (in_ready),
+        .in_last       (in_last),
+        .a_stream      (a_stream),
+        .b_stream      (b_stream),
+        .busy          (busy),
+        .done          (done),
+        .c_valid       (c_valid),
+        .c_out_flat    (c_out_flat),
+        .c_out_hi_flat (),
+        .result_valid  (result_valid),
+        .result_data   (result_data),
+        .result_index  (result_index),
+        .result_last   (),
+        .result_ready  (result_ready)
     );
 
     npu_core #(
         .ARRAY_SIZE     (ARRAY_SIZE),
         .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
         .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
         .ACT_FUNC       (1)
     ) dut_relu (
-        .clk          (clk),
-        .rst          (rst),
-        .start        (start),
-        .in_valid     (in_valid),
-        .a_stream     (a_stream),
-        .b_stream     (b_stream),
-        .busy         (relu_busy),
-        .done         (relu_done),
-        .c_valid      (relu_c_valid),
-        .c_out_flat   (relu_c_out_flat),
-        .result_valid (relu_result_valid),
-        .result_data  (relu_result_data),
-        .result_index (relu_result_index),
-        .result_ready (relu_result_ready)
+        .clk           (clk),
+        .rst           (rst),
+        .start         (start),
+        .int4_mode     (1'b0),
+        .in_valid      (in_valid),
+        .in_ready      (),
+        .in_last       (in_last),
+        .a_stream      (a_stream),
+        .b_stream      (b_stream),
+        .busy          (relu_busy),
+        .done          (relu_done),
+        .c_valid       (relu_c_valid),
+        .c_out_flat    (relu_c_out_flat),
+        .c_out_hi_flat (),
+        .result_valid  (relu_result_valid),
+        .result_data   (relu_result_data),
+        .result_index  (relu_result_index),
+        .result_last   (),
+        .result_ready  (relu_result_ready)
+    );
+
+    // Same core with PE_PIPELINE: identical results, done one cycle later
+    npu_core #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (0),
+        .PE_PIPELINE    (1)
+    ) dut_pipe (
+        .clk           (clk),
+        .rst           (rst),
+        .start         (start),
+        .int4_mode     (1'b0),
+        .in_valid      (in_valid),
+        .in_ready      (),
+        .in_last       (in_last),
+        .a_stream      (a_stream),
+        .b_stream      (b_stream),
+        .busy          (),
+        .done          (pipe_done),
+        .c_valid       (),
+        .c_out_flat    (pipe_c_out_flat),
+        .c_out_hi_flat (),
+        .result_valid  (),
+        .result_data   (),
+        .result_index  (),
+        .result_last   (),
+        .result_ready  (1'b1)
+    );
+
+    always @(posedge clk) begin
+        done_q <= done;
+        if (!rst && (pipe_done !== done_q)) begin
+            $fatal(1, "[TB] PE_PIPELINE core done=%0d, expected the base core's done one cycle later (%0d)",
+                   pipe_done, done_q);
+        end
+    end
+
+    // Enable gating: dut's stage1 operand registers only load behind a valid
+    // stage0 beat, so they must hold across every bubble and drain cycle
+    always @(posedge clk) begin
+        integer lane;
+        for (lane = 0; lane < ARRAY_SIZE; lane += 1) begin
+            if (stage1_hold && (dut.a_stage1[lane] !== stage1_a_q[lane] ||
+                                dut.b_stage1[lane] !== stage1_b_q[lane])) begin
+                $fatal(1, "[TB] stage1 lane %0d changed without a valid stage0 beat", lane);
+            end
+            stage1_a_q[lane] <= dut.a_stage1[lane];
+            stage1_b_q[lane] <= dut.b_stage1[lane];
+        end
+        stage1_hold <= !rst && !dut.valid_stage0;
+    end
+
+    // Sparse ReLU stream: only non-zero results plus the end-of-tile marker,
+    // scattered back into sparse_matrix. Its stream is always accepted.
+    npu_core #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (1),
+        .SPARSE_STREAM  (1)
+    ) dut_sparse (
+        .clk           (clk),
+        .rst           (rst),
+        .start         (start),
+        .int4_mode     (1'b0),
+        .in_valid      (in_valid),
+        .in_ready      (),
+        .in_last       (in_last),
+        .a_stream      (a_stream),
+        .b_stream      (b_stream),
+        .busy          (sparse_busy),
+        .done          (),
+        .c_valid       (),
+        .c_out_flat    (),
+        .c_out_hi_flat (),
+        .result_valid  (sparse_result_valid),
+        .result_data   (sparse_result_data),
+        .result_index  (sparse_result_index),
+        .result_last   (sparse_result_last),
+        .result_ready  (1'b1)
     );
 
+    always @(posedge clk) begin
+        if (sparse_result_valid) begin
+            sparse_matrix[sparse_result_index / ARRAY_SIZE][sparse_result_index % ARRAY_SIZE] <= sparse_result_data;
+            sparse_words <= sparse_words + 1;
+            if (sparse_result_last) begin
+                sparse_lasts <= sparse_lasts + 1;
+            end
+        end
+    end
+
+    // Dual int4 build: runs the same stimulus as dut in int8 mode, and packed
+    // weight pairs when int4_mode is high. Its stream is always accepted.
+    npu_core #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (0),
+        .DUAL_INT4      (1)
+    ) dut_int4 (
+        .clk           (clk),
+        .rst           (rst),
+        .start         (start),
+        .int4_mode     (int4_mode),
+        .in_valid      (in_valid),
+        .in_ready      (),
+        .in_last       (in_last),
+        .a_stream      (a_stream),
+        .b_stream      (b_stream),
+        .busy          (int4_busy),
+        .done          (),
+        .c_valid       (),
+        .c_out_flat    (int4_c_out_flat),
+        .c_out_hi_flat (int4_c_out_hi_flat),
+        .result_valid  (int4_result_valid),
+        .result_data   (int4_result_data),
+        .result_index  (int4_result_index),
+        .result_last   (),
+        .result_ready  (1'b1)
+    );
+
+    always @(posedge clk) begin
+        if (int4_result_valid) begin
+            pair_stream[int4_result_index / PAIR_COLS][int4_result_index % PAIR_COLS] <= int4_result_data;
+            pair_captured <= pair_captured + 1;
+        end
+    end
+
     // 100 MHz clock
     initial begin
         clk = 1'b0;
@@ -96,9 +275,11 @@ module npu_core_tb;
             rst         <= 1'b1;
             start       <= 1'b0;
             in_valid    <= 1'b0;
+            in_last     <= 1'b0;
             a_stream    <= '0;
             b_stream    <= '0;
             result_ready<= 1'b0;
+            int4_mode   <= 1'b0;
             repeat (4) @(negedge clk);
             rst         <= 1'b0;
             @(negedge clk);
@@ -122,26 +303,59 @@ module npu_core_tb;
         end
     endtask
 
-    task stream_operands;
-        integer k, row;
+    // feed_mode 0: start, then one beat per cycle
+    // feed_mode 1: whole tile queued in the operand FIFO before start
+    // feed_mode 2: start, then beats separated by idle cycles
+    integer feed_mode;
+
+    task drive_beat(input integer k);
+        integer row;
         begin
+            if (!in_ready) begin
+                $fatal(1, "[TB] operand FIFO not ready for beat %0d", k);
+            end
+            in_valid <= 1'b1;
+            in_last  <= (k == ARRAY_SIZE-1);
+            for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                a_stream[(row*DATA_WIDTH) +: DATA_WIDTH] <= matrix_a[row][k];
+                b_stream[(row*DATA_WIDTH) +: DATA_WIDTH] <= matrix_b[k][row];
+            end
             @(negedge clk);
-            start    <= 1'b1;
-            in_valid <= 1'b0;
-            a_stream <= '0;
-            b_stream <= '0;
+        end
+    endtask
 
+    task stream_operands;
+        integer k;
+        begin
             @(negedge clk);
-            start <= 1'b0;
-            for (k = 0; k < ARRAY_SIZE; k += 1) begin
-                in_valid <= 1'b1;
-                for (row = 0; row < ARRAY_SIZE; row += 1) begin
-                    a_stream[(row*DATA_WIDTH) +: DATA_WIDTH] <= matrix_a[row][k];
-                    b_stream[(row*DATA_WIDTH) +: DATA_WIDTH] <= matrix_b[k][row];
+            if (feed_mode == 1) begin
+                for (k = 0; k < ARRAY_SIZE; k += 1) begin
+                    drive_beat(k);
                 end
+                in_valid <= 1'b0;
+                in_last  <= 1'b0;
+                start    <= 1'b1;
+                @(negedge clk);
+                start <= 1'b0;
+            end else begin
+                start    <= 1'b1;
+                in_valid <= 1'b0;
+                a_stream <= '0;
+                b_stream <= '0;
+
                 @(negedge clk);
+                start <= 1'b0;
+                for (k = 0; k < ARRAY_SIZE; k += 1) begin
+                    drive_beat(k);
+                    if (feed_mode == 2) begin
+                        in_valid <= 1'b0;
+                        in_last  <= 1'b0;
+                        @(negedge clk);
+                    end
+                end
             end
             in_valid <= 1'b0;
+            in_last  <= 1'b0;
             a_stream <= '0;
             b_stream <= '0;
         end
@@ -198,13 +412,38 @@ module npu_core_tb;
     task check_results(input [8*32-1:0] label);
         integer row;
         integer col;
+        integer nonzero;
         reg signed [ACC_WIDTH-1:0] observed;
         reg signed [ACC_WIDTH-1:0] relu_observed;
         begin
             compute_golden();
+            for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    sparse_matrix[row][col] = '0;
+                end
+            end
+            sparse_words = 0;
+            sparse_lasts = 0;
+
             stream_operands();
             wait_for_done();
             collect_stream();
+            wait (!sparse_busy);
+            @(posedge clk);
+
+            // Sparse stream: non-zero words, plus C[N-1][N-1] as the marker
+            nonzero = (golden_relu[ARRAY_SIZE-1][ARRAY_SIZE-1] == 0) ? 1 : 0;
+            for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    if (golden_relu[row][col] != 0) begin
+                        nonzero += 1;
+                    end
+                end
+            end
+            if (sparse_words !== nonzero || sparse_lasts !== 1) begin
+                $fatal(1, "[TB] %s sparse stream sent %0d words (%0d marked last), expected %0d (1)",
+                       label, sparse_words, sparse_lasts, nonzero);
+            end
 
             for (row = 0; row < ARRAY_SIZE; row += 1) begin
                 for (col = 0; col < ARRAY_SIZE; col += 1) begin
@@ -227,6 +466,89 @@ module npu_core_tb;
                                "[TB] %s mismatch (ReLU) at C[%0d][%0d]: observed=%0d expected=%0d",
                                label, row, col, relu_observed, golden_relu[row][col]);
                     end
+
+                    if (sparse_matrix[row][col] !== golden_relu[row][col]) begin
+                        $fatal(1,
+                               "[TB] %s mismatch (sparse stream) at C[%0d][%0d]: observed=%0d expected=%0d",
+                               label, row, col, sparse_matrix[row][col], golden_relu[row][col]);
+                    end
+
+                    observed = pipe_c_out_flat[((row*ARRAY_SIZE)+col)*ACC_WIDTH +: ACC_WIDTH];
+                    if (observed !== golden_raw[row][col]) begin
+                        $fatal(1,
+                               "[TB] %s mismatch (PE_PIPELINE) at C[%0d][%0d]: observed=%0d expected=%0d",
+                               label, row, col, observed, golden_raw[row][col]);
+                    end
+
+                    observed = int4_c_out_flat[((row*ARRAY_SIZE)+col)*ACC_WIDTH +: ACC_WIDTH];
+                    if (observed !== golden_raw[row][col]) begin
+                        $fatal(1,
+                               "[TB] %s mismatch (dual int4 build, int8 mode) at C[%0d][%0d]: observed=%0d expected=%0d",
+                               label, row, col, observed, golden_raw[row][col]);
+                    end
+                end
+            end
+
+            $display("[TB] %s passed", label);
+        end
+    endtask
+
+    // int4 mode: b_stream lane col packs weights for output columns 2*col
+    // (low half) and 2*col+1 (high half); the tile is ARRAY_SIZE x PAIR_COLS
+    task check_int4_results(input [8*32-1:0] label);
+        integer row;
+        integer col;
+        integer k;
+        integer signed sum;
+        reg signed [ACC_WIDTH-1:0] observed;
+        begin
+            for (k = 0; k < ARRAY_SIZE; k += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    matrix_b[k][col] = {matrix_w[k][(2*col)+1], matrix_w[k][2*col]};
+                end
+            end
+            for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                for (col = 0; col < PAIR_COLS; col += 1) begin
+                    sum = 0;
+                    for (k = 0; k < ARRAY_SIZE; k += 1) begin
+                        sum += matrix_a[row][k] * matrix_w[k][col];
+                    end
+                    golden_pair[row][col] = sum;
+                    pair_stream[row][col] = '0;
+                end
+            end
+
+            pair_captured = 0;
+            int4_mode <= 1'b1;
+            stream_operands();
+            wait_for_done();
+            collect_stream();
+            wait (!int4_busy);
+            @(posedge clk);
+            int4_mode <= 1'b0;
+
+            if (pair_captured !== PAIR_COUNT) begin
+                $fatal(1, "[TB] %s streamed %0d words, expected %0d", label, pair_captured, PAIR_COUNT);
+            end
+
+            for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                for (col = 0; col < PAIR_COLS; col += 1) begin
+                    if (col % 2 == 0) begin
+                        observed = int4_c_out_flat[((row*ARRAY_SIZE)+(col/2))*ACC_WIDTH +: ACC_WIDTH];
+                    end else begin
+                        observed = int4_c_out_hi_flat[((row*ARRAY_SIZE)+(col/2))*ACC_WIDTH +: ACC_WIDTH];
+                    end
+                    if (observed !== golden_pair[row][col]) begin
+                        $fatal(1,
+                               "[TB] %s mismatch (flat) at C[%0d][%0d]: observed=%0d expected=%0d",
+                               label, row, col, observed, golden_pair[row][col]);
+                    end
+
+                    if (pair_stream[row][col] !== golden_pair[row][col]) begin
+                        $fatal(1,
+                               "[TB] %s mismatch (stream) at C[%0d][%0d]: observed=%0d expected=%0d",
+                               label, row, col, pair_stream[row][col], golden_pair[row][col]);
+                    end
                 end
             end
 
@@ -235,6 +557,9 @@ module npu_core_tb;
     endtask
 
     initial begin
+        integer j, k;
+
+        feed_mode = 0;
         apply_reset();
 
         // Test 1: Identity * Random (checks raw math + ReLU no-op on positives)
@@ -273,6 +598,33 @@ module npu_core_tb;
         matrix_b[3][0] = 8'sd0; matrix_b[3][1] = 8'sd0; matrix_b[3][2] = 8'sd0; matrix_b[3][3] = 8'sd0;
         check_results("zero_case");
 
+        // Test 4: Tile queued ahead of start through the operand FIFO
+        matrix_a[0][0] = 8'sd3;  matrix_a[0][1] = -8'sd2; matrix_a[0][2] = 8'sd1;  matrix_a[0][3] = 8'sd0;
+        matrix_a[1][0] = 8'sd1;  matrix_a[1][1] = 8'sd4;  matrix_a[1][2] = -8'sd1; matrix_a[1][3] = 8'sd2;
+        matrix_a[2][0] = -8'sd5; matrix_a[2][1] = 8'sd0;  matrix_a[2][2] = 8'sd2;  matrix_a[2][3] = 8'sd1;
+        matrix_a[3][0] = 8'sd2;  matrix_a[3][1] = 8'sd1;  matrix_a[3][2] = 8'sd0;  matrix_a[3][3] = -8'sd3;
+
+        matrix_b[0][0] = 8'sd1;  matrix_b[0][1] = 8'sd0;  matrix_b[0][2] = -8'sd2; matrix_b[0][3] = 8'sd3;
+        matrix_b[1][0] = 8'sd2;  matrix_b[1][1] = 8'sd1;  matrix_b[1][2] = 8'sd0;  matrix_b[1][3] = -8'sd1;
+        matrix_b[2][0] = -8'sd1; matrix_b[2][1] = 8'sd3;  matrix_b[2][2] = 8'sd1;  matrix_b[2][3] = 8'sd0;
+        matrix_b[3][0] = 8'sd0;  matrix_b[3][1] = -8'sd2; matrix_b[3][2] = 8'sd4;  matrix_b[3][3] = 8'sd1;
+        feed_mode = 1;
+        check_results("fifo_preloaded");
+
+        // Test 5: Same operands with bubbles between beats
+        feed_mode = 2;
+        check_results("fifo_bursty");
+        feed_mode = 0;
+
+        // Test 6: Dual int4 mode, including the int8/int4 extremes
+        for (k = 0; k < ARRAY_SIZE; k += 1) begin
+            for (j = 0; j < PAIR_COLS; j += 1) begin
+                matrix_w[k][j] = ((k * 5) + (j * 3)) % 16 - 8;
+            end
+        end
+        matrix_a[0][0] = 8'h80; matrix_a[0][1] = 8'h80; matrix_a[0][2] = 8'h80; matrix_a[0][3] = 8'h80;
+        check_int4_results("int4_pairs");
+
         $display("[TB] All testcases passed");
         $finish;
     end
@@ -0,0 +1,167 @@
+`timescale 1ns/1ps
+
+// Co-simulation testbench: npu_core driven live by a C++ host through the
+// npu_cosim VPI module (sw/npu_cosim_vpi.cpp). There are no vectors of its
+// own. Jobs arrive over shared memory from a CosimHost (e.g. the tiler in
+// sw/npu_cosim_host.cpp) and are fed as operand beats whenever the FIFO has
+// room. Jobs start as soon as the core is idle, and every result word goes
+// straight back to the host, which checks it. The channel name comes from
+// +npu_cosim=<name> (default npu_cosim). The run ends once the host closes
+// the channel and the core has drained.
+module npu_cosim_tb #(
+    parameter integer MAX_K         = npu_config_pkg::NPU_MAX_K,
+    parameter integer SPARSE_STREAM = 0
+);
+
+    localparam integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE;
+    localparam integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH;
+    localparam integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS;
+    localparam integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(MAX_K) + EXTRA_ACC_BITS;
+    localparam integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE;
+    localparam integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1;
+
+    reg clk;
+    reg rst;
+    reg start;
+    reg in_valid;
+    reg in_last;
+    reg [ARRAY_SIZE*DATA_WIDTH-1:0] a_stream;
+    reg [ARRAY_SIZE*DATA_WIDTH-1:0] b_stream;
+
+    wire in_ready;
+    wire busy;
+    wire done;
+    wire result_valid;
+    wire [ACC_WIDTH-1:0] result_data;
+    wire [INDEX_WIDTH-1:0] result_index;
+    wire result_last;
+
+    reg [8*64-1:0] channel;
+    integer        opened;
+    integer        cycle;
+    integer        jobs;       // job headers taken from the host
+    integer        started;    // jobs the core has accepted
+    integer        words;
+    integer        beats_left; // beats of the current job not yet presented
+    integer        k_len;
+    reg            host_done;
+    reg            beat_taken; // in_valid && in_ready at the last rising edge
+
+    npu_core #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (MAX_K),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (0),
+        .SPARSE_STREAM  (SPARSE_STREAM)
+    ) dut (
+        .clk           (clk),
+        .rst           (rst),
+        .start         (start),
+        .int4_mode     (1'b0),
+        .in_valid      (in_valid),
+        .in_ready      (in_ready),
+        .in_last       (in_last),
+        .a_stream      (a_stream),
+        .b_stream      (b_stream),
+        .busy          (busy),
+        .done          (done),
+        .c_valid       (),
+        .c_out_flat    (),
+        .c_out_hi_flat (),
+        .result_valid  (result_valid),
+        .result_data   (result_data),
+        .result_index  (result_index),
+        .result_last   (result_last),
+        .result_ready  (1'b1)
+    );
+
+    // 100 MHz clock
+    initial begin
+        clk = 1'b0;
+        forever #5 clk = ~clk;
+    end
+
+    // Host side: a new beat is fetched once the previous one was accepted, and
+    // a job header only once the current job's beats are all queued
+    always @(negedge clk) begin
+        if (rst) begin
+            start      <= 1'b0;
+            in_valid   <= 1'b0;
+            in_last    <= 1'b0;
+            a_stream   <= '0;
+            b_stream   <= '0;
+            jobs       = 0;
+            beats_left = 0;
+            host_done  = 1'b0;
+        end else begin
+            start <= (started < jobs) && !busy && !done;
+
+            if (!in_valid || beat_taken) begin
+                in_valid <= 1'b0;
+                in_last  <= 1'b0;
+                if (beats_left == 0 && !host_done) begin
+                    $npu_cosim_poll(k_len);
+                    if (k_len < 0) begin
+                        host_done = 1'b1;
+                    end else if (k_len > MAX_K) begin
+                        $fatal(1, "[TB] Job %0d has K=%0d, MAX_K is %0d", jobs, k_len, MAX_K);
+                    end else if (k_len > 0) begin
+                        beats_left = k_len;
+                        jobs       = jobs + 1;
+                    end
+                end
+                if (beats_left > 0) begin
+                    $npu_cosim_beat(a_stream, b_stream);
+                    in_valid   <= 1'b1;
+                    in_last    <= (beats_left == 1);
+                    beats_left = beats_left - 1;
+                end
+            end
+        end
+    end
+
+    always @(posedge clk) begin
+        if (rst) begin
+            cycle      <= 0;
+            started    <= 0;
+            words      <= 0;
+            beat_taken <= 1'b0;
+        end else begin
+            cycle      <= cycle + 1;
+            beat_taken <= in_valid && in_ready;
+            if (dut.start_accept) begin
+                started <= started + 1;
+            end
+            if (result_valid) begin
+                $npu_cosim_result(result_index, result_data, result_last);
+                words <= words + 1;
+            end
+        end
+    end
+
+    initial begin
+        if (!$value$plusargs("npu_cosim=%s", channel)) begin
+            channel = "npu_cosim";
+        end
+        $npu_cosim_open(channel, ARRAY_SIZE, DATA_WIDTH, MAX_K, ACC_WIDTH, SPARSE_STREAM, opened);
+        if (opened == 0) begin
+            $fatal(1, "[TB] Could not attach to host channel %0s", channel);
+        end
+        $display("[TB] Attached to host channel %0s", channel);
+
+        rst <= 1'b1;
+        repeat (4) @(negedge clk);
+        rst <= 1'b0;
+
+        // Drained: no beats queued or in flight, every job started and finished
+        @(negedge clk);
+        while (!host_done || beats_left != 0 || in_valid || started != jobs || start || busy || done) begin
+            @(negedge clk);
+        end
+        $display("[TB] Host closed the channel: %0d jobs, %0d result words in %0d cycles", jobs, words, cycle);
+        $display("[TB] All testcases passed");
+        $finish;
+    end
+
+endmodule
@@ -3,9 +3,9 @@
 // Integrated testbench: Tests quantized data flow through RTL
 module npu_integrated_tb;
 
-    localparam integer ARRAY_SIZE      = 4;
-    localparam integer DATA_WIDTH      = 8;
-    localparam integer EXTRA_ACC_BITS  = 4;
+    localparam integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE;
+    localparam integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH;
+    localparam integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS;
     localparam integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(ARRAY_SIZE) + EXTRA_ACC_BITS;
     localparam integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE;
     localparam integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1;
@@ -18,6 +18,7 @@ module npu_integrated_tb;
     reg [ARRAY_SIZE*DATA_WIDTH-1:0] b_stream;
     reg result_ready;
 
+    wire in_ready;
     wire busy;
     wire done;
     wire c_valid;
@@ -33,23 +34,29 @@ module npu_integrated_tb;
     npu_core #(
         .ARRAY_SIZE     (ARRAY_SIZE),
         .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
         .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
         .ACT_FUNC       (0)
     ) dut (
-        .clk          (clk),
-        .rst          (rst),
-        .start        (start),
-        .in_valid     (in_valid),
-        .a_stream     (a_stream),
-        .b_stream     (b_stream),
-        .busy         (busy),
-        .done         (done),
-        .c_valid      (c_valid),
-        .c_out_flat   (c_out_flat),
-        .result_valid (result_valid),
-        .result_data  (result_data),
-        .result_index (result_index),
-        .result_ready (result_ready)
+        .clk           (clk),
+        .rst           (rst),
+        .start         (start),
+        .int4_mode     (1'b0),
+        .in_valid      (in_valid),
+        .in_ready      (in_ready),
+        .in_last       (1'b0),
+        .a_stream      (a_stream),
+        .b_stream      (b_stream),
+        .busy          (busy),
+        .done          (done),
+        .c_valid       (c_valid),
+        .c_out_flat    (c_out_flat),
+        .c_out_hi_flat (),
+        .result_valid  (result_valid),
+        .result_data   (result_data),
+        .result_index  (result_index),
+        .result_last   (),
+        .result_ready  (result_ready)
     );
 
     // 100 MHz clock
@@ -0,0 +1,362 @@
+`timescale 1ns/1ps
+
+// Systolic core testbench: checks npu_systolic against a golden model and
+// against npu_core driven with the same operand stream
+module npu_systolic_tb;
+
+    localparam integer ARRAY_SIZE      = npu_config_pkg::NPU_ARRAY_SIZE;
+    localparam integer DATA_WIDTH      = npu_config_pkg::NPU_DATA_WIDTH;
+    localparam integer EXTRA_ACC_BITS  = npu_config_pkg::NPU_EXTRA_ACC_BITS;
+    localparam integer ACC_WIDTH       = (2*DATA_WIDTH) + $clog2(ARRAY_SIZE) + EXTRA_ACC_BITS;
+    localparam integer OUTPUT_COUNT    = ARRAY_SIZE * ARRAY_SIZE;
+    localparam integer INDEX_WIDTH     = (OUTPUT_COUNT > 1) ? $clog2(OUTPUT_COUNT) : 1;
+    localparam integer SKEW_LATENCY    = 2 * (ARRAY_SIZE - 1);
+    localparam integer TOTAL_LATENCY   = (ARRAY_SIZE * 3) - 2 + SKEW_LATENCY;
+    localparam integer RANDOM_TESTS    = 20;
+
+    reg clk;
+    reg rst;
+    reg start;
+    reg in_valid;
+    reg [ARRAY_SIZE*DATA_WIDTH-1:0] a_stream;
+    reg [ARRAY_SIZE*DATA_WIDTH-1:0] b_stream;
+    reg result_ready;
+
+    wire in_ready;
+    wire busy;
+    wire done;
+    wire c_valid;
+    wire [OUTPUT_COUNT*ACC_WIDTH-1:0] c_out_flat;
+    wire result_valid;
+    wire [ACC_WIDTH-1:0] result_data;
+    wire [INDEX_WIDTH-1:0] result_index;
+
+    wire ref_busy;
+    wire ref_done;
+    wire ref_c_valid;
+    wire [OUTPUT_COUNT*ACC_WIDTH-1:0] ref_c_out_flat;
+    wire ref_result_valid;
+    wire [ACC_WIDTH-1:0] ref_result_data;
+    wire [INDEX_WIDTH-1:0] ref_result_index;
+    wire ref_result_ready = 1'b1;
+
+    wire pipe_done;
+    wire [OUTPUT_COUNT*ACC_WIDTH-1:0] pipe_c_out_flat;
+    reg  done_q;
+
+    reg signed [DATA_WIDTH-1:0] matrix_a [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg signed [DATA_WIDTH-1:0] matrix_b [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg signed [ACC_WIDTH-1:0]  golden [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg signed [ACC_WIDTH-1:0]  stream_matrix [0:ARRAY_SIZE-1][0:ARRAY_SIZE-1];
+    reg [OUTPUT_COUNT*ACC_WIDTH-1:0] ref_snapshot;
+
+    integer done_cycle;
+    integer ref_done_cycle;
+    integer cycle;
+
+    npu_systolic #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (0)
+    ) dut (
+        .clk          (clk),
+        .rst          (rst),
+        .start        (start),
+        .in_valid     (in_valid),
+        .in_ready     (in_ready),
+        .in_last      (1'b0),
+        .a_stream     (a_stream),
+        .b_stream     (b_stream),
+        .busy         (busy),
+        .done         (done),
+        .c_valid      (c_valid),
+        .c_out_flat   (c_out_flat),
+        .result_valid (result_valid),
+        .result_data  (result_data),
+        .result_index (result_index),
+        .result_last  (),
+        .result_ready (result_ready)
+    );
+
+    npu_core #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (0)
+    ) ref_core (
+        .clk           (clk),
+        .rst           (rst),
+        .start         (start),
+        .int4_mode     (1'b0),
+        .in_valid      (in_valid),
+        .in_ready      (),
+        .in_last       (1'b0),
+        .a_stream      (a_stream),
+        .b_stream      (b_stream),
+        .busy          (ref_busy),
+        .done          (ref_done),
+        .c_valid       (ref_c_valid),
+        .c_out_flat    (ref_c_out_flat),
+        .c_out_hi_flat (),
+        .result_valid  (ref_result_valid),
+        .result_data   (ref_result_data),
+        .result_index  (ref_result_index),
+        .result_last   (),
+        .result_ready  (ref_result_ready)
+    );
+
+    // Same core with PE_PIPELINE: identical results, done one cycle later
+    npu_systolic #(
+        .ARRAY_SIZE     (ARRAY_SIZE),
+        .DATA_WIDTH     (DATA_WIDTH),
+        .MAX_K          (ARRAY_SIZE),
+        .EXTRA_ACC_BITS (EXTRA_ACC_BITS),
+        .ACT_FUNC       (0),
+        .PE_PIPELINE    (1)
+    ) dut_pipe (
+        .clk          (clk),
+        .rst          (rst),
+        .start        (start),
+        .in_valid     (in_valid),
+        .in_ready     (),
+        .in_last      (1'b0),
+        .a_stream     (a_stream),
+        .b_stream     (b_stream),
+        .busy         (),
+        .done         (pipe_done),
+        .c_valid      (),
+        .c_out_flat   (pipe_c_out_flat),
+        .result_valid (),
+        .result_data  (),
+        .result_index (),
+        .result_last  (),
+        .result_ready (1'b1)
+    );
+
+    always @(posedge clk) begin
+        done_q <= done;
+        if (!rst && (pipe_done !== done_q)) begin
+            $fatal(1, "[TB] PE_PIPELINE core done=%0d, expected the base core's done one cycle later (%0d)",
+                   pipe_done, done_q);
+        end
+    end
+
+    // 100 MHz clock
+    initial begin
+        clk = 1'b0;
+        forever #5 clk = ~clk;
+    end
+
+    initial cycle = 0;
+    always @(posedge clk) cycle <= cycle + 1;
+
+    // Record when each core finishes so the latency difference can be checked
+    always @(posedge clk) begin
+        if (c_valid) done_cycle <= cycle;
+        if (ref_c_valid) begin
+            ref_done_cycle <= cycle;
+            ref_snapshot   <= ref_c_out_flat;
+        end
+    end
+
+    task apply_reset;
+        begin
+            rst         <= 1'b1;
+            start       <= 1'b0;
+            in_valid    <= 1'b0;
+            a_stream    <= '0;
+            b_stream    <= '0;
+            result_ready<= 1'b0;
+            repeat (4) @(negedge clk);
+            rst         <= 1'b0;
+            @(negedge clk);
+        end
+    endtask
+
+    task compute_golden;
+        integer i, j, k;
+        integer signed sum;
+        begin
+            for (i = 0; i < ARRAY_SIZE; i += 1) begin
+                for (j = 0; j < ARRAY_SIZE; j += 1) begin
+                    sum = 0;
+                    for (k = 0; k < ARRAY_SIZE; k += 1) begin
+                        sum += matrix_a[i][k] * matrix_b[k][j];
+                    end
+                    golden[i][j] = sum;
+                end
+            end
+        end
+    endtask
+
+    task randomize_operands;
+        integer i, j;
+        begin
+            for (i = 0; i < ARRAY_SIZE; i += 1) begin
+                for (j = 0; j < ARRAY_SIZE; j += 1) begin
+                    matrix_a[i][j] = $urandom;
+                    matrix_b[i][j] = $urandom;
+                end
+            end
+        end
+    endtask
+
+    task stream_operands;
+        integer k, row;
+        begin
+            @(negedge clk);
+            start    <= 1'b1;
+            in_valid <= 1'b0;
+            a_stream <= '0;
+            b_stream <= '0;
+
+            @(negedge clk);
+            start <= 1'b0;
+            for (k = 0; k < ARRAY_SIZE; k += 1) begin
+                in_valid <= 1'b1;
+                for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                    a_stream[(row*DATA_WIDTH) +: DATA_WIDTH] <= matrix_a[row][k];
+                    b_stream[(row*DATA_WIDTH) +: DATA_WIDTH] <= matrix_b[k][row];
+                end
+                @(negedge clk);
+            end
+            in_valid <= 1'b0;
+            a_stream <= '0;
+            b_stream <= '0;
+        end
+    endtask
+
+    task wait_for_done;
+        integer cycles_waited;
+        begin
+            cycles_waited = 0;
+            while (!c_valid) begin
+                @(posedge clk);
+                cycles_waited += 1;
+                if (cycles_waited > (TOTAL_LATENCY + OUTPUT_COUNT + 10)) begin
+                    $fatal(1, "[TB] Timeout waiting for c_valid");
+                end
+            end
+            @(posedge clk);
+        end
+    endtask
+
+    task collect_stream;
+        integer captured;
+        integer row;
+        integer col;
+        begin
+            captured = 0;
+            result_ready <= 1'b1;
+            while (captured < OUTPUT_COUNT) begin
+                @(posedge clk);
+                if (result_valid && result_ready) begin
+                    if (result_index !== captured[INDEX_WIDTH-1:0]) begin
+                        $fatal(1, "[TB] stream index mismatch: observed=%0d expected=%0d",
+                               result_index, captured);
+                    end
+                    row = captured / ARRAY_SIZE;
+                    col = captured % ARRAY_SIZE;
+                    stream_matrix[row][col] = result_data;
+                    captured += 1;
+                end
+            end
+            result_ready <= 1'b0;
+
+            wait (!busy && !ref_busy);
+            @(posedge clk);
+        end
+    endtask
+
+    task check_results(input [8*32-1:0] label);
+        integer row;
+        integer col;
+        reg signed [ACC_WIDTH-1:0] observed;
+        reg signed [ACC_WIDTH-1:0] ref_observed;
+        begin
+            compute_golden();
+            stream_operands();
+            wait_for_done();
+            @(negedge clk);
+
+            if ((done_cycle - ref_done_cycle) != SKEW_LATENCY) begin
+                $fatal(1, "[TB] %s latency mismatch: systolic finished %0d cycles after npu_core, expected %0d",
+                       label, done_cycle - ref_done_cycle, SKEW_LATENCY);
+            end
+
+            for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    observed     = c_out_flat[((row*ARRAY_SIZE)+col)*ACC_WIDTH +: ACC_WIDTH];
+                    ref_observed = ref_snapshot[((row*ARRAY_SIZE)+col)*ACC_WIDTH +: ACC_WIDTH];
+                    if (observed !== golden[row][col]) begin
+                        $fatal(1,
+                               "[TB] %s mismatch (flat) at C[%0d][%0d]: observed=%0d expected=%0d",
+                               label, row, col, observed, golden[row][col]);
+                    end
+                    if (observed !== ref_observed) begin
+                        $fatal(1,
+                               "[TB] %s mismatch vs npu_core at C[%0d][%0d]: systolic=%0d broadcast=%0d",
+                               label, row, col, observed, ref_observed);
+                    end
+                    observed = pipe_c_out_flat[((row*ARRAY_SIZE)+col)*ACC_WIDTH +: ACC_WIDTH];
+                    if (observed !== golden[row][col]) begin
+                        $fatal(1,
+                               "[TB] %s mismatch (PE_PIPELINE) at C[%0d][%0d]: observed=%0d expected=%0d",
+                               label, row, col, observed, golden[row][col]);
+                    end
+                end
+            end
+
+            collect_stream();
+            for (row = 0; row < ARRAY_SIZE; row += 1) begin
+                for (col = 0; col < ARRAY_SIZE; col += 1) begin
+                    if (stream_matrix[row][col] !== golden[row][col]) begin
+                        $fatal(1,
+                               "[TB] %s mismatch (stream) at C[%0d][%0d]: observed=%0d expected=%0d",
+                               label, row, col, stream_matrix[row][col], golden[row][col]);
+                    end
+                end
+            end
+
+            $display("[TB] %s passed", label);
+        end
+    endtask
+
+    initial begin
+        integer t;
+        integer i, j;
+
+        apply_reset();
+
+        // Test 1: Skewed identity exposes any row/column misalignment in the forwarding chain
+        for (i = 0; i < ARRAY_SIZE; i += 1) begin
+            for (j = 0; j < ARRAY_SIZE; j += 1) begin
+                matrix_a[i][j] = (i == j) ? 8'sd1 : 8'sd0;
+                matrix_b[i][j] = (i * ARRAY_SIZE) + j - 5;
+            end
+        end
+        check_results("identity_passthrough");
+
+        // Test 2: Extreme operands exercise the full accumulator range
+        for (i = 0; i < ARRAY_SIZE; i += 1) begin
+            for (j = 0; j < ARRAY_SIZE; j += 1) begin
+                matrix_a[i][j] = 8'h80;
+                matrix_b[i][j] = ((i + j) % 2) ? 8'h7f : 8'h80;
+            end
+        end
+        check_results("extreme_values");
+
+        // Test 3+: Random operands
+        for (t = 0; t < RANDOM_TESTS; t += 1) begin
+            randomize_operands();
+            check_results("random");
+        end
+
+        $display("[TB] All testcases passed");
+        $finish;
+    end
+
+endmodule